@@ -0,0 +1,117 @@
+#include "analysiscache.h"
+#include <cmath>
+
+static constexpr quint32 FILE_MAGIC = 0x445a414e;  // "DZAN"
+
+static QByteArray quantizeUnsigned(const QVector<float>& values)
+{
+    QByteArray bytes(values.size(), Qt::Uninitialized);
+    for (int i = 0; i < values.size(); ++i)
+        bytes[i] = static_cast<char>(static_cast<quint8>(std::lround(qBound(0.0f, values[i], 1.0f) * 255.0f)));
+    return bytes;
+}
+
+static QByteArray quantizeSigned(const QVector<float>& values)
+{
+    QByteArray bytes(values.size(), Qt::Uninitialized);
+    for (int i = 0; i < values.size(); ++i)
+        bytes[i] = static_cast<char>(static_cast<qint8>(std::lround(qBound(-1.0f, values[i], 1.0f) * 127.0f)));
+    return bytes;
+}
+
+static QVector<float> expandUnsigned(const QByteArray& bytes)
+{
+    QVector<float> values(bytes.size());
+    for (int i = 0; i < bytes.size(); ++i)
+        values[i] = static_cast<quint8>(bytes[i]) / 255.0f;
+    return values;
+}
+
+static QVector<float> expandSigned(const QByteArray& bytes)
+{
+    QVector<float> values(bytes.size());
+    for (int i = 0; i < bytes.size(); ++i)
+        values[i] = static_cast<qint8>(bytes[i]) / 127.0f;
+    return values;
+}
+
+AnalysisCache::AnalysisCache(int memoryEntries)
+    : m_store(QStringLiteral("analysis"), QStringLiteral(".wfa"), FILE_MAGIC, ALGORITHM_VERSION, memoryEntries)
+{
+}
+
+QString AnalysisCache::key(const QString& trackId, const QString& format)
+{
+    return trackId + QLatin1Char('|') + format;
+}
+
+// ── Memory ──────────────────────────────────────────────────────────────
+
+bool AnalysisCache::find(const QString& trackId, const QString& format, TrackAnalysis* out)
+{
+    const QString cacheKey = key(trackId, format);
+    TrackAnalysis analysis;
+    if (!m_store.findInMemory(cacheKey, &analysis)) {
+        m_store.readFromDisk(cacheKey, &analysis);
+        m_store.remember(cacheKey, analysis);  // Invalid = known miss
+    }
+    if (!analysis.isValid())
+        return false;
+    if (out)
+        *out = analysis;
+    return true;
+}
+
+void AnalysisCache::insert(const QString& trackId, const QString& format, const TrackAnalysis& analysis)
+{
+    m_store.remember(key(trackId, format), analysis);
+}
+
+// ── Disk ────────────────────────────────────────────────────────────────
+
+bool AnalysisCache::readFromDisk(const QString& trackId, const QString& format, TrackAnalysis* out) const
+{
+    return m_store.readFromDisk(key(trackId, format), out);
+}
+
+void AnalysisCache::writeToDisk(const QString& trackId, const QString& format, const TrackAnalysis& analysis) const
+{
+    if (!analysis.complete || !analysis.isValid())
+        return;
+    m_store.writeToDisk(key(trackId, format), analysis);
+}
+
+void AnalysisCache::Codec::serialize(QDataStream& out, const TrackAnalysis& analysis)
+{
+    // Envelope relative to its loudest bucket, so quiet tracks keep their 8 bits
+    const WaveformPyramid::Level& finest = analysis.waveform.finest();
+    QVector<float> envelope = finest.envelope;
+    if (finest.envelopePeak > 0.0f) {
+        for (float& v : envelope)
+            v /= finest.envelopePeak;
+    }
+
+    out << analysis.peak << analysis.rms << analysis.loudnessLufs << analysis.durationSeconds
+        << analysis.leadingSilenceSeconds << analysis.trailingSilenceSeconds
+        << finest.envelopePeak << quantizeUnsigned(envelope)
+        << quantizeSigned(finest.minimum) << quantizeSigned(finest.maximum);
+}
+
+bool AnalysisCache::Codec::deserialize(QDataStream& in, TrackAnalysis* analysis)
+{
+    float envelopePeak = 0.0f;
+    QByteArray envelope, minimum, maximum;
+    in >> analysis->peak >> analysis->rms >> analysis->loudnessLufs >> analysis->durationSeconds
+       >> analysis->leadingSilenceSeconds >> analysis->trailingSilenceSeconds
+       >> envelopePeak >> envelope >> minimum >> maximum;
+    if (in.status() != QDataStream::Ok || envelope.isEmpty() ||
+        minimum.size() != envelope.size() || maximum.size() != envelope.size())
+        return false;
+
+    QVector<float> finestEnvelope = expandUnsigned(envelope);
+    for (float& v : finestEnvelope)
+        v *= envelopePeak;
+    analysis->waveform = WaveformPyramid(finestEnvelope, expandSigned(minimum), expandSigned(maximum));
+    analysis->complete = true;
+    return true;
+}
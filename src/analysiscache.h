@@ -0,0 +1,45 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <QString>
+#include "diskcache.h"
+#include "trackanalysis.h"
+
+/**
+ * Track analyses keyed by track id and stream format: a small in-memory LRU in
+ * front of one compact binary file per track under the cache location. The
+ * finest waveform level is stored as 8-bit values (the coarser ones are
+ * merged from it on load); files carry ALGORITHM_VERSION and are
+ * ignored (and replaced) when analyzeTrack() changes.
+ */
+class AnalysisCache
+{
+public:
+    // Bump whenever analyzeTrack() output or the file layout changes
+    static constexpr quint32 ALGORITHM_VERSION = 3;
+
+    explicit AnalysisCache(int memoryEntries = 64);
+
+    // Memory first, then disk (promoted to memory). Misses are remembered in
+    // memory too, so asking again doesn't touch the disk until insert().
+    // Not thread-safe: owner thread only.
+    bool find(const QString& trackId, const QString& format, TrackAnalysis* out);
+    void insert(const QString& trackId, const QString& format, const TrackAnalysis& analysis);
+
+    // Disk side, safe from any thread (files are replaced atomically)
+    bool readFromDisk(const QString& trackId, const QString& format, TrackAnalysis* out) const;
+    void writeToDisk(const QString& trackId, const QString& format, const TrackAnalysis& analysis) const;
+
+private:
+    // File body: levels, silence, and the finest waveform level quantized
+    struct Codec {
+        static void serialize(QDataStream& out, const TrackAnalysis& analysis);
+        static bool deserialize(QDataStream& in, TrackAnalysis* analysis);
+    };
+
+    static QString key(const QString& trackId, const QString& format);
+
+    DiskCache<TrackAnalysis, Codec> m_store;  // Memory entries include known misses (invalid analyses)
+};
+
+#endif // ANALYSISCACHE_H
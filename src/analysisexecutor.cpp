@@ -0,0 +1,146 @@
+#include "analysisexecutor.h"
+#include <QThread>
+
+AnalysisExecutor::AnalysisExecutor(int threadCount)
+{
+    const int count = qMax(1, threadCount);
+    for (int i = 0; i < count; ++i) {
+        QThread* worker = QThread::create([this]() { workerLoop(); });
+        worker->setObjectName(QString("AnalysisWorker%1").arg(i));
+        worker->start(QThread::LowPriority);
+        m_workers.append(worker);
+    }
+}
+
+AnalysisExecutor::~AnalysisExecutor()
+{
+    shutdown();
+}
+
+AnalysisExecutor::CancellationToken AnalysisExecutor::submit(const QString& key, Priority priority, Job job)
+{
+    QueuedJob entry;
+    entry.key = key;
+    entry.priority = priority;
+    entry.job = std::move(job);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping) {
+        entry.token.cancel();
+        return entry.token;
+    }
+
+    // Supersede the previous job for this key: drop it if still queued, else let it abort
+    auto latest = m_latest.find(key);
+    if (latest != m_latest.end()) {
+        latest->cancel();
+        ++m_stats.coalesced;
+        for (int i = 0; i < m_queue.size(); ++i) {
+            if (m_queue[i].key == key) {
+                m_queue.removeAt(i);
+                ++m_stats.cancelled;
+                break;
+            }
+        }
+    }
+
+    m_latest.insert(key, entry.token);
+
+    // Insert behind every job of the same or higher priority
+    int position = m_queue.size();
+    while (position > 0 && m_queue[position - 1].priority < priority)
+        --position;
+    const CancellationToken token = entry.token;
+    m_queue.insert(position, std::move(entry));
+
+    ++m_stats.submitted;
+    m_stats.maxQueued = qMax(m_stats.maxQueued, static_cast<int>(m_queue.size()));
+    m_wakeup.wakeOne();
+    return token;
+}
+
+void AnalysisExecutor::cancel(const QString& key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto latest = m_latest.find(key);
+    if (latest == m_latest.end())
+        return;
+
+    latest->cancel();
+    m_latest.erase(latest);
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i].key == key) {
+            m_queue.removeAt(i);
+            ++m_stats.cancelled;
+            break;
+        }
+    }
+}
+
+void AnalysisExecutor::cancelAll()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const CancellationToken& token : std::as_const(m_latest))
+        token.cancel();
+    m_latest.clear();
+    m_stats.cancelled += m_queue.size();
+    m_queue.clear();
+}
+
+void AnalysisExecutor::shutdown()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stopping)
+            return;
+        m_stopping = true;
+    }
+    cancelAll();
+    m_wakeup.wakeAll();
+
+    for (QThread* worker : std::as_const(m_workers)) {
+        worker->wait();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+AnalysisExecutor::Stats AnalysisExecutor::takeStats()
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.queued = m_queue.size();
+    stats.running = m_running;
+
+    m_stats = Stats();
+    return stats;
+}
+
+void AnalysisExecutor::workerLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        while (m_queue.isEmpty() && !m_stopping)
+            m_wakeup.wait(&m_mutex);
+        if (m_stopping)
+            return;
+
+        QueuedJob entry = m_queue.takeFirst();
+        ++m_running;
+        locker.unlock();
+
+        if (!entry.token.isCancelled())
+            entry.job(entry.token);
+
+        locker.relock();
+        --m_running;
+        if (entry.token.isCancelled()) {
+            ++m_stats.cancelled;
+        } else {
+            ++m_stats.completed;
+            auto latest = m_latest.find(entry.key);
+            if (latest != m_latest.end() && *latest == entry.token)
+                m_latest.erase(latest);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef ANALYSISEXECUTOR_H
+#define ANALYSISEXECUTOR_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QThread;
+
+/**
+ * Small fixed pool of low-priority threads for CPU-heavy track analysis
+ * (whole-file waveform decodes), kept apart from the global QThreadPool.
+ * Jobs are keyed (usually by track) and ordered by priority. A new job for a
+ * key supersedes the previous one: a queued job is dropped, a running one is
+ * cancelled. Jobs poll their cancellation token between units of work, so
+ * rapid skipping never leaves whole-file decodes running behind it.
+ */
+class AnalysisExecutor
+{
+public:
+    enum Priority {
+        Background,  // Speculative / idle work
+        Preload,     // Next track in the queue
+        Current      // Track that is playing now
+    };
+
+    // Shared flag between the submitter and the job; copies are cheap
+    class CancellationToken
+    {
+    public:
+        CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+        bool isCancelled() const { return m_cancelled->load(std::memory_order_relaxed); }
+        void cancel() const { m_cancelled->store(true, std::memory_order_relaxed); }
+        bool operator==(const CancellationToken& other) const { return m_cancelled == other.m_cancelled; }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_cancelled;
+    };
+
+    using Job = std::function<void(const CancellationToken& token)>;
+
+    struct Stats {
+        int queued = 0;         // Waiting now
+        int running = 0;        // Executing now
+        int maxQueued = 0;      // Deepest queue since the last takeStats()
+        quint64 submitted = 0;
+        quint64 completed = 0;
+        quint64 cancelled = 0;  // Dropped before starting or aborted while running
+        quint64 coalesced = 0;  // Superseded by a newer job for the same key
+    };
+
+    explicit AnalysisExecutor(int threadCount = 2);
+    ~AnalysisExecutor();
+
+    // Queue job under key; supersedes any pending or running job for the same key
+    CancellationToken submit(const QString& key, Priority priority, Job job);
+
+    // Cancel the queued and running jobs for key (no-op for unknown keys)
+    void cancel(const QString& key);
+    void cancelAll();
+
+    // Stops the workers after cancelling everything; called by the destructor
+    void shutdown();
+
+    // Current depth plus counters since the last call (counters are reset)
+    Stats takeStats();
+
+private:
+    struct QueuedJob {
+        QString key;
+        Priority priority;
+        CancellationToken token;
+        Job job;
+    };
+
+    void workerLoop();
+
+    QList<QThread*> m_workers;
+    QMutex m_mutex;
+    QWaitCondition m_wakeup;
+    QList<QueuedJob> m_queue;                    // Highest priority first, FIFO within one
+    QHash<QString, CancellationToken> m_latest;  // Newest token per key (queued or running)
+    int m_running = 0;
+    bool m_stopping = false;
+    Stats m_stats;
+};
+
+#endif // ANALYSISEXECUTOR_H
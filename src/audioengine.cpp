@@ -2,6 +2,7 @@
 #include "deezerapi.h"
 #include "streamdownloader.h"
 #include "windowsmediacontrols.h"
+#include "spectrumengine.h"
 #include <QTimer>
 #include <QThread>
 #include <QMetaObject>
@@ -33,33 +34,51 @@ AudioEngine::AudioEngine(QObject *parent)
     , m_currentIndex(-1)
     , m_repeatMode(RepeatOff)
     , m_preloadStream(0)
-    , m_outputMode(OutputDirectSound)
-    , m_wasapiDevice(-1)
     , m_outputSampleRate(44100)
 {
     qRegisterMetaType<DWORD>("DWORD");
+    // Signal arguments that cross to the GUI thread when running on the control thread
+    qRegisterMetaType<AudioEngine::PlaybackState>("AudioEngine::PlaybackState");
+    qRegisterMetaType<AudioEngine::RepeatMode>("AudioEngine::RepeatMode");
+    qRegisterMetaType<std::shared_ptr<Track>>("std::shared_ptr<Track>");
+    qRegisterMetaType<WaveformPyramid>("WaveformPyramid");
+    qRegisterMetaType<QueueChangeSet>("QueueChangeSet");
 
     m_positionTimer = new QTimer(this);
     connect(m_positionTimer, &QTimer::timeout, this, &AudioEngine::updatePosition);
 
-    m_spectrumTimer = new QTimer(this);
-    m_spectrumTimer->setInterval(33); // ~30 FPS
-    m_spectrumEnabled = true;  // Enabled by default for visualizer support
-    connect(m_spectrumTimer, &QTimer::timeout, this, &AudioEngine::updateSpectrum);
+    m_analysisThread = new QThread(this);
+    m_spectrumEngine = new SpectrumEngine(&m_audioTap);
+    m_spectrumEngine->moveToThread(m_analysisThread);
+    connect(m_analysisThread, &QThread::finished, m_spectrumEngine, &QObject::deleteLater);
+    connect(m_spectrumEngine, &SpectrumEngine::spectrumReady, this, &AudioEngine::spectrumDataReady, Qt::QueuedConnection);
+    m_analysisThread->start();
 
     m_downloadThread = new QThread(this);
     m_streamDownloader = new StreamDownloader();
     m_streamDownloader->moveToThread(m_downloadThread);
     connect(m_streamDownloader, &StreamDownloader::chunkReady, this, &AudioEngine::onStreamChunkReady, Qt::QueuedConnection);
     connect(m_streamDownloader, &StreamDownloader::progressiveDownloadFinished, this, &AudioEngine::onProgressiveDownloadFinished, Qt::QueuedConnection);
+    connect(m_streamDownloader, &StreamDownloader::streamSizeKnown, this, &AudioEngine::onStreamSizeKnown, Qt::QueuedConnection);
 
     m_preloadDownloader = new StreamDownloader();
     m_preloadDownloader->moveToThread(m_downloadThread);
     connect(m_preloadDownloader, &StreamDownloader::chunkReady, this, &AudioEngine::onPreloadChunkReady, Qt::QueuedConnection);
     connect(m_preloadDownloader, &StreamDownloader::progressiveDownloadFinished, this, &AudioEngine::onPreloadDownloadFinished, Qt::QueuedConnection);
+    connect(m_preloadDownloader, &StreamDownloader::streamSizeKnown, this, &AudioEngine::onPreloadSizeKnown, Qt::QueuedConnection);
+
+    // Small pool for speculative (hover/selection) head downloads -- the pool size is the concurrency budget
+    for (int i = 0; i < 2; ++i) {
+        StreamDownloader* downloader = new StreamDownloader();
+        downloader->moveToThread(m_downloadThread);
+        connect(downloader, &StreamDownloader::chunkReady, this, &AudioEngine::onSpeculativeChunkReady, Qt::QueuedConnection);
+        connect(downloader, &StreamDownloader::progressiveDownloadFinished, this, &AudioEngine::onSpeculativeDownloadFinished, Qt::QueuedConnection);
+        m_speculativeDownloaders.append(downloader);
+    }
 
     m_downloadThread->start();
 
+    // Parented while the engine shares the GUI thread; startControlThread() detaches it
     m_windowsMediaControls = new WindowsMediaControls(this);
     connect(m_windowsMediaControls, &WindowsMediaControls::playRequested, this, &AudioEngine::play);
     connect(m_windowsMediaControls, &WindowsMediaControls::pauseRequested, this, &AudioEngine::pause);
@@ -69,13 +88,73 @@ AudioEngine::AudioEngine(QObject *parent)
 
 AudioEngine::~AudioEngine()
 {
+    if (m_controlThread)
+        stopControlThread();
+
     shutdown();
+    m_analysisExecutor.shutdown();  // Workers post results to this object
+
+    m_analysisThread->quit();
+    m_analysisThread->wait();
+}
+
+// ── Control Thread ──────────────────────────────────────────────────────
+
+void AudioEngine::startControlThread()
+{
+    if (m_controlThread || QThread::currentThread() != thread())
+        return;
+
+    // A QObject with a parent can't change threads
+    if (parent()) {
+        emit debugLog("[AudioEngine] Control thread needs a parentless engine, staying on the current thread");
+        return;
+    }
+
+    // The media controls need a window handle, so they stay behind on this thread
+    if (m_windowsMediaControls)
+        m_windowsMediaControls->setParent(nullptr);
+
+    m_controlThread = new QThread();
+    m_controlThread->setObjectName("AudioEngineControl");
+    moveToThread(m_controlThread);
+    m_controlThread->start(QThread::TimeCriticalPriority);
+
+    emit debugLog("[AudioEngine] Running on a dedicated control thread");
+}
+
+void AudioEngine::stopControlThread()
+{
+    if (!m_controlThread)
+        return;
+
+    // Only the owning thread may push an object away, so hand the engine back
+    // from inside the control thread and wait for it
+    QThread* target = QThread::currentThread();
+    if (target != thread()) {
+        QMetaObject::invokeMethod(this, [this, target]() {
+            moveToThread(target);
+        }, Qt::BlockingQueuedConnection);
+    } else {
+        moveToThread(target);
+    }
+
+    m_controlThread->quit();
+    m_controlThread->wait();
+    delete m_controlThread;
+    m_controlThread = nullptr;
+
+    if (m_windowsMediaControls && m_windowsMediaControls->thread() == thread())
+        m_windowsMediaControls->setParent(this);
 }
 
 // ── Initialization & Shutdown ───────────────────────────────────────────
 
 bool AudioEngine::initialize()
 {
+    if (QThread::currentThread() != thread())
+        return callOnEngineThread([this]() { return initialize(); });
+
     if (m_initialized) {
         return true;
     }
@@ -101,7 +180,7 @@ bool AudioEngine::initialize()
         }
 
         // Find WASAPI device index
-        int wasapiDev = (m_wasapiDevice >= 0) ? m_wasapiDevice : -1;
+        int wasapiDev = (m_wasapiDevice >= 0) ? m_wasapiDevice.load() : -1;
         if (wasapiDev < 0) {
             // Find default output device
             BASS_WASAPI_DEVICEINFO devInfo;
@@ -236,6 +315,8 @@ bool AudioEngine::initialize()
 
     // Create mixer stream with correct format
     // The mixer's format will drive WASAPI's format negotiation
+    // (mixer creation is mixer control: reinitialize() rebuilds it here)
+    QMutexLocker mixerLocker(&m_mixerMutex);
     m_mixerStream = BASS_Mixer_StreamCreate(
         mixerRate,
         2,
@@ -295,7 +376,7 @@ bool AudioEngine::initialize()
             }
 
             QString modeStr = (m_outputMode == OutputWasapiExclusive) ? "Exclusive" : "Shared";
-            emit debugLog(QString("[AudioEngine] WASAPI %1 mode active at %2 Hz").arg(modeStr).arg(m_outputSampleRate));
+            emit debugLog(QString("[AudioEngine] WASAPI %1 mode active at %2 Hz").arg(modeStr).arg(m_outputSampleRate.load()));
         }
 
     // Set up BASS_SYNC_MIXER_QUEUE sync to be notified when streams are dequeued
@@ -317,20 +398,19 @@ bool AudioEngine::initialize()
     // Set volume on mixer
     BASS_ChannelSetAttribute(m_mixerStream, BASS_ATTRIB_VOL, m_volume);
 
-    // Start spectrum timer if enabled
-    if (m_spectrumEnabled) {
-        emit debugLog("[AudioEngine] Starting spectrum timer...");
-        m_spectrumTimer->start();
-        emit debugLog(QString("[AudioEngine] Spectrum timer started: %1").arg(m_spectrumTimer->isActive() ? "ACTIVE" : "INACTIVE"));
-    }
-
     m_initialized = true;
+    publishStreamState();
     emit debugLog("[AudioEngine] Initialized with BassMix gapless playback");
     return true;
 }
 
 void AudioEngine::shutdown()
 {
+    if (QThread::currentThread() != thread()) {
+        callOnEngineThread([this]() { shutdown(); return true; });
+        return;
+    }
+
     if (!m_initialized) {
         return;
     }
@@ -338,11 +418,12 @@ void AudioEngine::shutdown()
     stop();
     destroyStream();
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_mixerMutex);
     if (m_mixerStream) {
         BASS_StreamFree(m_mixerStream);
         m_mixerStream = 0;
     }
+    publishStreamState();
     locker.unlock();
 
     if (m_downloadThread && m_downloadThread->isRunning()) {
@@ -363,12 +444,15 @@ void AudioEngine::shutdown()
 
 void AudioEngine::play()
 {
+    if (postToEngineThread([this]() { play(); }))
+        return;
+
     if (!m_initialized || !m_mixerStream) {
         emit debugLog("[AudioEngine] play() ignored: not initialized or no mixer");
         return;
     }
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_mixerMutex);
 
     if (startMixerOutput()) {
         setState(Playing);
@@ -381,11 +465,14 @@ void AudioEngine::play()
 
 void AudioEngine::pause()
 {
+    if (postToEngineThread([this]() { pause(); }))
+        return;
+
     if (!m_initialized || !m_mixerStream) {
         return;
     }
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_mixerMutex);
     if (m_outputMode != OutputDirectSound) {
         BASS_WASAPI_Stop(FALSE);  // FALSE = don't reset, just pause
     } else {
@@ -397,13 +484,16 @@ void AudioEngine::pause()
 
 void AudioEngine::stop()
 {
+    if (postToEngineThread([this]() { stop(); }))
+        return;
+
     if (!m_initialized || !m_mixerStream) {
         return;
     }
 
     m_positionTimer->stop();
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_mixerMutex);
 
     // Stop output but DON'T remove the stream
     // This allows resuming from the same position
@@ -417,23 +507,56 @@ void AudioEngine::stop()
 
 void AudioEngine::seek(double position)
 {
+    if (postToEngineThread([this, position]() { seek(position); }))
+        return;
+
     if (!m_initialized || !m_mixerStream) {
         return;
     }
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_mixerMutex);
     if (!m_currentStream) {
         return;
     }
 
-    // During progressive download, use track metadata for seek calculation
+    // During progressive download the seek index (or the track metadata) supplies the
+    // length, and the file offsets used to clamp and to re-fetch a capped window. The
+    // seek itself stays a time: BASS maps it to a file position through its decoder.
     QWORD length = BASS_ChannelGetLength(m_currentStream, BASS_POS_BYTE);
     if (length == (QWORD)-1 || m_pushStream != 0) {
-        if (m_currentTrack && m_currentTrack->duration() > 0) {
-            double targetSeconds = position * m_currentTrack->duration();
+        double lengthSecs = trackLengthSeconds();
+        if (lengthSecs > 0.0) {
+            double targetSeconds = position * lengthSecs;
+
+            // Memory-capped stream: a target outside the in-memory window is re-fetched
+            // first, the seek completes when its data has arrived
+            if (m_streamCapped && refetchStreamForSeek(targetSeconds))
+                return;
+
+            // Only the downloaded part can be decoded: keep the target inside it
+            // (with a margin for the decoder's read-ahead)
+            if (m_progressiveMode.load() && !m_streamCapped) {
+                qint64 buffered;
+                {
+                    QMutexLocker bufLock(&m_bufferMutex);
+                    buffered = m_streamBuffer.size();
+                }
+                qint64 targetByte = streamByteForTime(targetSeconds);
+                if (targetByte >= 0 && targetByte > buffered - 65536) {
+                    double bufferedSeconds = streamTimeForByte(buffered - 65536);
+                    if (bufferedSeconds >= 0.0) {
+                        emit debugLog(QString("[AudioEngine] Seek to %1s is past the downloaded data, clamping to %2s")
+                                      .arg(targetSeconds, 0, 'f', 1).arg(bufferedSeconds, 0, 'f', 1));
+                        targetSeconds = qMin(targetSeconds, bufferedSeconds);
+                    }
+                }
+            }
+
+            // Decoded-PCM position, not a file offset
             QWORD seekPos = BASS_ChannelSeconds2Bytes(m_currentStream, targetSeconds);
             BASS_Mixer_ChannelSetPosition(m_currentStream, seekPos,
                                           BASS_POS_BYTE | BASS_POS_MIXER_RESET);
+            m_playbackClock.publish(targetSeconds);
             return;
         }
         emit debugLog("[AudioEngine] Cannot seek: stream length unknown");
@@ -444,17 +567,63 @@ void AudioEngine::seek(double position)
 
     BASS_Mixer_ChannelSetPosition(m_currentStream, seekPos,
                                    BASS_POS_BYTE | BASS_POS_MIXER_RESET);
+    m_playbackClock.publish(BASS_ChannelBytes2Seconds(m_currentStream, seekPos));
 }
 
 void AudioEngine::setDeezerAPI(DeezerAPI* api)
 {
+    if (postToEngineThread([this, api]() { setDeezerAPI(api); }))
+        return;
+
     m_deezerAPI = api;
 }
 
+// DeezerAPI's network access lives on the GUI thread. Called directly when the
+// engine shares that thread, so a synchronous answer (preview fallback) still
+// arrives before this returns.
+void AudioEngine::requestStreamUrl(const QString& streamId, const QString& trackToken, const QString& format)
+{
+    DeezerAPI* api = m_deezerAPI;
+    QMetaObject::invokeMethod(api, [api, streamId, trackToken, format]() {
+        api->getStreamUrl(streamId, trackToken, format);
+    });
+}
+
+void AudioEngine::setGaplessEnabled(bool enabled)
+{
+    if (postToEngineThread([this, enabled]() { setGaplessEnabled(enabled); }))
+        return;
+
+    m_gaplessEnabled = enabled;
+}
+
 // ── Volume & Repeat ─────────────────────────────────────────────────────
 
+void AudioEngine::discardPreload()
+{
+    {
+        // The queue sync may be promoting the preloaded stream right now
+        QMutexLocker locker(&m_streamMutex);
+        if (m_preloadStream) {
+            BASS_Mixer_ChannelRemove(m_preloadStream);
+            BASS_StreamFree(m_preloadStream);
+            m_preloadStream = 0;
+        }
+        m_preloadBuffer.clear();
+    }
+    m_preloadTrack.reset();
+    m_preloadReady = false;
+
+    // Cancel worker download (empty URL cancels)
+    QMetaObject::invokeMethod(m_preloadDownloader, "startProgressiveDownload", Qt::QueuedConnection,
+                              Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+}
+
 void AudioEngine::setRepeatMode(RepeatMode mode)
 {
+    if (postToEngineThread([this, mode]() { setRepeatMode(mode); }))
+        return;
+
     if (m_repeatMode != mode) {
         RepeatMode oldMode = m_repeatMode;
         m_repeatMode = mode;
@@ -464,24 +633,28 @@ void AudioEngine::setRepeatMode(RepeatMode mode)
         // a duplicate of the current track (queued for looping). Remove it
         // and preload the correct next track instead.
         if (oldMode == RepeatOne && m_currentStream) {
-            if (m_preloadStream) {
-                BASS_Mixer_ChannelRemove(m_preloadStream);
-                BASS_StreamFree(m_preloadStream);
-                m_preloadStream = 0;
-                emit debugLog("[AudioEngine] Cleared RepeatOne preloaded stream");
-            }
-            m_preloadTrack.reset();
-            m_preloadBuffer.clear();
-            m_preloadReady = false;
+            discardPreload();
+            emit debugLog("[AudioEngine] Cleared RepeatOne preload");
 
             // Preload the correct next track for the new mode
             preloadNextTrack();
         }
+
+        // Switching to RepeatOne: a different track may already be queued for
+        // gapless playback -- replace it with a repeat of the buffered current track
+        if (mode == RepeatOne && m_currentStream && !m_progressiveMode.load()) {
+            discardPreload();
+            if (m_gaplessEnabled)
+                queueRepeatFromBuffer();
+        }
     }
 }
 
 void AudioEngine::setVolume(float volume)
 {
+    if (postToEngineThread([this, volume]() { setVolume(volume); }))
+        return;
+
     m_volume = qBound(0.0f, volume, 1.0f);
 
     if (m_initialized && m_mixerStream) {
@@ -491,20 +664,101 @@ void AudioEngine::setVolume(float volume)
 
 // ── State Management ────────────────────────────────────────────────────
 
+void AudioEngine::publishStreamState()
+{
+    m_publishedMixer.store(m_mixerStream, std::memory_order_release);
+    m_publishedStream.store(m_currentStream, std::memory_order_release);
+    m_publishedPushStream.store(m_pushStream != 0, std::memory_order_release);
+
+    // Length is fixed once the stream exists; readers get it from the clock
+    m_playbackClock.setLengthSeconds(streamLengthSeconds());
+
+    // The DSP goes away with the mixer it was set on
+    if (m_mixerStream != m_dspMixer) {
+        m_dspMixer = m_mixerStream;
+        if (m_dspMixer) {
+            BASS_CHANNELINFO info;
+            if (BASS_ChannelGetInfo(m_dspMixer, &info))
+                m_audioTap.setFormat(info.freq, (info.flags & BASS_SAMPLE_FLOAT) != 0);
+            BASS_ChannelSetDSP(m_dspMixer, mixerDspCallback, this, 0);
+        }
+    }
+}
+
+void AudioEngine::logLockContention()
+{
+    const CountingMutex::Stats mixer = m_mixerMutex.takeStats();
+    const CountingMutex::Stats stream = m_streamMutex.takeStats();
+    if (mixer.contended == 0 && stream.contended == 0)
+        return;
+
+    auto describe = [](const CountingMutex::Stats& stats) {
+        return QString("%1/%2 waited (total %3 ms, max %4 ms)")
+            .arg(stats.contended).arg(stats.acquisitions)
+            .arg(stats.waitNs / 1e6, 0, 'f', 2).arg(stats.maxWaitNs / 1e6, 0, 'f', 2);
+    };
+    emit debugLog(QString("[AudioEngine] Lock contention: mixer %1, stream %2")
+                  .arg(describe(mixer), describe(stream)));
+}
+
 void AudioEngine::setState(PlaybackState state)
 {
     if (m_state != state) {
         m_state = state;
+        m_playbackClock.setRunning(state == Playing);
         emit stateChanged(state);
-
-        if (m_windowsMediaControls) {
-            m_windowsMediaControls->updatePlaybackState(state == Playing);
-        }
+        updateMediaControlsState(state == Playing);
     }
 }
 
+// The media controls stay on the GUI thread; a functor call with the controls
+// as context runs directly there and is queued from the control thread
+void AudioEngine::updateMediaControlsState(bool playing)
+{
+    if (!m_windowsMediaControls)
+        return;
+    WindowsMediaControls* controls = m_windowsMediaControls;
+    QMetaObject::invokeMethod(controls, [controls, playing]() {
+        controls->updatePlaybackState(playing);
+    });
+}
+
+void AudioEngine::updateMediaControlsMetadata()
+{
+    if (!m_windowsMediaControls || !m_currentTrack)
+        return;
+    WindowsMediaControls* controls = m_windowsMediaControls;
+    const QString title = m_currentTrack->title();
+    const QString artist = m_currentTrack->artist();
+    const QString album = m_currentTrack->album();
+    const QUrl artUrl(m_currentTrack->albumArt());
+    QMetaObject::invokeMethod(controls, [controls, title, artist, album, artUrl]() {
+        controls->updateMetadata(title, artist, album, artUrl);
+    });
+}
+
 // ── BASS Sync Callbacks ─────────────────────────────────────────────────
 
+// Runs on the mixer thread for every block it renders: copy the block into the
+// audio tap and anchor the clock to the current source position (mixer positions
+// already account for output latency)
+void CALLBACK AudioEngine::mixerDspCallback(HDSP handle, DWORD channel, void* buffer, DWORD length, void* user)
+{
+    AudioEngine* engine = static_cast<AudioEngine*>(user);
+    if (engine->m_tapActive.load(std::memory_order_relaxed))
+        engine->m_audioTap.write(buffer, static_cast<int>(length));
+
+    const HSTREAM stream = engine->m_publishedStream.load(std::memory_order_acquire);
+    if (!stream)
+        return;
+
+    QWORD pos = BASS_Mixer_ChannelGetPosition(stream, BASS_POS_BYTE);
+    if (pos == (QWORD)-1)
+        return;
+
+    engine->m_playbackClock.publish(BASS_ChannelBytes2Seconds(stream, pos));
+}
+
 void CALLBACK AudioEngine::syncEndCallback(HSYNC handle, DWORD channel, DWORD data, void* user)
 {
     AudioEngine* engine = static_cast<AudioEngine*>(user);
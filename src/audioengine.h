@@ -3,23 +3,41 @@
 
 #include <QObject>
 #include <QQueue>
+#include <QHash>
 #include <QByteArray>
 #include <QVector>
 #include <QMutex>
 #include <QRecursiveMutex>
+#include <QThread>
 #include <atomic>
 #include <memory>
 #include <QElapsedTimer>
 #include "track.h"
+#include "mediaheader.h"
+#include "countingmutex.h"
+#include "playbackclock.h"
+#include "audiotap.h"
+#include "analysisexecutor.h"
+#include "trackanalysis.h"
+#include "analysiscache.h"
+#include "queuechange.h"
+#include "streambuffer.h"
 
 class QTimer;
-class QThread;
 class DeezerAPI;
 class StreamDownloader;
+class SpectrumEngine;
 
 // BASS types for callback declarations (bass.h uses extern "C" when included from C++)
 #include "bass.h"
 
+/**
+ * Playback engine: BASS output, streaming/decryption, queue and gapless handling.
+ * Usually created on the GUI thread and optionally moved to a dedicated control
+ * thread with startControlThread(). Every public call is safe from any thread:
+ * commands are queued to the engine's thread, getters read published state or
+ * run there blocking; results come back as (queued) signals.
+ */
 class AudioEngine : public QObject
 {
     Q_OBJECT
@@ -60,6 +78,13 @@ public:
     bool initialize();
     void shutdown();
 
+    // Run the engine on its own high-priority thread, so chunk handling, stream
+    // creation and BASS syncs never wait behind UI work. stopControlThread()
+    // moves the engine back to the calling thread (call before deleting it).
+    void startControlThread();
+    void stopControlThread();
+    bool hasControlThread() const { return m_controlThread != nullptr; }
+
     // Playback control
     void play();
     void pause();
@@ -75,75 +100,109 @@ public:
     void next();
     void previous();
 
-    // Queue management
+    // Queue management. Multi-track edits run as one transaction: a single pass
+    // over the queue, one preload check and one queueEdited() for the whole edit.
     void removeFromQueue(int index);
     void removeFromQueue(const QList<int>& indices);
     void moveInQueue(int fromIndex, int toIndex);
+    void moveInQueue(const QList<int>& indices, int toIndex);  // As a block, first track ends up at toIndex
     void addToQueue(std::shared_ptr<Track> track, int position = -1);  // -1 = append
     void addToQueue(const QList<std::shared_ptr<Track>>& tracks, int position = -1);
     void clearQueue();
 
     // Repeat mode
     void setRepeatMode(RepeatMode mode);
-    RepeatMode repeatMode() const { return m_repeatMode; }
+    RepeatMode repeatMode() const { return m_repeatMode.load(std::memory_order_relaxed); }
     
     // Volume control (0.0 to 1.0)
     void setVolume(float volume);
-    float volume() const { return m_volume; }
+    float volume() const { return m_volume.load(std::memory_order_relaxed); }
     
     // Getters
-    PlaybackState state() const { return m_state; }
-    std::shared_ptr<Track> currentTrack() const { 
-        QMutexLocker locker(&m_bassMutex);
-        return m_currentTrack; 
-    }
-    int currentIndex() const { return m_currentIndex; }
-    QString contextType() const { return m_contextType; }
-    QString contextId() const { return m_contextId; }
+    PlaybackState state() const { return m_state.load(std::memory_order_relaxed); }
+    // Queue state as of the last queueChanged/trackChanged, never waits for the engine
+    std::shared_ptr<Track> currentTrack() const;
+    int currentIndex() const;
+    QString contextType() const;
+    QString contextId() const;
     QList<std::shared_ptr<Track>> queue() const;
     int positionSeconds() const;
     int durationSeconds() const;
-    
+
+    // Interpolated playback position, updated by the mixer thread; safe to read
+    // from any thread at display rate (no locks, no BASS calls)
+    const PlaybackClock& playbackClock() const { return m_playbackClock; }
+
+    // Visualization feeds only run while some consumer is subscribed, at the
+    // highest rate any subscriber asked for. Consumers subscribe when shown and
+    // unsubscribe when hidden/minimized; destroyed consumers are dropped.
+    //  - SpectrumFeed: spectrumDataReady from the analysis thread
+    //  - PcmFeed: the consumer reads audioTap() itself with its own cursor
+    enum VisualizationFeed { SpectrumFeed = 0x1, PcmFeed = 0x2 };
+    void subscribeVisualization(QObject* consumer, int feeds, int fps);
+    void unsubscribeVisualization(QObject* consumer);
+    const AudioTap& audioTap() const { return m_audioTap; }
+
     // Gapless playback settings
-    void setGaplessEnabled(bool enabled) { m_gaplessEnabled = enabled; }
+    void setGaplessEnabled(bool enabled);
+
+    // Driven by the per-track analysis (one decode per track, cached): loudness
+    // normalization to a common target, and skipping the silence at the end of
+    // a track and the start of the next on gapless transitions
+    void setLoudnessNormalization(bool enabled);
+    void setSilenceTrimming(bool enabled);
+    TrackAnalysis trackAnalysis(const QString& trackId, const QString& format) const;  // Current/preloaded track only, invalid if not analysed yet
 
     // Manual preloading (e.g., triggered by UI hover)
     void preloadNextTrack();
-    bool isNextPreloaded() const { return m_preloadReady; }
+    bool isNextPreloaded() const { return m_preloadReady.load(std::memory_order_relaxed); }
+
+    // Speculative preloading of any track (hover/selection in track lists):
+    // resolves the stream URL and fetches the head of the file at low priority,
+    // so a following loadTrack() can start playback almost immediately
+    void speculativePreload(std::shared_ptr<Track> track);
+    void cancelSpeculativePreload(std::shared_ptr<Track> track);
 
     // Output mode (DirectSound / WASAPI Shared / WASAPI Exclusive)
     void setOutputMode(OutputMode mode, int wasapiDevice = -1);
     bool reinitialize(OutputMode mode, int wasapiDevice = -1);
-    OutputMode outputMode() const { return m_outputMode; }
-    int wasapiDeviceIndex() const { return m_wasapiDevice; }
-    DWORD outputSampleRate() const { return m_outputSampleRate; }
+    OutputMode outputMode() const;
+    int wasapiDeviceIndex() const;
+    DWORD outputSampleRate() const;
     static QList<AudioDevice> enumerateWasapiDevices();
 
 signals:
     void stateChanged(PlaybackState state);
-    void trackChanged(std::shared_ptr<Track> track);
-    void queueChanged();
+    void trackChanged(std::shared_ptr<Track> track, const QByteArray& embeddedCoverArt);  // Art from the file, empty if none
+    // Next track is being fetched (followingTrack plays after it, may be null): prefetch their extras
+    void preloadStarted(std::shared_ptr<Track> track, std::shared_ptr<Track> followingTrack);
+    void queueChanged();  // Queue or current index changed
+    void queueEdited(const QueueChangeSet& changes);  // Structural edits, in order (before queueChanged)
     void positionChanged(int seconds);
     void streamInfoChanged(const QString& info); // e.g. "FLAC | 1411 kbps | 44100 Hz | stereo"
-    void waveformReady(const QVector<float>& peaks);
+    void waveformReady(const WaveformPyramid& waveform);
     void positionTick(double position); // 0.0-1.0, emitted every ~100ms for smooth waveform playhead
     void repeatModeChanged(AudioEngine::RepeatMode mode);
-    void spectrumDataReady(const QVector<float>& magnitudes); // Spectrum analyzer data
-    void pcmDataReady(const std::vector<float>& leftChannel, const std::vector<float>& rightChannel); // Raw PCM samples for visualizer
+    void trackAnalysisReady(const QString& trackId, const QString& format);  // Full analysis cached, see trackAnalysis()
+    void spectrumDataReady(const QVector<float>& magnitudes, const QVector<float>& peaks); // Bands (0-1) with held peaks
     void error(const QString& message);
     void debugLog(const QString& message);
 
 public slots:
     void onStreamUrlReceived(const QString& trackId, const QString& url, const QString& format);
-    void setSpectrumEnabled(bool enabled);
+    void setSpectrumResolution(int fftSize, int bandCount);  // Applied by the analysis thread
 
 private slots:
     void updatePosition();
-    void updateSpectrum();
     void onStreamChunkReady(const QByteArray& chunk, const QString& trackId);
     void onProgressiveDownloadFinished(const QString& errorMessage, const QString& trackId);
+    void onStreamSizeKnown(qint64 totalBytes, const QString& trackId);
+    void onPreloadSizeKnown(qint64 totalBytes, const QString& trackId);
     void onPreloadChunkReady(const QByteArray& chunk, const QString& trackId);
     void onPreloadDownloadFinished(const QString& errorMessage, const QString& trackId);
+    void onSpeculativeChunkReady(const QByteArray& chunk, const QString& trackId);
+    void onSpeculativeDownloadFinished(const QString& errorMessage, const QString& trackId);
+    void startSpeculativeDownloads();
     void handleStreamEnd(DWORD streamHandle);
     void handleNearEnd();
     void handleStreamDequeued(DWORD streamHandle, int generation);
@@ -153,6 +212,7 @@ private:
     static void CALLBACK syncEndCallback(HSYNC handle, DWORD channel, DWORD data, void* user);
     static void CALLBACK syncNearEndCallback(HSYNC handle, DWORD channel, DWORD data, void* user);
     static void CALLBACK queueSyncCallback(HSYNC handle, DWORD channel, DWORD data, void* user);
+    static void CALLBACK mixerDspCallback(HDSP handle, DWORD channel, void* buffer, DWORD length, void* user);
 
     // BASS FILEPROCS for STREAMFILE_BUFFERPUSH (progressive streaming)
     static void CALLBACK pushStreamClose(void* user);
@@ -160,10 +220,61 @@ private:
     static DWORD CALLBACK pushStreamRead(void* buffer, DWORD length, void* user);
     static BOOL CALLBACK pushStreamSeek(QWORD offset, void* user);
 
+    // Thread marshalling for the public interface. postToEngineThread() queues fn
+    // to the engine's thread and returns true when called from another thread
+    // (the caller then returns); callOnEngineThread() runs fn there and waits.
+    template <typename Fn>
+    bool postToEngineThread(Fn&& fn)
+    {
+        if (QThread::currentThread() == thread())
+            return false;
+        QMetaObject::invokeMethod(this, std::forward<Fn>(fn), Qt::QueuedConnection);
+        return true;
+    }
+
+    template <typename Fn>
+    auto callOnEngineThread(Fn fn) const -> decltype(fn())
+    {
+        if (QThread::currentThread() == thread())
+            return fn();
+        decltype(fn()) result{};
+        QMetaObject::invokeMethod(const_cast<AudioEngine*>(this), [&]() { result = fn(); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+
+    void addVisualizationSubscriber(QObject* consumer, int feeds, int fps,
+                                    const QMetaObject::Connection& destroyedConnection);
+    void updateMediaControlsState(bool playing);
+    void updateMediaControlsMetadata();
+    void requestStreamUrl(const QString& streamId, const QString& trackToken, const QString& format);
+    QList<int> validQueueRows(const QList<int>& indices) const;  // In range, sorted, once each
+    int nextQueueIndex() const;  // Row that plays next under the repeat mode, -1 at the end
+    void beginQueueEdit();
+    void endQueueEdit();  // Outermost: preload check, then publishQueueChanges()
+    void recordQueueChange(QueueChange change, int queueSize = -1);  // Size after the edit (-1: current)
+    void publishQueueChanges();  // queueEdited() with the recorded edits, then queueChanged()
+
     // Internal methods
-    double position() const; // 0.0 to 1.0 (used internally by updatePosition, reinitialize)
+    double position() const; // 0.0 to 1.0 (used internally by reinitialize)
+    double trackLengthSeconds() const;  // Push streams: seek index duration, else track metadata
+    double streamLengthSeconds() const;  // Length of the current stream (durationSeconds() unrounded)
+    double progressiveCompletionRatio(qint64 bufferedBytes) const;  // Share of the track in the buffer
+    qint64 streamByteForTime(double seconds) const;  // Seek index, else linear over the file size; -1 if unknown
+    double streamTimeForByte(qint64 offset) const;
+    void maintainStreamWindow();  // Memory-capped streaming: evict played data, pause/resume the download
+    bool refetchStreamForSeek(double targetSeconds);  // Seek outside the window: Range re-fetch first
+    void completePendingSeek();
+    void analyzeCappedRange();   // Memory-capped streaming: waveform of the data not analysed yet
+    void resetCappedWaveform();
     void setState(PlaybackState state);
-    void startLoadingUrl(const QString& url);
+    void publishStreamState();  // After changing m_mixerStream / m_currentStream / m_pushStream
+    void logLockContention();
+    void logAnalysisStats();
+    void updateVisualizationDemand();
+    void updateTapLatency();  // Output buffer depth, so tap readers see what is audible now
+    void startLoadingUrl(const QString& url, const QByteArray& prefetchedHead = QByteArray(),
+                         bool prefetchComplete = false);
     bool createStream(const QString& url);
     HSTREAM createSourceStream(const QByteArray& data);
     void addStreamToMixer(const QByteArray& data);
@@ -171,6 +282,26 @@ private:
     void setupStreamSyncs(HSTREAM stream, HSYNC* endSyncPtr, HSYNC* nearEndSyncPtr);
     void destroyStream();
     void startWaveformComputation();
+    bool serveCachedWaveform();
+    void submitAnalysisJob(const std::shared_ptr<Track>& track, const QString& format, const StreamBuffer& data,
+                           double completionRatio, AnalysisExecutor::Priority priority);  // Partial while < 1
+    void handleTrackAnalysis(const QString& trackId, const QString& format, const TrackAnalysis& analysis);
+    void publishAnalysis(const QString& trackId, const QString& format, const TrackAnalysis& analysis);
+    QString streamFormat(HSTREAM stream) const;
+    void applyLoudnessGain(HSTREAM stream, const std::shared_ptr<Track>& track);
+    void applyGapTrimming();
+    bool queueRepeatFromBuffer();  // RepeatOne: second decode stream over m_streamBuffer
+    void discardPreload();  // Unqueue and free the preloaded next track, abort its download
+    void setCurrentTrack(std::shared_ptr<Track> track);  // Also publishes it for currentTrack()
+    void publishQueueState();  // Before queueChanged/trackChanged: snapshot for the public getters
+
+    // Speculative preload helpers (audioengine_speculative.cpp)
+    struct SpeculativePreload;
+    int findSpeculativePreload(const QString& streamId) const;
+    int findSpeculativeDownload(const QString& tag) const;  // Entry whose head download is running under tag
+    void dropSpeculativePreload(int index);
+    bool takeSpeculativePreload(const std::shared_ptr<Track>& track, SpeculativePreload* out);
+    bool handleSpeculativeUrl(const QString& streamId, const QString& url, const QString& format);
 
     // Output mode helpers (abstract DirectSound vs WASAPI)
     bool startMixerOutput();   // BASS_ChannelPlay or BASS_WASAPI_Start
@@ -190,65 +321,170 @@ private:
     std::shared_ptr<Track> m_currentTrack;
     std::shared_ptr<Track> m_pendingTrack;
     QList<std::shared_ptr<Track> > m_queue;
+    QueueChangeSet m_pendingQueueChanges;  // Recorded edits not yet published
+    int m_queueEditDepth = 0;
+    bool m_queueEditDropsPreload = false;  // The edit removed the preloaded row
     int m_currentIndex;
-    RepeatMode m_repeatMode;
+    std::atomic<RepeatMode> m_repeatMode;
 
     // Context tracking for log.listen (album/playlist source)
     QString m_contextType;  // e.g., "album_page" or "profile_playlists"
     QString m_contextId;    // Album or playlist ID
+
+    // Copies of the queue state for other threads, taken by publishQueueState()
+    // (the list is implicitly shared, so a snapshot costs a reference count)
+    mutable QMutex m_queueStateMutex;
+    QList<std::shared_ptr<Track>> m_publishedQueue;
+    int m_publishedCurrentIndex = -1;
+    QString m_publishedContextType;
+    QString m_publishedContextId;
+    std::shared_ptr<Track> m_publishedCurrentTrack;
+
+    // Full analyses of the current and preloaded tracks, read by trackAnalysis()
+    // under m_queueStateMutex (the cache itself belongs to the engine thread)
+    struct PublishedAnalysis {
+        QString trackId;
+        QString format;
+        TrackAnalysis analysis;
+    };
+    QList<PublishedAnalysis> m_publishedAnalyses;
     
-    PlaybackState m_state;
-    float m_volume;
+    // Atomic where the public getters read them directly from other threads
+    std::atomic<PlaybackState> m_state;
+    std::atomic<float> m_volume;
     bool m_gaplessEnabled;
-    bool m_initialized;
+    std::atomic<bool> m_initialized;
     
     QTimer* m_positionTimer;
-    QTimer* m_spectrumTimer;
     int m_lastPositionSeconds;
-    bool m_spectrumEnabled;
+
+    struct VisualizationSubscription {
+        int feeds = 0;
+        int fps = 0;
+        QMetaObject::Connection destroyedConnection;
+    };
+    QHash<QObject*, VisualizationSubscription> m_visualizationSubscribers;
+    int m_spectrumFps = 0;  // Current demand (0 = analysis stopped)
+    std::atomic<bool> m_tapActive{false};  // Mixer DSP only copies into the tap while someone reads it
+
+    // Spectrum analysis off the GUI thread, fed from m_audioTap
+    QThread* m_analysisThread;
+    SpectrumEngine* m_spectrumEngine;
 
     // HTTPS download in worker thread so main thread never blocks (DNS/SSL)
     QThread* m_downloadThread;
     StreamDownloader* m_streamDownloader;
     StreamDownloader* m_preloadDownloader;
-    QByteArray m_streamBuffer;
+    StreamBuffer m_streamBuffer;
     QString m_currentStreamFormat;  // Format from streamUrlReceived (e.g. MP3_320), for debug file name
 
     // Preloading: download the next track before the current one ends
     std::shared_ptr<Track> m_preloadTrack;
     QByteArray m_preloadBuffer;
     QString m_preloadFormat;
-    bool m_preloadReady = false;
+    std::atomic<bool> m_preloadReady{false};
     HSTREAM m_preloadStream;  // Track the preloaded stream handle for gapless playback
     bool m_listenReported = false;
 
+    // Speculative preloading: stream URL + encrypted head of the file, keyed by stream id.
+    // Bounded in count and age (media URLs expire); downloads use a small pool of
+    // low-priority downloaders and never run while the current or preload track downloads.
+    struct SpeculativePreload {
+        std::shared_ptr<Track> track;
+        QString streamId;
+        QString url;
+        QString format;
+        QByteArray head;                         // Encrypted bytes from offset 0
+        StreamDownloader* downloader = nullptr;  // Set while the head is downloading
+        quint64 request = 0;                     // Tags that download's signals
+        bool wanted = true;                      // Cleared when the pointer moves away
+        bool complete = false;                   // Whole file fit into the head
+        QElapsedTimer created;
+    };
+    QList<SpeculativePreload> m_speculativePreloads;  // Oldest first
+    QList<StreamDownloader*> m_speculativeDownloaders;
+    quint64 m_speculativeRequestSerial = 0;
+
     // Progressive streaming state
     HSTREAM m_pushStream = 0;
     QByteArray m_trackKey;
     QByteArray m_chunkRemainder;
     int m_chunkIndex = 0;
-    int m_pushInitialOffset = 0;  // Read cursor into m_streamBuffer for STREAMFILE_BUFFER callback
+    qint64 m_pushInitialOffset = 0;  // Read cursor into m_streamBuffer (file offset - m_streamBufferBase)
     std::atomic<bool> m_progressiveMode{false};
     bool m_progressivePlaybackStarted = false;
     qint64 m_totalBytesReceived = 0;
+    MediaHeaderInfo m_mediaHeader;  // Container header of the current file (decides when to create the stream)
+    QString m_currentStreamUrl;     // Media URL of the current track, for Range re-fetches
+    QString m_streamRequestId;      // Tags the active main download: track id, plus "@offset" for re-fetches
+    qint64 m_streamTotalBytes = 0;  // File size from the response headers (0 = unknown)
+    bool m_streamDownloadCompleted = false;  // End of file reached once (syncs and stream info are set up)
+
+    // Memory-capped streaming for long tracks: m_streamBuffer holds a window of the
+    // file starting at m_streamBufferBase, in fixed-size segments. Segments well
+    // behind the read position are released and the download pauses once far
+    // enough ahead; seeks outside the window re-fetch from the seek index position
+    // with a Range request.
+    bool m_streamCapped = false;
+    qint64 m_streamBufferBase = 0;
+    bool m_streamDownloadPaused = false;
+    double m_pendingSeekSeconds = -1.0;  // Seek waiting for re-fetched data (< 0 = none)
+    qint64 m_pendingSeekByte = 0;
+    // The whole file is never in memory at once: its waveform is analysed range by
+    // range as the data arrives, each range decoded behind the saved file header
+    QByteArray m_streamHeaderBytes;
+    WaveformPyramid m_cappedWaveform;   // Ranges analysed so far
+    qint64 m_cappedAnalysedBytes = 0;   // File offset they reach
+    bool m_cappedAnalysisRunning = false;
+    quint64 m_cappedAnalysisSerial = 0;  // Drops results for an earlier stream
     QElapsedTimer m_downloadTimer;  // For bandwidth estimation
-    QMutex m_bufferMutex;  // Protects m_streamBuffer between main thread and BASS mixing thread
+    QMutex m_bufferMutex;  // Protects m_streamBuffer (+ base, total size) between main thread and BASS mixing thread
     qint64 m_lastWaveformUpdateBytes = 0;  // Track when to trigger next progressive waveform update
 
     // Output mode
-    OutputMode m_outputMode;
-    int m_wasapiDevice;
-    DWORD m_outputSampleRate;
+    std::atomic<OutputMode> m_outputMode{OutputDirectSound};  // Read by outputMode() from any thread
+    std::atomic<int> m_wasapiDevice{-1};                     // Read by wasapiDeviceIndex() from any thread
+    std::atomic<DWORD> m_outputSampleRate;  // Read by outputSampleRate() from any thread
 
-    // Waveform computation (runs on thread pool, generation counter prevents stale results)
-    std::atomic<int> m_waveformGeneration{0};
+    // Track analysis (waveform, levels, loudness, silence) runs on the analysis
+    // executor, keyed by track: a newer job for the track supersedes the previous
+    // one, loadTrack() cancels the old track's. Full results are cached per track
+    // and format, in memory and on disk, so replays never decode for analysis.
+    AnalysisExecutor m_analysisExecutor;
+    AnalysisCache m_analysisCache;
+    bool m_currentAnalysisCached = false;  // Served from the cache: no progressive passes
+    bool m_loudnessNormalization = false;
+    bool m_silenceTrimming = false;
+    HSTREAM m_trimmedLeadStream = 0;  // Streams whose silence was already trimmed
+    HSTREAM m_trimmedTailStream = 0;
     
 
-    // Recursive mutex for thread-safe access to BASS from multiple threads (e.g. waveform worker)
-    // Allows nested locking in setupStreamSyncs() and other methods
-    mutable QRecursiveMutex m_bassMutex;
+    // Locking by concern (BASS itself is thread-safe; these guard our handles and state).
+    // Lock order: m_mixerMutex before m_streamMutex before m_bufferMutex.
+    //  - m_mixerMutex: mixer control -- output start/stop/pause, seeking, mixer creation
+    //  - m_streamMutex: stream lifecycle -- creating, queuing and freeing sources, syncs
+    // Decode-only handles (waveform worker, new streams before they're added) need
+    // neither. Recursive, so nested helpers like setupStreamSyncs() can relock.
+    mutable CountingMutex m_mixerMutex;
+    mutable CountingMutex m_streamMutex;
 
+    // Published copies of the handles for lock-free readers (position, duration, spectrum)
+    std::atomic<DWORD> m_publishedMixer{0};
+    std::atomic<DWORD> m_publishedStream{0};
+    std::atomic<bool> m_publishedPushStream{false};
+    int m_lockStatsTicks = 0;
+
+    // Fed by a DSP on the mixer (reinstalled when the mixer changes): the position
+    // clock and the post-mix audio tap that all visualizations read from
+    PlaybackClock m_playbackClock;
+    AudioTap m_audioTap;
+    HSTREAM m_dspMixer = 0;
+
+    // Lives on the GUI thread (it needs a window handle): parentless while the
+    // engine runs on m_controlThread, updated through queued calls
     class WindowsMediaControls* m_windowsMediaControls;
+
+    QThread* m_controlThread = nullptr;
 };
 
 #endif // AUDIOENGINE_H
@@ -63,7 +63,7 @@ bool AudioEngine::ensureOutputRate(DWORD sourceFreq)
         // If the actual WASAPI rate differs from either source or current, we need to adjust
         if (wasapiInfo.freq != sourceFreq || wasapiInfo.freq != m_outputSampleRate) {
             emit debugLog(QString("[AudioEngine] RATE MISMATCH! Device at %1 Hz, source %2 Hz, mixer %3 Hz")
-                          .arg(wasapiInfo.freq).arg(sourceFreq).arg(m_outputSampleRate));
+                          .arg(wasapiInfo.freq).arg(sourceFreq).arg(m_outputSampleRate.load()));
             // Fall through to reinitialize
         } else {
             // Everything matches - no changes needed
@@ -77,7 +77,11 @@ bool AudioEngine::ensureOutputRate(DWORD sourceFreq)
         return true;
 
     emit debugLog(QString("[AudioEngine] Exclusive mode: switching output rate %1 -> %2 Hz")
-                  .arg(m_outputSampleRate).arg(sourceFreq));
+                  .arg(m_outputSampleRate.load()).arg(sourceFreq));
+
+    // Output teardown and mixer rebuild are mixer control. Callers must not hold
+    // m_streamMutex here (lock order: m_mixerMutex first).
+    QMutexLocker mixerLocker(&m_mixerMutex);
 
     // Stop WASAPI output
     BASS_WASAPI_Stop(TRUE);
@@ -92,6 +96,7 @@ bool AudioEngine::ensureOutputRate(DWORD sourceFreq)
         BASS_StreamFree(m_mixerStream);
         m_mixerStream = 0;
     }
+    publishStreamState();
 
     DWORD wasapiFlags = BASS_WASAPI_EXCLUSIVE;
 
@@ -181,6 +186,7 @@ bool AudioEngine::ensureOutputRate(DWORD sourceFreq)
         m_mixerStream = 0;
         return false;
     }
+    publishStreamState();
 
     // Verify final WASAPI configuration
     if (BASS_WASAPI_GetInfo(&wasapiInfo)) {
@@ -213,12 +219,18 @@ bool AudioEngine::ensureOutputRate(DWORD sourceFreq)
 
 void AudioEngine::setOutputMode(OutputMode mode, int wasapiDevice)
 {
+    if (postToEngineThread([=]() { setOutputMode(mode, wasapiDevice); }))
+        return;
+
     m_outputMode = mode;
     m_wasapiDevice = wasapiDevice;
 }
 
 bool AudioEngine::reinitialize(OutputMode mode, int wasapiDevice)
 {
+    if (QThread::currentThread() != thread())
+        return callOnEngineThread([=]() { return reinitialize(mode, wasapiDevice); });
+
     // Save current state
     auto savedQueue = m_queue;
     int savedIndex = m_currentIndex;
@@ -232,7 +244,7 @@ bool AudioEngine::reinitialize(OutputMode mode, int wasapiDevice)
     PlaybackState savedState = m_state;
 
     emit debugLog(QString("[AudioEngine] reinitialize: %1 -> %2 (device %3)")
-                  .arg(m_outputMode).arg(mode).arg(wasapiDevice));
+                  .arg(m_outputMode.load()).arg(mode).arg(wasapiDevice));
 
     // Full teardown
     shutdown();
@@ -261,6 +273,7 @@ bool AudioEngine::reinitialize(OutputMode mode, int wasapiDevice)
     m_currentIndex = savedIndex;
     m_contextType = savedContextType;
     m_contextId = savedContextId;
+    publishQueueState();
 
     // Reload track if one was playing
     if (savedTrack && savedIndex >= 0 && savedIndex < m_queue.size()) {
@@ -270,6 +283,21 @@ bool AudioEngine::reinitialize(OutputMode mode, int wasapiDevice)
     return true;
 }
 
+AudioEngine::OutputMode AudioEngine::outputMode() const
+{
+    return m_outputMode.load(std::memory_order_relaxed);
+}
+
+int AudioEngine::wasapiDeviceIndex() const
+{
+    return m_wasapiDevice.load(std::memory_order_relaxed);
+}
+
+DWORD AudioEngine::outputSampleRate() const
+{
+    return m_outputSampleRate.load();
+}
+
 QList<AudioEngine::AudioDevice> AudioEngine::enumerateWasapiDevices()
 {
     QList<AudioDevice> devices;
@@ -4,8 +4,6 @@
 #include "windowsmediacontrols.h"
 #include <QThread>
 #include <QTimer>
-#include <QtConcurrent>
-#include <QFutureWatcher>
 #include <QMetaObject>
 
 extern "C" {
@@ -13,12 +11,17 @@ extern "C" {
 #include "basswasapi.h"
 }
 
-// Forward declaration (defined in audioengine_visualization.cpp)
-// Needed for progressive waveform updates during download
-QVector<float> computeWaveformFromBuffer(const QByteArray& data, int numPeaks,
-                                         std::atomic<int>* generationPtr, int currentGeneration,
-                                         QRecursiveMutex* bassMutex,
-                                         double completionRatio = 1.0);
+// Memory-capped streaming: files at least this large keep only a window in memory.
+// Roughly an 8 minute FLAC or a 20 minute MP3_320 -- longer tracks stream flat.
+static constexpr qint64 CAPPED_STREAM_MIN_BYTES = 48 * 1024 * 1024;
+static constexpr qint64 CAPPED_READ_AHEAD_BYTES = 16 * 1024 * 1024;  // Download pauses beyond this...
+static constexpr qint64 CAPPED_RESUME_BYTES = 8 * 1024 * 1024;       // ...and resumes below this
+static constexpr qint64 CAPPED_REWIND_BYTES = 8 * 1024 * 1024;       // Kept behind the read position
+static constexpr qint64 CAPPED_SEGMENT_BYTES = 2 * 1024 * 1024;      // Release granularity
+static constexpr qint64 PRELOAD_MAX_BYTES = 128 * 1024 * 1024;       // Gapless preloads hold the whole file
+static constexpr qint64 REFETCH_LEAD_BYTES = 256 * 1024;             // Re-fetch starts this far before a seek target
+static constexpr qint64 SEEK_READY_BYTES = 65536;                    // Data needed past a seek target
+static constexpr qint64 CIPHER_BLOCK_BYTES = 2048;
 
 // ── BASS FILEPROCS for STREAMFILE_NOBUFFER (progressive streaming) ──
 // NOBUFFER calls pushStreamRead on the calling thread:
@@ -38,6 +41,9 @@ QWORD CALLBACK AudioEngine::pushStreamLength(void* user) {
     if (self->m_progressiveMode.load())
         return 0xFFFFFFFF;  // ~4GB -- BASS won't reach this before real EOF
     QMutexLocker locker(&self->m_bufferMutex);
+    // Memory-capped streams only hold a window of the file
+    if (self->m_streamCapped)
+        return static_cast<QWORD>(qMax(self->m_streamTotalBytes, self->m_streamBufferBase + self->m_streamBuffer.size()));
     return static_cast<QWORD>(self->m_streamBuffer.size());
 }
 
@@ -47,10 +53,10 @@ DWORD CALLBACK AudioEngine::pushStreamRead(void* buffer, DWORD length, void* use
     while (true) {
         {
             QMutexLocker locker(&self->m_bufferMutex);
-            int available = self->m_streamBuffer.size() - self->m_pushInitialOffset;
+            qint64 available = self->m_streamBuffer.size() - self->m_pushInitialOffset;
             if (available > 0) {
-                DWORD toRead = qMin(static_cast<DWORD>(available), length);
-                memcpy(buffer, self->m_streamBuffer.constData() + self->m_pushInitialOffset, toRead);
+                DWORD toRead = static_cast<DWORD>(qMin<qint64>(available, length));
+                self->m_streamBuffer.read(self->m_pushInitialOffset, static_cast<char*>(buffer), toRead);
                 self->m_pushInitialOffset += toRead;
                 return toRead;
             }
@@ -75,21 +81,68 @@ BOOL CALLBACK AudioEngine::pushStreamSeek(QWORD offset, void* user) {
     AudioEngine* self = static_cast<AudioEngine*>(user);
     // Allow seeks within the buffered data on any thread.
     // BASS may seek during creation (format detection) and during decoding
-    // (e.g. MP3 bit reservoir). Since we keep all data in m_streamBuffer,
-    // seeking within it is safe.
+    // (e.g. MP3 bit reservoir). Offsets are file positions: m_streamBuffer
+    // starts at m_streamBufferBase (0 unless memory-capped streaming released
+    // the played region), so seeking within it is safe.
     QMutexLocker locker(&self->m_bufferMutex);
-    if (offset <= static_cast<QWORD>(self->m_streamBuffer.size())) {
-        self->m_pushInitialOffset = static_cast<int>(offset);
+    const QWORD base = static_cast<QWORD>(self->m_streamBufferBase);
+    if (offset >= base && offset <= base + static_cast<QWORD>(self->m_streamBuffer.size())) {
+        self->m_pushInitialOffset = static_cast<qint64>(offset - base);
         return TRUE;
     }
     return FALSE;
 }
 
+double AudioEngine::progressiveCompletionRatio(qint64 bufferedBytes) const
+{
+    // Exact from the seek index (or the file size) when known
+    double total = trackLengthSeconds();
+    double buffered = streamTimeForByte(bufferedBytes);
+    if (total > 0.0 && buffered >= 0.0)
+        return qBound(0.0, buffered / total, 1.0);
+
+    // Otherwise estimate from the nominal byte rate of the stream format
+    double playBps = 40000;
+    if (m_currentStreamFormat.contains("128")) playBps = 16000;
+    else if (m_currentStreamFormat.contains("FLAC", Qt::CaseInsensitive)) playBps = 176000;
+    else if (m_currentStreamFormat.contains("64")) playBps = 8000;
+    double dur = total > 0.0 ? total : 300.0;
+    qint64 estTotal = static_cast<qint64>(playBps * dur);
+    return (estTotal > 0) ? qMin(1.0, (double)bufferedBytes / estTotal) : 1.0;
+}
+
+qint64 AudioEngine::streamByteForTime(double seconds) const
+{
+    qint64 offset = m_mediaHeader.byteForTime(seconds);
+    if (offset >= 0)
+        return offset;
+
+    // No index: assume a constant byte rate over the file size from the response headers
+    double length = trackLengthSeconds();
+    if (m_streamTotalBytes <= 0 || length <= 0.0)
+        return -1;
+    qint64 audioBytes = m_streamTotalBytes - m_mediaHeader.audioStart;
+    return m_mediaHeader.audioStart + static_cast<qint64>(audioBytes * qBound(0.0, seconds / length, 1.0));
+}
+
+double AudioEngine::streamTimeForByte(qint64 offset) const
+{
+    double seconds = m_mediaHeader.timeForByte(offset);
+    if (seconds >= 0.0)
+        return seconds;
+
+    double length = trackLengthSeconds();
+    qint64 audioBytes = m_streamTotalBytes - m_mediaHeader.audioStart;
+    if (audioBytes <= 0 || length <= 0.0)
+        return -1.0;
+    return length * qBound(0.0, static_cast<double>(offset - m_mediaHeader.audioStart) / audioBytes, 1.0);
+}
+
 // ── Progressive streaming handlers ──
 
 void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& trackId)
 {
-    if (!m_currentTrack || m_currentTrack->id() != trackId || !m_progressiveMode)
+    if (!m_currentTrack || trackId != m_streamRequestId || !m_progressiveMode)
         return;
 
     // Prepend leftover bytes from previous chunk
@@ -97,7 +150,7 @@ void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& tra
     m_chunkRemainder.clear();
 
     static const quint8 IV[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
-    static const int BLOCK_SIZE = 2048;
+    static const int BLOCK_SIZE = CIPHER_BLOCK_BYTES;
 
     int offset = 0;
     QByteArray decryptedBatch;
@@ -127,14 +180,31 @@ void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& tra
         // Accumulation phase: buffer data until we have enough to start
         m_streamBuffer.append(decryptedBatch);
 
-        // Need at least 64KB for BASS to parse audio headers.
-        if (m_streamBuffer.size() < 65536)
-            return;
+        // Parse the container header to know where the first audio frame starts.
+        // FLAC metadata and ID3 tags can carry megabytes of cover art before it.
+        if (!m_mediaHeader.complete && m_streamBuffer.size() >= m_mediaHeader.bytesNeeded) {
+            m_mediaHeader = parseMediaHeader(m_streamBuffer.data());
+            if (m_mediaHeader.complete && m_mediaHeader.container != MediaHeaderInfo::Unknown) {
+                emit debugLog(QString("[AudioEngine] Media header parsed: audio starts at byte %1, creating stream at %2 bytes%3%4")
+                              .arg(m_mediaHeader.audioStart).arg(m_mediaHeader.bytesNeeded)
+                              .arg(m_mediaHeader.coverArt.isEmpty() ? "" : QString(", embedded cover %1 KB").arg(m_mediaHeader.coverArt.size() / 1024))
+                              .arg(m_mediaHeader.needsWholeFile ? " (moov after mdat: waiting for whole file)" : ""));
+            }
+        }
+        if (!m_mediaHeader.complete || m_mediaHeader.needsWholeFile)
+            return;  // needsWholeFile: played from memory once the download completes
+
+        if (m_mediaHeader.container != MediaHeaderInfo::Unknown) {
+            if (m_streamBuffer.size() < m_mediaHeader.bytesNeeded)
+                return;
+        } else if (m_streamBuffer.size() < 65536) {
+            return;  // Unrecognized format: need at least 64KB for BASS to parse audio headers
+        }
 
         // Try to create the stream. Reset read cursor so BASS reads from the start.
-        // For formats with large metadata (FLAC with embedded art), BASS may need
-        // more than 64KB to find the first audio frame. In that case, creation fails
-        // with BASS_ERROR_FILEFORM and we keep buffering until the next chunk retries.
+        // With a recognized header this succeeds on the first attempt; otherwise
+        // creation may fail with BASS_ERROR_FILEFORM and we keep buffering until
+        // the next chunk retries.
         m_pushInitialOffset = 0;
         BASS_FILEPROCS pushProcs = { pushStreamClose, pushStreamLength, pushStreamRead, pushStreamSeek };
         HSTREAM stream = BASS_StreamCreateFileUser(
@@ -168,7 +238,7 @@ void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& tra
                 emit debugLog(QString("[AudioEngine] Progressive stream: %1 Hz, %2 ch, format %3")
                               .arg(sci.freq).arg(sci.chans).arg(sci.flags & BASS_SAMPLE_FLOAT ? "float" : "int"));
                 emit debugLog(QString("[AudioEngine] Progressive stream sample rate: %1 Hz, current output: %2 Hz")
-                              .arg(sci.freq).arg(m_outputSampleRate));
+                              .arg(sci.freq).arg(m_outputSampleRate.load()));
                 if (!ensureOutputRate(sci.freq)) {
                     BASS_StreamFree(m_pushStream);
                     m_pushStream = 0;
@@ -200,6 +270,7 @@ void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& tra
         }
 
         m_currentStream = m_pushStream;
+        publishStreamState();
 
         // Restore mixer queue sync
         if (!m_queueSync && m_mixerStream) {
@@ -214,92 +285,73 @@ void AudioEngine::onStreamChunkReady(const QByteArray& chunk, const QString& tra
 
         emit debugLog(QString("[AudioEngine] Progressive playback started (BUFFERPUSH) after %1 bytes")
                       .arg(m_streamBuffer.size()));
-        emit trackChanged(m_currentTrack);
-        if (m_windowsMediaControls && m_currentTrack)
-            m_windowsMediaControls->updateMetadata(
-                m_currentTrack->title(), m_currentTrack->artist(),
-                m_currentTrack->album(), m_currentTrack->albumArt());
+        emit trackChanged(m_currentTrack, m_mediaHeader.coverArt);
+        updateMediaControlsMetadata();
 
         setState(Playing);
         m_positionTimer->start(100);
 
-        // Trigger initial progressive waveform from buffered data
-        {
-            QByteArray wfSnapshot;
-            {
-                QMutexLocker locker(&m_bufferMutex);
-                wfSnapshot = m_streamBuffer;
-            }
-            m_lastWaveformUpdateBytes = wfSnapshot.size();
-            // Estimate completion ratio based on file byte rate
-            double playBps = 40000;
-            if (m_currentStreamFormat.contains("128")) playBps = 16000;
-            else if (m_currentStreamFormat.contains("FLAC", Qt::CaseInsensitive)) playBps = 176000;
-            else if (m_currentStreamFormat.contains("64")) playBps = 8000;
-            int dur = (m_currentTrack && m_currentTrack->duration() > 0) ? m_currentTrack->duration() : 300;
-            qint64 estTotal = static_cast<qint64>(playBps * dur);
-            double ratio = (estTotal > 0) ? qMin(1.0, (double)wfSnapshot.size() / estTotal) : 1.0;
-            int gen = m_waveformGeneration.load();
-            auto *watcher = new QFutureWatcher<QVector<float>>(this);
-            connect(watcher, &QFutureWatcher<QVector<float>>::finished, this,
-                    [this, watcher, gen]() {
-                if (gen == m_waveformGeneration.load()) {
-                    QVector<float> peaks = watcher->result();
-                    if (!peaks.isEmpty())
-                        emit waveformReady(peaks);
+        // Trigger initial progressive waveform from buffered data (unless played before)
+        if (!serveCachedWaveform()) {
+            if (m_streamCapped) {
+                analyzeCappedRange();
+            } else {
+                StreamBuffer buffered;
+                {
+                    QMutexLocker locker(&m_bufferMutex);
+                    buffered = m_streamBuffer;  // Shares the segments, the decoder reads them in place
                 }
-                watcher->deleteLater();
-            });
-            watcher->setFuture(QtConcurrent::run(computeWaveformFromBuffer, wfSnapshot, 500,
-                                                &m_waveformGeneration, gen, &m_bassMutex, ratio));
+                m_lastWaveformUpdateBytes = buffered.size();
+                submitAnalysisJob(m_currentTrack, m_currentStreamFormat, buffered,
+                                  progressiveCompletionRatio(buffered.size()), AnalysisExecutor::Current);
+            }
         }
     } else {
         // Streaming phase: append to buffer (pushStreamRead serves it to BASS on mixer thread)
-        QByteArray wfSnapshot;
+        StreamBuffer buffered;
         bool doWaveform = false;
         {
             QMutexLocker locker(&m_bufferMutex);
             m_streamBuffer.append(decryptedBatch);
 
-            if (m_streamBuffer.size() - m_lastWaveformUpdateBytes >= 100000) {
+            // Memory-capped streams analyse each new range instead (below)
+            if (!m_currentAnalysisCached && !m_streamCapped &&
+                m_streamBuffer.size() - m_lastWaveformUpdateBytes >= 100000) {
                 m_lastWaveformUpdateBytes = m_streamBuffer.size();
-                wfSnapshot = m_streamBuffer;
+                buffered = m_streamBuffer;  // Shares the segments, the decoder reads them in place
                 doWaveform = true;
             }
         }
 
+        // A newer snapshot supersedes the previous partial decode if it's still going
         if (doWaveform) {
-            // Estimate completion ratio for partial waveform
-            double playBps = 40000;
-            if (m_currentStreamFormat.contains("128")) playBps = 16000;
-            else if (m_currentStreamFormat.contains("FLAC", Qt::CaseInsensitive)) playBps = 176000;
-            else if (m_currentStreamFormat.contains("64")) playBps = 8000;
-            int dur = (m_currentTrack && m_currentTrack->duration() > 0) ? m_currentTrack->duration() : 300;
-            qint64 estTotal = static_cast<qint64>(playBps * dur);
-            double ratio = (estTotal > 0) ? qMin(1.0, (double)wfSnapshot.size() / estTotal) : 1.0;
-
-            int gen = m_waveformGeneration.load();
-            auto *watcher = new QFutureWatcher<QVector<float>>(this);
-            connect(watcher, &QFutureWatcher<QVector<float>>::finished, this,
-                    [this, watcher, gen]() {
-                if (gen == m_waveformGeneration.load()) {
-                    QVector<float> peaks = watcher->result();
-                    if (!peaks.isEmpty())
-                        emit waveformReady(peaks);
-                }
-                watcher->deleteLater();
-            });
-            watcher->setFuture(QtConcurrent::run(computeWaveformFromBuffer, wfSnapshot, 500,
-                                                &m_waveformGeneration, gen, &m_bassMutex, ratio));
+            submitAnalysisJob(m_currentTrack, m_currentStreamFormat, buffered,
+                              progressiveCompletionRatio(buffered.size()), AnalysisExecutor::Current);
+        } else if (m_streamCapped) {
+            analyzeCappedRange();
         }
+
+        // A seek into a re-fetched range completes once its data has arrived
+        if (m_pendingSeekSeconds >= 0.0) {
+            const qint64 windowEnd = m_streamBufferBase + m_streamBuffer.size();
+            if (windowEnd >= m_pendingSeekByte + SEEK_READY_BYTES ||
+                (m_streamTotalBytes > 0 && windowEnd >= m_streamTotalBytes)) {
+                completePendingSeek();
+            }
+        }
+        if (m_streamCapped)
+            maintainStreamWindow();
     }
 }
 
 void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, const QString& trackId)
 {
-    if (!m_currentTrack || m_currentTrack->id() != trackId || !m_progressiveMode)
+    if (!m_currentTrack || trackId != m_streamRequestId || !m_progressiveMode)
         return;
 
+    // Bandwidth is free again once this handler is done
+    QMetaObject::invokeMethod(this, &AudioEngine::startSpeculativeDownloads, Qt::QueuedConnection);
+
     if (!errorMessage.isEmpty()) {
         m_progressiveMode.store(false);
         if (errorMessage.contains("cancel", Qt::CaseInsensitive) ||
@@ -313,6 +365,10 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
             setState(Stopped);
             return;
         }
+        completePendingSeek();  // Unpause a source waiting for re-fetched data
+        if (m_streamDownloadCompleted)
+            return;  // Re-fetch of a memory-capped stream: syncs are already set up
+        m_streamDownloadCompleted = true;
         // Download failed but playback is in progress -- treat partial data as complete:
         // append any remainder, re-enable QUEUE mode, set up syncs, update waveform.
         if (!m_chunkRemainder.isEmpty()) {
@@ -343,8 +399,17 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
 
     // Signal EOF: pushStreamRead will return 0 once all buffered data is served
     m_progressiveMode.store(false);
+    completePendingSeek();
 
-    emit debugLog(QString("[AudioEngine] Progressive download complete: %1 bytes total").arg(m_streamBuffer.size()));
+    if (m_streamDownloadCompleted) {
+        // A Range re-fetch of a memory-capped stream reached the end of the file again
+        emit debugLog("[AudioEngine] Re-fetched range complete up to the end of the file");
+        return;
+    }
+    m_streamDownloadCompleted = true;
+
+    emit debugLog(QString("[AudioEngine] Progressive download complete: %1 bytes total")
+                  .arg(m_streamBufferBase + m_streamBuffer.size()));
 
     if (m_progressivePlaybackStarted && m_pushStream) {
         // Re-enable QUEUE mode now that the full file is available.
@@ -359,21 +424,28 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
         // from the estimated ratios used during progressive download
         startWaveformComputation();
     } else {
-        // Small file (< 64KB): never started BUFFERPUSH playback. Use regular memory stream.
+        // Small file (< 64KB) or MP4 with 'moov' at the end: never started BUFFERPUSH
+        // playback. Use regular memory stream.
         if (m_streamBuffer.isEmpty()) {
             emit error("Failed to load track: empty response from server");
             setState(Stopped);
             return;
         }
+        // BASS decodes straight from this memory: keep it as one segment of m_streamBuffer
+        const QByteArray fileData = m_streamBuffer.data();
+        {
+            QMutexLocker bufLock(&m_bufferMutex);
+            m_streamBuffer = fileData;
+        }
+        if (!m_mediaHeader.complete)
+            m_mediaHeader = parseMediaHeader(fileData);
 
-        HSTREAM newStream = createSourceStream(m_streamBuffer);
+        HSTREAM newStream = createSourceStream(fileData);
         if (!newStream) {
             setState(Stopped);
             return;
         }
 
-        QMutexLocker locker(&m_bassMutex);
-
         // Get source stream info and log it
         BASS_CHANNELINFO sci = {};
         if (BASS_ChannelGetInfo(newStream, &sci)) {
@@ -381,9 +453,10 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
                           .arg(sci.freq).arg(sci.chans).arg(sci.flags & BASS_SAMPLE_FLOAT ? "float" : "int"));
 
             // Exclusive mode: switch WASAPI+mixer to match track sample rate
+            // (takes m_mixerMutex, so before m_streamMutex)
             {
                 emit debugLog(QString("[AudioEngine] Small file stream sample rate: %1 Hz, current output: %2 Hz")
-                              .arg(sci.freq).arg(m_outputSampleRate));
+                              .arg(sci.freq).arg(m_outputSampleRate.load()));
                 if (!ensureOutputRate(sci.freq)) {
                     BASS_StreamFree(newStream);
                     setState(Stopped);
@@ -392,6 +465,8 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
             }
         }
 
+        QMutexLocker locker(&m_streamMutex);
+
         if (m_currentStream) {
             if (m_currentEndSync) {
                 BASS_ChannelRemoveSync(m_currentStream, m_currentEndSync);
@@ -415,6 +490,7 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
         }
 
         m_currentStream = newStream;
+        publishStreamState();
         setupStreamSyncs(m_currentStream, &m_currentEndSync, &m_currentNearEndSync);
 
         if (!m_queueSync && m_mixerStream) {
@@ -428,23 +504,251 @@ void AudioEngine::onProgressiveDownloadFinished(const QString& errorMessage, con
         locker.unlock();
         updateStreamInfo(m_currentStream);
 
-        emit trackChanged(m_currentTrack);
-        if (m_windowsMediaControls && m_currentTrack)
-            m_windowsMediaControls->updateMetadata(
-                m_currentTrack->title(), m_currentTrack->artist(),
-                m_currentTrack->album(), m_currentTrack->albumArt());
+        emit trackChanged(m_currentTrack, m_mediaHeader.coverArt);
+        updateMediaControlsMetadata();
 
         play();
     }
 
     m_listenReported = false;
     startWaveformComputation();
+
+    // RepeatOne loops from the buffer at no cost -- queue the repeat right away
+    if (m_repeatMode == RepeatOne && m_gaplessEnabled)
+        preloadNextTrack();
+}
+
+// ── Memory-capped streaming ─────────────────────────────────────────────
+// Long tracks (hour-long mixes, podcasts) would otherwise keep the whole
+// decrypted file in m_streamBuffer. Past CAPPED_STREAM_MIN_BYTES the buffer
+// becomes a window of the file in fixed-size segments: played segments are
+// dropped behind a rewind window (nothing is copied), the download pauses once far enough ahead of the read position, and
+// seeks outside the window re-fetch from the seek index position (Range request,
+// aligned to the cipher block so decryption continues at the right stripe).
+// The waveform is analysed range by range as the segments arrive.
+
+void AudioEngine::onStreamSizeKnown(qint64 totalBytes, const QString& trackId)
+{
+    if (trackId != m_streamRequestId || totalBytes <= 0)
+        return;
+
+    {
+        QMutexLocker bufLock(&m_bufferMutex);
+        m_streamTotalBytes = totalBytes;
+    }
+
+    if (!m_streamCapped && totalBytes >= CAPPED_STREAM_MIN_BYTES) {
+        m_streamCapped = true;
+        {
+            QMutexLocker bufLock(&m_bufferMutex);
+            m_streamBuffer.setSegmentBytes(CAPPED_SEGMENT_BYTES);
+        }
+        emit debugLog(QString("[AudioEngine] Long track (%1 MB): memory-capped streaming (%2 MB read-ahead, %3 MB rewind)")
+                      .arg(totalBytes / (1024 * 1024))
+                      .arg(CAPPED_READ_AHEAD_BYTES / (1024 * 1024))
+                      .arg(CAPPED_REWIND_BYTES / (1024 * 1024)));
+    }
+}
+
+void AudioEngine::maintainStreamWindow()
+{
+    if (!m_streamCapped || !m_progressivePlaybackStarted || m_pendingSeekSeconds >= 0.0)
+        return;
+
+    qint64 readPos;
+    qint64 windowEnd;
+    {
+        QMutexLocker bufLock(&m_bufferMutex);
+        readPos = m_streamBufferBase + m_pushInitialOffset;
+
+        // Release played segments, keeping a rewind window behind the read position.
+        // Whole segments are dropped: the bytes that stay are never moved.
+        const qint64 evict = readPos - CAPPED_REWIND_BYTES - m_streamBufferBase;
+        if (evict >= CAPPED_SEGMENT_BYTES) {
+            const qint64 released = m_streamBuffer.releaseFront(evict);
+            m_streamBufferBase += released;
+            m_pushInitialOffset -= released;
+        }
+        windowEnd = m_streamBufferBase + m_streamBuffer.size();
+    }
+
+    if (!m_progressiveMode.load())
+        return;  // End of file already downloaded
+
+    const qint64 ahead = windowEnd - readPos;
+    if (!m_streamDownloadPaused && ahead > CAPPED_READ_AHEAD_BYTES) {
+        // Bounded read-ahead: stop the download, chunks still in flight are dropped
+        m_streamDownloadPaused = true;
+        m_streamRequestId.clear();
+        m_chunkRemainder.clear();
+        QMetaObject::invokeMethod(m_streamDownloader, "startProgressiveDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+        emit debugLog(QString("[AudioEngine] Read-ahead limit reached, download paused at byte %1").arg(windowEnd));
+    } else if (m_streamDownloadPaused && ahead < CAPPED_RESUME_BYTES) {
+        m_streamDownloadPaused = false;
+        m_chunkRemainder.clear();
+        m_chunkIndex = static_cast<int>(windowEnd / CIPHER_BLOCK_BYTES);
+        m_streamRequestId = m_currentTrack->id() + "@" + QString::number(windowEnd);
+        QMetaObject::invokeMethod(m_streamDownloader, "resumeProgressiveDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_currentStreamUrl), Q_ARG(QString, m_streamRequestId),
+                                  Q_ARG(qint64, windowEnd));
+        emit debugLog(QString("[AudioEngine] Resuming download at byte %1").arg(windowEnd));
+    }
+}
+
+// Ranges start where the last one ended (rounded down to a segment, the overlap
+// merges harmlessly) and wait for a whole segment of new data, except for the
+// tail of the file. One range job at a time; its result starts the next one.
+void AudioEngine::analyzeCappedRange()
+{
+    if (!m_streamCapped || m_cappedAnalysisRunning || m_currentAnalysisCached || !m_currentTrack)
+        return;
+    if (!m_mediaHeader.complete ||
+        (m_mediaHeader.container != MediaHeaderInfo::Flac && m_mediaHeader.container != MediaHeaderInfo::Mpeg))
+        return;  // MP4 can't decode from the middle of 'mdat'
+    const double totalSeconds = trackLengthSeconds();
+    if (totalSeconds <= 0.0)
+        return;
+
+    const bool downloading = m_progressiveMode.load();
+    StreamBuffer range;
+    qint64 rangeStart;
+    qint64 rangeEnd;
+    {
+        QMutexLocker bufLock(&m_bufferMutex);
+        rangeEnd = m_streamBufferBase + m_streamBuffer.size();
+        const qint64 from = qMax(m_cappedAnalysedBytes, m_streamBufferBase);
+        if (rangeEnd <= from || (downloading && rangeEnd - from < CAPPED_SEGMENT_BYTES))
+            return;
+        range = m_streamBuffer;  // Shares the segments
+        rangeStart = m_streamBufferBase + range.releaseFront(from - m_streamBufferBase);
+    }
+
+    // The first range holds the header: keep it for the ranges after it
+    if (rangeStart == 0) {
+        const qint64 headerBytes = qMin(m_mediaHeader.audioStart, range.size());
+        m_streamHeaderBytes.resize(static_cast<int>(headerBytes));
+        range.read(0, m_streamHeaderBytes.data(), headerBytes);
+    } else {
+        range.prepend(m_streamHeaderBytes);
+    }
+
+    const double startSeconds = rangeStart == 0 ? 0.0 : streamTimeForByte(rangeStart);
+    const double endSeconds = (!downloading && m_streamTotalBytes > 0 && rangeEnd >= m_streamTotalBytes)
+        ? totalSeconds : streamTimeForByte(rangeEnd);
+    if (startSeconds < 0.0 || endSeconds <= startSeconds)
+        return;
+
+    m_cappedAnalysisRunning = true;
+    const quint64 serial = m_cappedAnalysisSerial;
+    const QString trackId = m_currentTrack->id();
+    m_analysisExecutor.submit(trackId, AnalysisExecutor::Current,
+                              [this, serial, range, startSeconds, endSeconds, totalSeconds, rangeEnd]
+                              (const AnalysisExecutor::CancellationToken& token) {
+        const TrackAnalysis analysis = analyzeTrackRange(range, startSeconds, endSeconds, totalSeconds,
+                                                         WaveformPyramid::FINEST_BUCKETS, token);
+        // Reported even when cancelled or undecodable, so the next range can start
+        QMetaObject::invokeMethod(this, [this, serial, analysis, rangeEnd]() {
+            if (serial != m_cappedAnalysisSerial)
+                return;
+            m_cappedAnalysisRunning = false;
+            m_cappedAnalysedBytes = qMax(m_cappedAnalysedBytes, rangeEnd);
+            if (analysis.isValid()) {
+                m_cappedWaveform = m_cappedWaveform.merged(analysis.waveform);
+                emit waveformReady(m_cappedWaveform);
+            }
+            analyzeCappedRange();  // Data that arrived meanwhile
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AudioEngine::resetCappedWaveform()
+{
+    ++m_cappedAnalysisSerial;
+    m_streamHeaderBytes.clear();
+    m_cappedWaveform = WaveformPyramid();
+    m_cappedAnalysedBytes = 0;
+    m_cappedAnalysisRunning = false;
+}
+
+bool AudioEngine::refetchStreamForSeek(double targetSeconds)
+{
+    qint64 targetByte = streamByteForTime(targetSeconds);
+    if (targetByte < 0 || !m_pushStream || !m_currentTrack || m_currentStreamUrl.isEmpty())
+        return false;
+
+    qint64 windowStart;
+    qint64 windowEnd;
+    {
+        QMutexLocker bufLock(&m_bufferMutex);
+        windowStart = m_streamBufferBase;
+        windowEnd = m_streamBufferBase + m_streamBuffer.size();
+    }
+    const bool toFileEnd = m_streamTotalBytes > 0 && windowEnd >= m_streamTotalBytes;
+    if (targetByte >= windowStart && (targetByte + SEEK_READY_BYTES <= windowEnd || toFileEnd)) {
+        if (m_pendingSeekSeconds < 0.0)
+            return false;  // In memory: regular seek
+        // A re-fetch is pending but the new target is already there
+        m_pendingSeekSeconds = targetSeconds;
+        completePendingSeek();
+        return true;
+    }
+
+    const qint64 offset = qMax<qint64>(0, targetByte - REFETCH_LEAD_BYTES) / CIPHER_BLOCK_BYTES * CIPHER_BLOCK_BYTES;
+    emit debugLog(QString("[AudioEngine] Seek to %1s is outside the buffered window (bytes %2-%3), re-fetching from byte %4")
+                  .arg(targetSeconds, 0, 'f', 1).arg(windowStart).arg(windowEnd).arg(offset));
+
+    // Keep the mixer from reading the source while its data is replaced
+    BASS_Mixer_ChannelFlags(m_pushStream, BASS_MIXER_CHAN_PAUSE, BASS_MIXER_CHAN_PAUSE);
+
+    m_progressiveMode.store(true);  // Reads wait for data again
+    {
+        QMutexLocker bufLock(&m_bufferMutex);
+        m_streamBuffer.clear();
+        m_streamBufferBase = offset;
+        m_pushInitialOffset = 0;
+    }
+    m_chunkRemainder.clear();
+    m_chunkIndex = static_cast<int>(offset / CIPHER_BLOCK_BYTES);
+    m_streamDownloadPaused = false;
+    m_pendingSeekSeconds = targetSeconds;
+    m_pendingSeekByte = targetByte;
+    m_streamRequestId = m_currentTrack->id() + "@" + QString::number(offset);
+    QMetaObject::invokeMethod(m_streamDownloader, "resumeProgressiveDownload", Qt::QueuedConnection,
+                              Q_ARG(QString, m_currentStreamUrl), Q_ARG(QString, m_streamRequestId),
+                              Q_ARG(qint64, offset));
+    return true;
+}
+
+void AudioEngine::completePendingSeek()
+{
+    if (m_pendingSeekSeconds < 0.0)
+        return;
+
+    const double seconds = m_pendingSeekSeconds;
+    m_pendingSeekSeconds = -1.0;
+
+    QMutexLocker locker(&m_mixerMutex);
+    if (!m_pushStream)
+        return;
+
+    QWORD seekPos = BASS_ChannelSeconds2Bytes(m_pushStream, seconds);
+    if (!BASS_Mixer_ChannelSetPosition(m_pushStream, seekPos, BASS_POS_BYTE | BASS_POS_MIXER_RESET)) {
+        emit debugLog(QString("[AudioEngine] Seek after re-fetch failed: error %1").arg(BASS_ErrorGetCode()));
+    } else {
+        m_playbackClock.publish(seconds);
+        emit debugLog(QString("[AudioEngine] Re-fetched data ready, seeked to %1s").arg(seconds, 0, 'f', 1));
+    }
+    BASS_Mixer_ChannelFlags(m_pushStream, 0, BASS_MIXER_CHAN_PAUSE);
 }
 
 // ── Preloading ──────────────────────────────────────────────────────────
 
 void AudioEngine::preloadNextTrack()
 {
+    if (postToEngineThread([=]() { preloadNextTrack(); }))
+        return;
+
     emit debugLog("[AudioEngine] preloadNextTrack() called - START");
 
     int nextIndex;
@@ -509,6 +813,13 @@ void AudioEngine::preloadNextTrack()
         return;
     }
 
+    // RepeatOne: the plaintext of the current track is already in m_streamBuffer.
+    // Queue a second decode stream over it -- no network traffic, no decryption.
+    if (m_repeatMode == RepeatOne && m_currentTrack && m_currentTrack->id() == nextTrack->id()) {
+        queueRepeatFromBuffer();
+        return;
+    }
+
     emit debugLog("[AudioEngine] Setting preload track...");
     m_preloadTrack  = nextTrack;
     m_preloadReady  = false;
@@ -520,12 +831,22 @@ void AudioEngine::preloadNextTrack()
                  .arg(m_queue.size())
                  .arg(nextTrack->title())
                  .arg(nextTrack->id()));
+    // The one after it as well, so the GUI can prefetch without a queue copy
+    std::shared_ptr<Track> followingTrack;
+    if (m_repeatMode != RepeatOne) {
+        int followingIndex = nextIndex + 1;
+        if (followingIndex >= m_queue.size() && m_repeatMode == RepeatAll)
+            followingIndex = 0;
+        if (followingIndex < m_queue.size() && followingIndex != nextIndex)
+            followingTrack = m_queue[followingIndex];
+    }
+    emit preloadStarted(nextTrack, followingTrack);
 
     if (m_deezerAPI) {
         emit debugLog("[AudioEngine] Calling getStreamUrl on DeezerAPI...");
         QString streamId = nextTrack->isUserUploaded() ? nextTrack->trackToken() : nextTrack->id();
         QString streamFormat = nextTrack->isUserUploaded() ? QStringLiteral("MP3_MISC") : QString();
-        m_deezerAPI->getStreamUrl(streamId, nextTrack->trackToken(), streamFormat);
+        requestStreamUrl(streamId, nextTrack->trackToken(), streamFormat);
         emit debugLog("[AudioEngine] getStreamUrl call completed");
     } else {
         emit debugLog("[AudioEngine] ERROR: DeezerAPI is null!");
@@ -534,11 +855,80 @@ void AudioEngine::preloadNextTrack()
     emit debugLog("[AudioEngine] preloadNextTrack() - END");
 }
 
+bool AudioEngine::queueRepeatFromBuffer()
+{
+    if (m_progressiveMode.load()) {
+        // Buffer still growing; onProgressiveDownloadFinished() queues the repeat
+        emit debugLog("[AudioEngine] RepeatOne: download in progress, repeat will be queued when complete");
+        return false;
+    }
+    if (m_streamCapped) {
+        emit debugLog("[AudioEngine] RepeatOne: memory-capped stream holds only part of the file, no gapless repeat");
+        return false;
+    }
+    if (m_streamBuffer.isEmpty() || !m_mixerStream) {
+        emit debugLog("[AudioEngine] RepeatOne: no buffered data to repeat");
+        return false;
+    }
+
+    // Shared snapshot (copy-on-write): both decode streams read the same immutable bytes.
+    // m_preloadBuffer keeps the data alive when handleStreamDequeued() swaps buffers.
+    QByteArray snapshot = m_streamBuffer.data();
+    HSTREAM repeatStream = createSourceStream(snapshot);
+    if (!repeatStream)
+        return false;
+
+    QMutexLocker locker(&m_streamMutex);
+    BOOL ok = BASS_Mixer_StreamAddChannel(
+        m_mixerStream,
+        repeatStream,
+        BASS_MIXER_CHAN_NORAMPIN | BASS_STREAM_AUTOFREE
+    );
+    if (!ok) {
+        int err = BASS_ErrorGetCode();
+        emit debugLog(QString("[AudioEngine] RepeatOne: failed to queue repeat stream: %1").arg(err));
+        BASS_StreamFree(repeatStream);
+        return false;
+    }
+
+    m_preloadTrack = m_currentTrack;
+    m_preloadBuffer = snapshot;
+    m_preloadFormat = m_currentStreamFormat;
+    m_preloadReady = true;
+    m_preloadStream = repeatStream;
+    locker.unlock();
+
+    applyLoudnessGain(m_preloadStream, m_preloadTrack);
+    applyGapTrimming();
+
+    emit debugLog(QString("[AudioEngine] RepeatOne: repeat queued from memory (%1 bytes, no download)")
+                  .arg(snapshot.size()));
+    return true;
+}
+
 // ── Preload progressive download handlers ───────────────────────────────
 // Preload downloads accumulate raw (encrypted) chunks, then decrypt the
 // full buffer on completion -- same end result as the old startDownload
 // path but using the progressive download mechanism.
 
+void AudioEngine::onPreloadSizeKnown(qint64 totalBytes, const QString& trackId)
+{
+    if (!m_preloadTrack || totalBytes < PRELOAD_MAX_BYTES)
+        return;
+    const QString preloadId = m_preloadTrack->isUserUploaded() ? m_preloadTrack->trackToken() : m_preloadTrack->id();
+    if (preloadId != trackId)
+        return;
+
+    // A preload holds the whole file in memory: leave long tracks to memory-capped streaming
+    emit debugLog(QString("[AudioEngine] Preload skipped: '%1' is %2 MB, it will stream memory-capped")
+                  .arg(m_preloadTrack->title()).arg(totalBytes / (1024 * 1024)));
+    QMetaObject::invokeMethod(m_preloadDownloader, "startProgressiveDownload", Qt::QueuedConnection,
+                              Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+    m_preloadTrack.reset();
+    m_preloadBuffer.clear();
+    m_preloadReady = false;
+}
+
 void AudioEngine::onPreloadChunkReady(const QByteArray& chunk, const QString& trackId)
 {
     auto matchPreloadId = [&]() {
@@ -558,6 +948,8 @@ void AudioEngine::onPreloadDownloadFinished(const QString& errorMessage, const Q
     };
     if (!matchPreloadId()) return;
 
+    QMetaObject::invokeMethod(this, &AudioEngine::startSpeculativeDownloads, Qt::QueuedConnection);
+
     if (!errorMessage.isEmpty()) {
         if (errorMessage.contains("cancel", Qt::CaseInsensitive) ||
             errorMessage.contains("abort", Qt::CaseInsensitive)) {
@@ -589,7 +981,7 @@ void AudioEngine::onPreloadDownloadFinished(const QString& errorMessage, const Q
     // With BASS_MIXER_QUEUE flag, it will wait until current finishes
     HSTREAM nextStream = createSourceStream(m_preloadBuffer);
     if (nextStream) {
-        QMutexLocker locker(&m_bassMutex);
+        QMutexLocker locker(&m_streamMutex);
 
         if (!m_mixerStream) {
             emit debugLog("[AudioEngine] ERROR: Cannot queue - mixer stream is null");
@@ -615,6 +1007,16 @@ void AudioEngine::onPreloadDownloadFinished(const QString& errorMessage, const Q
         locker.unlock();
 
         emit debugLog(QString("[AudioEngine] Next track ready for gapless playback: %1").arg(trackTitle));
+
+        // Normalization and gap trimming need the next track's analysis before it starts
+        TrackAnalysis cached;
+        if (m_preloadTrack && m_analysisCache.find(m_preloadTrack->id(), m_preloadFormat, &cached)) {
+            publishAnalysis(m_preloadTrack->id(), m_preloadFormat, cached);
+            applyLoudnessGain(m_preloadStream, m_preloadTrack);
+            applyGapTrimming();
+        } else {
+            submitAnalysisJob(m_preloadTrack, m_preloadFormat, m_preloadBuffer, 1.0, AnalysisExecutor::Preload);
+        }
     } else {
         emit debugLog("[AudioEngine] ERROR: createSourceStream returned null for preload");
     }
@@ -1,36 +1,152 @@
 #include "audioengine.h"
 #include "streamdownloader.h"
 #include <QMetaObject>
+#include <algorithm>
 
 // ── Queue Management Methods ────────────────────────────────────────────
 
+QList<int> AudioEngine::validQueueRows(const QList<int>& indices) const
+{
+    QList<int> rows;
+    rows.reserve(indices.size());
+    for (int index : indices) {
+        if (index >= 0 && index < m_queue.size())
+            rows.append(index);
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
+
+int AudioEngine::nextQueueIndex() const
+{
+    if (m_currentIndex < 0 || m_currentIndex >= m_queue.size())
+        return -1;
+    if (m_repeatMode == RepeatOne)
+        return m_currentIndex;
+    if (m_currentIndex + 1 < m_queue.size())
+        return m_currentIndex + 1;
+    return m_repeatMode == RepeatAll ? 0 : -1;
+}
+
+void AudioEngine::beginQueueEdit()
+{
+    ++m_queueEditDepth;
+}
+
+void AudioEngine::endQueueEdit()
+{
+    if (--m_queueEditDepth > 0)
+        return;
+
+    // One preload check for the whole edit: the preloaded track must still be the
+    // one that plays next, or the mixer would play it after rows moved around it
+    if (m_preloadTrack) {
+        const int next = nextQueueIndex();
+        if (m_queueEditDropsPreload || next < 0 || m_queue[next]->id() != m_preloadTrack->id()) {
+            emit debugLog(QString("[AudioEngine] Queue edit: '%1' no longer plays next, dropping its preload")
+                          .arg(m_preloadTrack->title()));
+            discardPreload();
+            // Only replaced when it was due already (the near-end sync fired)
+            if (next >= 0 && m_currentStream)
+                preloadNextTrack();
+        }
+    }
+    m_queueEditDropsPreload = false;
+
+    publishQueueChanges();
+}
+
+void AudioEngine::recordQueueChange(QueueChange change, int queueSize)
+{
+    change.queueSize = queueSize >= 0 ? queueSize : m_queue.size();
+    m_pendingQueueChanges.append(change);
+}
+
+void AudioEngine::publishQueueChanges()
+{
+    if (!m_pendingQueueChanges.isEmpty()) {
+        QueueChangeSet changes;
+        changes.swap(m_pendingQueueChanges);
+        emit queueEdited(changes);
+    }
+    publishQueueState();
+    emit queueChanged();
+}
+
 void AudioEngine::setQueue(const QList<std::shared_ptr<Track>>& tracks)
 {
+    if (postToEngineThread([=]() { setQueue(tracks); }))
+        return;
+
     m_queue = tracks;
     m_currentIndex = -1;
     m_contextType.clear();
     m_contextId.clear();
-    emit queueChanged();
+    recordQueueChange(QueueChange::reset(m_queue));
+    publishQueueChanges();
 }
 
 void AudioEngine::setQueue(const QList<std::shared_ptr<Track>>& tracks, const QString& contextType, const QString& contextId)
 {
+    if (postToEngineThread([=]() { setQueue(tracks, contextType, contextId); }))
+        return;
+
     m_queue = tracks;
     m_currentIndex = -1;
     m_contextType = contextType;
     m_contextId = contextId;
-    emit queueChanged();
+    recordQueueChange(QueueChange::reset(m_queue));
+    publishQueueChanges();
+}
+
+void AudioEngine::publishQueueState()
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    m_publishedQueue = m_queue;
+    m_publishedCurrentIndex = m_currentIndex;
+    m_publishedContextType = m_contextType;
+    m_publishedContextId = m_contextId;
 }
 
 QList<std::shared_ptr<Track>> AudioEngine::queue() const
 {
-    return m_queue;
+    QMutexLocker locker(&m_queueStateMutex);
+    return m_publishedQueue;
+}
+
+std::shared_ptr<Track> AudioEngine::currentTrack() const
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    return m_publishedCurrentTrack;
+}
+
+int AudioEngine::currentIndex() const
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    return m_publishedCurrentIndex;
+}
+
+QString AudioEngine::contextType() const
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    return m_publishedContextType;
+}
+
+QString AudioEngine::contextId() const
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    return m_publishedContextId;
 }
 
 void AudioEngine::playAtIndex(int index)
 {
+    if (postToEngineThread([=]() { playAtIndex(index); }))
+        return;
+
     if (index >= 0 && index < m_queue.size()) {
         m_currentIndex = index;
+        publishQueueState();  // Before trackChanged goes out
         loadTrack(m_queue[m_currentIndex]);
         emit queueChanged();
     }
@@ -38,6 +154,9 @@ void AudioEngine::playAtIndex(int index)
 
 void AudioEngine::next()
 {
+    if (postToEngineThread([=]() { next(); }))
+        return;
+
     if (m_queue.isEmpty()) {
         stop();
         return;
@@ -62,12 +181,16 @@ void AudioEngine::next()
 
     // Load next track
     m_currentIndex = nextIndex;
+    publishQueueState();  // Before trackChanged goes out
     loadTrack(m_queue[m_currentIndex]);
     emit queueChanged();
 }
 
 void AudioEngine::previous()
 {
+    if (postToEngineThread([=]() { previous(); }))
+        return;
+
     if (m_queue.isEmpty()) return;
 
     int prevIndex = m_currentIndex - 1;
@@ -81,187 +204,189 @@ void AudioEngine::previous()
     }
 
     m_currentIndex = prevIndex;
+    publishQueueState();  // Before trackChanged goes out
     loadTrack(m_queue[m_currentIndex]);
     emit queueChanged();
 }
 
 void AudioEngine::removeFromQueue(int index)
 {
-    if (index < 0 || index >= m_queue.size())
+    removeFromQueue(QList<int>{index});
+}
+
+void AudioEngine::removeFromQueue(const QList<int>& indices)
+{
+    if (postToEngineThread([=]() { removeFromQueue(indices); }))
         return;
 
-    // Case 1: Removing track before current -> decrement m_currentIndex
-    if (index < m_currentIndex) {
-        m_queue.removeAt(index);
-        m_currentIndex--;
-        emit queueChanged();
+    const QList<int> rows = validQueueRows(indices);
+    if (rows.isEmpty())
         return;
-    }
 
-    // Case 2: Removing current track -> stop and restart playback
-    if (index == m_currentIndex) {
-        bool wasPlaying = (m_state == Playing);
+    beginQueueEdit();
+
+    // The preload always holds the next row: endQueueEdit() re-checks it after every edit
+    const int preloadRow = m_preloadTrack ? nextQueueIndex() : -1;
+    const bool removingCurrent = std::binary_search(rows.begin(), rows.end(), m_currentIndex);
+    const bool wasPlaying = (m_state == Playing);
+    if (removingCurrent)
         stop();  // Clean up BASS streams
-        m_queue.removeAt(index);
 
-        // Try to continue playback with next track
-        if (!m_queue.isEmpty() && m_currentIndex < m_queue.size()) {
+    // Row changes as contiguous runs, last run first so every range is valid when applied
+    int size = m_queue.size();
+    for (int end = rows.size() - 1; end >= 0;) {
+        int begin = end;
+        while (begin > 0 && rows[begin - 1] == rows[begin] - 1)
+            --begin;
+        size -= end - begin + 1;
+        recordQueueChange(QueueChange::removed(rows[begin], rows[end]), size);
+        end = begin - 1;
+    }
+
+    // One compaction pass: survivors slide down over the removed rows
+    int write = 0;
+    int removedBeforeCurrent = 0;
+    for (int read = 0, next = 0; read < m_queue.size(); ++read) {
+        if (next < rows.size() && rows[next] == read) {
+            ++next;
+            if (read < m_currentIndex)
+                ++removedBeforeCurrent;
+            if (read == preloadRow)
+                m_queueEditDropsPreload = true;
+            continue;
+        }
+        if (write != read)
+            m_queue[write] = std::move(m_queue[read]);
+        ++write;
+    }
+    m_queue.erase(m_queue.begin() + write, m_queue.end());
+    m_currentIndex -= removedBeforeCurrent;
+
+    // Removing the current track: continue with the one that took its place
+    if (removingCurrent) {
+        if (m_currentIndex >= 0 && m_currentIndex < m_queue.size()) {
+            publishQueueState();  // Before trackChanged goes out
             loadTrack(m_queue[m_currentIndex]);
             if (wasPlaying)
                 play();
         } else {
             m_currentIndex = -1;
-            m_currentTrack.reset();
+            setCurrentTrack(nullptr);
         }
-
-        emit queueChanged();
-        return;
     }
 
-    // Case 3: Removing track after current
-    // Check if it's the preloaded track
-    if (m_preloadTrack && m_queue[index]->id() == m_preloadTrack->id()) {
-        // Cancel preload
-        m_preloadTrack.reset();
-        m_preloadReady = false;
-        m_preloadBuffer.clear();
-        m_preloadStream = 0;
-        // Cancel worker download (empty URL cancels)
-        QMetaObject::invokeMethod(m_preloadDownloader, "startProgressiveDownload",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(QString, QString()),
-                                  Q_ARG(QString, QString()));
-    }
+    endQueueEdit();
+}
 
-    m_queue.removeAt(index);
-    emit queueChanged();
+void AudioEngine::moveInQueue(int fromIndex, int toIndex)
+{
+    moveInQueue(QList<int>{fromIndex}, toIndex);
 }
 
-void AudioEngine::removeFromQueue(const QList<int>& indices)
+void AudioEngine::moveInQueue(const QList<int>& indices, int toIndex)
 {
-    if (indices.isEmpty())
+    if (postToEngineThread([=]() { moveInQueue(indices, toIndex); }))
         return;
 
-    // Sort descending to preserve indices during removal
-    QList<int> sorted = indices;
-    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
-
-    bool removingCurrent = sorted.contains(m_currentIndex);
+    const QList<int> rows = validQueueRows(indices);
+    if (rows.isEmpty() || toIndex < 0)
+        return;
 
-    if (removingCurrent) {
-        bool wasPlaying = (m_state == Playing);
-        stop();
+    const int count = rows.size();
+    toIndex = qMin(toIndex, m_queue.size() - count);
+    const bool contiguous = (rows.last() - rows.first() + 1 == count);
+    if (contiguous && rows.first() == toIndex)
+        return;
 
-        for (int index : sorted) {
-            if (index >= 0 && index < m_queue.size()) {
-                m_queue.removeAt(index);
-                if (index < m_currentIndex)
-                    m_currentIndex--;
-            }
-        }
+    beginQueueEdit();
 
-        // Resume playback if possible
-        if (!m_queue.isEmpty() && m_currentIndex >= 0 &&
-            m_currentIndex < m_queue.size()) {
-            loadTrack(m_queue[m_currentIndex]);
-            if (wasPlaying)
-                play();
-        } else {
-            m_currentIndex = -1;
-            m_currentTrack.reset();
-        }
+    // Row changes. Rows ahead of their target go first, from the last one, then
+    // rows behind it from the first: each move leaves the pending rows in place.
+    const int size = m_queue.size();
+    if (contiguous) {
+        recordQueueChange(QueueChange::moved(rows.first(), rows.last(), toIndex), size);
     } else {
-        for (int index : sorted) {
-            if (index >= 0 && index < m_queue.size()) {
-                // Check if removing preloaded track
-                if (m_preloadTrack && m_queue[index]->id() == m_preloadTrack->id()) {
-                    m_preloadTrack.reset();
-                    m_preloadReady = false;
-                    m_preloadBuffer.clear();
-                    m_preloadStream = 0;
-                    QMetaObject::invokeMethod(m_preloadDownloader, "startProgressiveDownload",
-                                              Qt::QueuedConnection,
-                                              Q_ARG(QString, QString()),
-                                              Q_ARG(QString, QString()));
-                }
-
-                m_queue.removeAt(index);
-                if (index < m_currentIndex)
-                    m_currentIndex--;
-            }
+        for (int i = count - 1; i >= 0; --i) {
+            if (rows[i] < toIndex + i)
+                recordQueueChange(QueueChange::moved(rows[i], rows[i], toIndex + i), size);
+        }
+        for (int i = 0; i < count; ++i) {
+            if (rows[i] > toIndex + i)
+                recordQueueChange(QueueChange::moved(rows[i], rows[i], toIndex + i), size);
         }
     }
 
-    emit queueChanged();
-}
-
-void AudioEngine::moveInQueue(int fromIndex, int toIndex)
-{
-    if (fromIndex < 0 || fromIndex >= m_queue.size() ||
-        toIndex < 0 || toIndex >= m_queue.size() ||
-        fromIndex == toIndex)
-        return;
-
-    auto track = m_queue[fromIndex];
-    m_queue.removeAt(fromIndex);
-    m_queue.insert(toIndex, track);
-
-    // Adjust m_currentIndex
-    if (fromIndex == m_currentIndex) {
-        m_currentIndex = toIndex;
-    } else if (fromIndex < m_currentIndex && toIndex >= m_currentIndex) {
-        m_currentIndex--;
-    } else if (fromIndex > m_currentIndex && toIndex <= m_currentIndex) {
-        m_currentIndex++;
+    // Rebuild in one pass: the other tracks in order, the moved block spliced in at toIndex
+    QList<std::shared_ptr<Track>> block;
+    QList<std::shared_ptr<Track>> rest;
+    block.reserve(count);
+    rest.reserve(size - count);
+    int newCurrentIndex = -1;
+    for (int read = 0, next = 0; read < size; ++read) {
+        if (next < count && rows[next] == read) {
+            if (read == m_currentIndex)
+                newCurrentIndex = toIndex + next;
+            block.append(m_queue[read]);
+            ++next;
+        } else {
+            if (read == m_currentIndex)
+                newCurrentIndex = rest.size() < toIndex ? rest.size() : rest.size() + count;
+            rest.append(m_queue[read]);
+        }
     }
+    rest.insert(toIndex, count, nullptr);
+    std::copy(block.cbegin(), block.cend(), rest.begin() + toIndex);
+    m_queue = rest;
+    m_currentIndex = newCurrentIndex;
 
-    emit queueChanged();
+    endQueueEdit();
 }
 
 void AudioEngine::addToQueue(std::shared_ptr<Track> track, int position)
 {
     if (!track)
         return;
-
-    if (position < 0 || position >= m_queue.size()) {
-        m_queue.append(track);
-    } else {
-        m_queue.insert(position, track);
-        if (position <= m_currentIndex)
-            m_currentIndex++;
-    }
-
-    emit queueChanged();
+    addToQueue(QList<std::shared_ptr<Track>>{track}, position);
 }
 
 void AudioEngine::addToQueue(const QList<std::shared_ptr<Track>>& tracks, int position)
 {
+    if (postToEngineThread([=]() { addToQueue(tracks, position); }))
+        return;
+
     if (tracks.isEmpty())
         return;
 
+    beginQueueEdit();
+
     if (position < 0 || position >= m_queue.size()) {
         // Append all tracks to the end
+        position = m_queue.size();
         m_queue.append(tracks);
     } else {
-        // Insert all tracks at position
-        for (int i = 0; i < tracks.size(); ++i) {
-            m_queue.insert(position + i, tracks[i]);
-        }
+        // Insert all tracks at position, shifting the tail once
+        m_queue.insert(position, tracks.size(), nullptr);
+        std::copy(tracks.cbegin(), tracks.cend(), m_queue.begin() + position);
         if (position <= m_currentIndex)
             m_currentIndex += tracks.size();
     }
+    recordQueueChange(QueueChange::inserted(position, tracks));
 
-    emit queueChanged();
+    endQueueEdit();
 }
 
 void AudioEngine::clearQueue()
 {
+    if (postToEngineThread([=]() { clearQueue(); }))
+        return;
+
     if (m_queue.isEmpty())
         return;
 
     stop();  // Clean up BASS streams
     m_queue.clear();
     m_currentIndex = -1;
-    m_currentTrack.reset();
-    emit queueChanged();
+    setCurrentTrack(nullptr);
+    recordQueueChange(QueueChange::reset(m_queue));
+    publishQueueChanges();
 }
@@ -0,0 +1,258 @@
+#include "audioengine.h"
+#include "deezerapi.h"
+#include "streamdownloader.h"
+#include <QMetaObject>
+
+// ── Speculative Preloading ──────────────────────────────────────────────
+// Hovering or selecting a row resolves the stream URL and downloads the head
+// of the file in the background. When the track is then played, loadTrack()
+// feeds the head into the progressive pipeline and resumes the download
+// right after it, so playback starts without a URL round-trip.
+
+static constexpr qint64 SPECULATIVE_HEAD_BYTES = 256 * 1024;  // Multiple of the 2048-byte cipher block
+static constexpr int MAX_SPECULATIVE_PRELOADS = 4;
+static constexpr qint64 SPECULATIVE_TTL_MS = 10 * 60 * 1000;  // Media URLs expire
+
+// User-uploaded tracks use the token as stream identifier
+static QString speculativeStreamId(const std::shared_ptr<Track>& track)
+{
+    return track->isUserUploaded() ? track->trackToken() : track->id();
+}
+
+// Head downloads pass "<streamId>#<request>" as their track id. A late signal of
+// an aborted download then can't be mistaken for a newer one of the same track.
+static QString downloadTag(const QString& streamId, quint64 request)
+{
+    return streamId + QLatin1Char('#') + QString::number(request);
+}
+
+static quint64 parseDownloadTag(const QString& tag, QString* streamId)
+{
+    const int hash = tag.lastIndexOf(QLatin1Char('#'));
+    if (hash < 0)
+        return 0;
+    *streamId = tag.left(hash);
+    return tag.mid(hash + 1).toULongLong();
+}
+
+void AudioEngine::speculativePreload(std::shared_ptr<Track> track)
+{
+    if (postToEngineThread([=]() { speculativePreload(track); }))
+        return;
+
+    if (!m_initialized || !m_deezerAPI || !track || track->trackToken().isEmpty())
+        return;
+
+    // Nothing to gain for tracks that are already playing, loading or preloaded
+    if ((m_currentTrack && m_currentTrack->id() == track->id()) ||
+        (m_pendingTrack && m_pendingTrack->id() == track->id()) ||
+        (m_preloadTrack && m_preloadTrack->id() == track->id())) {
+        return;
+    }
+
+    for (int i = m_speculativePreloads.size() - 1; i >= 0; --i) {
+        if (m_speculativePreloads[i].created.hasExpired(SPECULATIVE_TTL_MS))
+            dropSpeculativePreload(i);
+    }
+
+    const QString streamId = speculativeStreamId(track);
+    int index = findSpeculativePreload(streamId);
+    if (index >= 0) {
+        // Known track: want it again and make it the most recent entry
+        SpeculativePreload entry = m_speculativePreloads.takeAt(index);
+        entry.wanted = true;
+        m_speculativePreloads.append(entry);
+        startSpeculativeDownloads();
+        return;
+    }
+
+    while (m_speculativePreloads.size() >= MAX_SPECULATIVE_PRELOADS)
+        dropSpeculativePreload(0);
+
+    SpeculativePreload entry;
+    entry.track = track;
+    entry.streamId = streamId;
+    entry.created.start();
+    m_speculativePreloads.append(entry);
+
+    emit debugLog(QString("[AudioEngine] Speculative preload: resolving URL for '%1'").arg(track->title()));
+
+    // getStreamUrl may answer synchronously (preview fallback), so the entry must exist first
+    QString streamFormat = track->isUserUploaded() ? QStringLiteral("MP3_MISC") : QString();
+    requestStreamUrl(streamId, track->trackToken(), streamFormat);
+}
+
+void AudioEngine::cancelSpeculativePreload(std::shared_ptr<Track> track)
+{
+    if (postToEngineThread([=]() { cancelSpeculativePreload(track); }))
+        return;
+
+    if (!track)
+        return;
+
+    int index = findSpeculativePreload(speculativeStreamId(track));
+    if (index < 0)
+        return;
+
+    SpeculativePreload& entry = m_speculativePreloads[index];
+    entry.wanted = false;
+    if (entry.downloader) {
+        // Abort the download but keep the URL and whatever arrived -- any prefix still helps
+        QMetaObject::invokeMethod(entry.downloader, "startProgressiveDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+        entry.downloader = nullptr;
+        startSpeculativeDownloads();
+    }
+}
+
+int AudioEngine::findSpeculativePreload(const QString& streamId) const
+{
+    for (int i = 0; i < m_speculativePreloads.size(); ++i) {
+        if (m_speculativePreloads[i].streamId == streamId)
+            return i;
+    }
+    return -1;
+}
+
+void AudioEngine::dropSpeculativePreload(int index)
+{
+    if (index < 0 || index >= m_speculativePreloads.size())
+        return;
+
+    StreamDownloader* downloader = m_speculativePreloads[index].downloader;
+    m_speculativePreloads.removeAt(index);
+    if (downloader) {
+        QMetaObject::invokeMethod(downloader, "startProgressiveDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+        startSpeculativeDownloads();
+    }
+}
+
+bool AudioEngine::takeSpeculativePreload(const std::shared_ptr<Track>& track, SpeculativePreload* out)
+{
+    int index = findSpeculativePreload(speculativeStreamId(track));
+    if (index < 0)
+        return false;
+
+    SpeculativePreload entry = m_speculativePreloads[index];
+    dropSpeculativePreload(index);  // Aborts a head download still in flight; the prefix stays valid
+    if (entry.url.isEmpty() || entry.created.hasExpired(SPECULATIVE_TTL_MS))
+        return false;
+
+    entry.downloader = nullptr;
+    *out = entry;
+    return true;
+}
+
+bool AudioEngine::handleSpeculativeUrl(const QString& streamId, const QString& url, const QString& format)
+{
+    int index = findSpeculativePreload(streamId);
+    if (index < 0)
+        return false;
+
+    if (url.contains("cdns-preview", Qt::CaseInsensitive) || !url.startsWith("https://", Qt::CaseInsensitive)) {
+        dropSpeculativePreload(index);
+        return true;
+    }
+
+    SpeculativePreload& entry = m_speculativePreloads[index];
+    if (!entry.url.isEmpty())
+        return true;  // Duplicate answer (e.g. the track was also requested for playback)
+
+    entry.url = url;
+    entry.format = format;
+    entry.created.restart();  // URL lifetime starts now
+    emit debugLog(QString("[AudioEngine] Speculative preload: URL resolved for '%1' (format: %2)")
+                  .arg(entry.track->title()).arg(format));
+
+    startSpeculativeDownloads();
+    return true;
+}
+
+void AudioEngine::startSpeculativeDownloads()
+{
+    // Never compete for bandwidth with the current track or the gapless preload
+    if (m_progressiveMode.load() || (m_preloadTrack && !m_preloadReady))
+        return;
+
+    // Most recent requests first
+    for (int i = m_speculativePreloads.size() - 1; i >= 0; --i) {
+        SpeculativePreload& entry = m_speculativePreloads[i];
+        if (!entry.wanted || entry.downloader || entry.url.isEmpty() || entry.complete ||
+            entry.head.size() >= SPECULATIVE_HEAD_BYTES) {
+            continue;
+        }
+        if (m_currentTrack && m_currentTrack->id() == entry.track->id())
+            continue;
+
+        StreamDownloader* idle = nullptr;
+        for (StreamDownloader* downloader : m_speculativeDownloaders) {
+            bool busy = false;
+            for (const SpeculativePreload& other : m_speculativePreloads) {
+                if (other.downloader == downloader) {
+                    busy = true;
+                    break;
+                }
+            }
+            if (!busy) {
+                idle = downloader;
+                break;
+            }
+        }
+        if (!idle)
+            return;  // Concurrency budget exhausted
+
+        entry.downloader = idle;
+        entry.request = ++m_speculativeRequestSerial;
+        QMetaObject::invokeMethod(idle, "startHeadDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, entry.url), Q_ARG(QString, downloadTag(entry.streamId, entry.request)),
+                                  Q_ARG(qint64, entry.head.size()), Q_ARG(qint64, SPECULATIVE_HEAD_BYTES));
+    }
+}
+
+int AudioEngine::findSpeculativeDownload(const QString& tag) const
+{
+    QString streamId;
+    const quint64 request = parseDownloadTag(tag, &streamId);
+    const int index = findSpeculativePreload(streamId);
+    if (index < 0 || request == 0 || m_speculativePreloads[index].request != request ||
+        !m_speculativePreloads[index].downloader) {
+        return -1;
+    }
+    return index;
+}
+
+void AudioEngine::onSpeculativeChunkReady(const QByteArray& chunk, const QString& trackId)
+{
+    // Chunks of an aborted head download may still be queued: only accept the running request
+    int index = findSpeculativeDownload(trackId);
+    if (index < 0)
+        return;
+
+    m_speculativePreloads[index].head.append(chunk);
+}
+
+void AudioEngine::onSpeculativeDownloadFinished(const QString& errorMessage, const QString& trackId)
+{
+    // An aborted request still reports back (as cancelled): it must not end a newer one
+    int index = findSpeculativeDownload(trackId);
+    if (index < 0)
+        return;
+
+    SpeculativePreload& entry = m_speculativePreloads[index];
+    entry.downloader = nullptr;
+
+    if (!errorMessage.isEmpty()) {
+        // The URL may have expired or been refused -- forget the entry rather than retrying
+        emit debugLog("[AudioEngine] Speculative download failed: " + errorMessage);
+        dropSpeculativePreload(index);
+    } else {
+        entry.complete = entry.head.size() < SPECULATIVE_HEAD_BYTES;
+        emit debugLog(QString("[AudioEngine] Speculative head ready for '%1': %2 KB%3")
+                      .arg(entry.track->title())
+                      .arg(entry.head.size() / 1024)
+                      .arg(entry.complete ? " (whole file)" : ""));
+    }
+
+    startSpeculativeDownloads();
+}
@@ -11,8 +11,20 @@ extern "C" {
 
 // ── Track Loading ───────────────────────────────────────────────────────
 
+void AudioEngine::setCurrentTrack(std::shared_ptr<Track> track)
+{
+    m_currentTrack = track;
+
+    // currentTrack() reads the published copy from other threads
+    QMutexLocker locker(&m_queueStateMutex);
+    m_publishedCurrentTrack = std::move(track);
+}
+
 void AudioEngine::loadTrack(std::shared_ptr<Track> track)
 {
+    if (postToEngineThread([=]() { loadTrack(track); }))
+        return;
+
     if (!m_initialized || !track) {
         return;
     }
@@ -27,34 +39,46 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
         return;
     }
 
+    // Replaying the track that is already fully in memory (RepeatOne, restart):
+    // reuse the plaintext buffer instead of downloading and decrypting it again
+    if (m_currentTrack && m_currentTrack->id() == track->id() && !m_progressiveMode.load()
+        && !m_streamBuffer.isEmpty() && !m_streamCapped
+        && !(m_preloadReady && m_preloadTrack && m_preloadTrack->id() == track->id())) {
+        discardPreload();  // A queued next track would keep playing from the replaced buffer
+        m_preloadTrack = track;
+        m_preloadBuffer = m_streamBuffer.data();  // Shared (copy-on-write), not copied
+        m_preloadFormat = m_currentStreamFormat;
+        m_preloadReady = true;
+    }
+
     setState(Loading);
     destroyStream();
     m_listenReported = false;
-    ++m_waveformGeneration;
-    emit waveformReady(QVector<float>());
+    if (m_currentTrack)
+        m_analysisExecutor.cancel(m_currentTrack->id());
+    emit waveformReady(WaveformPyramid());
 
-    m_currentTrack = track;
+    setCurrentTrack(track);
 
     // If the next track was preloaded, use the already-decrypted data directly
     if (m_preloadReady && m_preloadTrack && m_preloadTrack->id() == track->id()) {
         emit debugLog("[AudioEngine] Using preloaded data for: " + track->title());
         m_currentStreamFormat = m_preloadFormat;
         m_streamBuffer = m_preloadBuffer;  // Already decrypted -- do NOT decrypt again
+        m_mediaHeader = parseMediaHeader(m_preloadBuffer);
         m_preloadTrack.reset();
         m_preloadReady = false;
         m_preloadBuffer.clear();
         m_preloadStream = 0;
 
-        HSTREAM newStream = createSourceStream(m_streamBuffer);
+        HSTREAM newStream = createSourceStream(m_streamBuffer.data());
         if (!newStream) {
             setState(Stopped);
             return;
         }
 
-        {
-            QMutexLocker locker(&m_bassMutex);
-
-        // Get source stream info and log it
+        // Get source stream info and log it. The rate switch takes m_mixerMutex,
+        // so it runs before m_streamMutex.
         BASS_CHANNELINFO sci = {};
         if (BASS_ChannelGetInfo(newStream, &sci)) {
             emit debugLog(QString("[AudioEngine] Preloaded track: %1 Hz, %2 channels, format %3")
@@ -67,6 +91,9 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
             }
         }
 
+        {
+            QMutexLocker locker(&m_streamMutex);
+
         emit debugLog(QString("[AudioEngine] Adding preloaded stream %1 to mixer").arg(newStream));
         BOOL ok = BASS_Mixer_StreamAddChannel(m_mixerStream, newStream, 0);
         if (!ok) {
@@ -77,6 +104,7 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
             return;
         }
         m_currentStream = newStream;
+        publishStreamState();
             setupStreamSyncs(m_currentStream, &m_currentEndSync, &m_currentNearEndSync);
 
             // Restore mixer queue sync (removed by destroyStream)
@@ -91,7 +119,7 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
 
         // Stream info
         {
-            QMutexLocker locker(&m_bassMutex);
+            QMutexLocker locker(&m_streamMutex);
             BASS_CHANNELINFO ci = {};
             if (BASS_ChannelGetInfo(m_currentStream, &ci)) {
                 int bitrate = 0;
@@ -107,11 +135,14 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
             }
         }
 
-        startWaveformComputation();
-        emit trackChanged(m_currentTrack);
-        if (m_windowsMediaControls && m_currentTrack)
-            m_windowsMediaControls->updateMetadata(m_currentTrack->title(), m_currentTrack->artist(), m_currentTrack->album(), m_currentTrack->albumArt());
+        emit trackChanged(m_currentTrack, m_mediaHeader.coverArt);
+        startWaveformComputation();  // Served from the analysis cache on replays
+        updateMediaControlsMetadata();
         play();
+
+        // RepeatOne loops from the buffer at no cost -- queue the repeat right away
+        if (m_repeatMode == RepeatOne && m_gaplessEnabled)
+            preloadNextTrack();
         return;
     }
 
@@ -121,11 +152,22 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
     m_preloadBuffer.clear();
     m_preloadStream = 0;  // Clear preloaded stream reference
 
+    // A speculative preload (hover/selection) may already hold the URL and the head of the file
+    SpeculativePreload speculative;
+    if (takeSpeculativePreload(track, &speculative)) {
+        emit debugLog(QString("[AudioEngine] Using speculative preload for: %1 (%2 KB prefetched)")
+                      .arg(track->title()).arg(speculative.head.size() / 1024));
+        m_pendingTrack.reset();
+        m_currentStreamFormat = speculative.format;
+        startLoadingUrl(speculative.url, speculative.head, speculative.complete);
+        return;
+    }
+
     m_pendingTrack = track;
     // User-uploaded tracks use the token as identifier and MP3_MISC format
     QString streamId = track->isUserUploaded() ? track->trackToken() : track->id();
     QString streamFormat = track->isUserUploaded() ? QStringLiteral("MP3_MISC") : QString();
-    m_deezerAPI->getStreamUrl(streamId, track->trackToken(), streamFormat);
+    requestStreamUrl(streamId, track->trackToken(), streamFormat);
 
     // DON'T preload here - preload happens when we're near the end of current track
     // The near-end sync (setupStreamSyncs) will trigger preloadNextTrack() at the right time
@@ -133,6 +175,9 @@ void AudioEngine::loadTrack(std::shared_ptr<Track> track)
 
 void AudioEngine::onStreamUrlReceived(const QString& trackId, const QString& url, const QString& format)
 {
+    if (postToEngineThread([=]() { onStreamUrlReceived(trackId, url, format); }))
+        return;
+
     // -- Handle preload URL --
     // User-uploaded tracks use the token as stream identifier
     auto matchStreamId = [](const std::shared_ptr<Track>& t, const QString& id) {
@@ -160,6 +205,7 @@ void AudioEngine::onStreamUrlReceived(const QString& trackId, const QString& url
 
     // -- Normal path for pending track --
     if (!matchStreamId(m_pendingTrack, trackId)) {
+        handleSpeculativeUrl(trackId, url, format);
         return;
     }
     if (url.contains("cdns-preview", Qt::CaseInsensitive)) {
@@ -168,14 +214,14 @@ void AudioEngine::onStreamUrlReceived(const QString& trackId, const QString& url
         setState(Stopped);
         return;
     }
-    m_currentTrack = m_pendingTrack;
+    setCurrentTrack(m_pendingTrack);
     m_pendingTrack.reset();
     m_currentStreamFormat = format;
     emit debugLog(QString("[AudioEngine] Full stream URL received (format: %1)").arg(format));
     startLoadingUrl(url);
 }
 
-void AudioEngine::startLoadingUrl(const QString& url)
+void AudioEngine::startLoadingUrl(const QString& url, const QByteArray& prefetchedHead, bool prefetchComplete)
 {
     if (url.isEmpty()) {
         emit error("No stream URL available");
@@ -191,7 +237,20 @@ void AudioEngine::startLoadingUrl(const QString& url)
         m_chunkRemainder.clear();
         m_chunkIndex = 0;
         m_totalBytesReceived = 0;
-        m_streamBuffer.clear();
+        {
+            QMutexLocker bufLock(&m_bufferMutex);
+            m_streamBuffer = StreamBuffer();  // Single segment until the file turns out long
+            m_streamBufferBase = 0;
+            m_streamTotalBytes = 0;
+        }
+        m_mediaHeader = MediaHeaderInfo();
+        m_currentStreamUrl = url;
+        m_streamRequestId = trackId;
+        m_streamDownloadCompleted = false;
+        m_streamCapped = false;
+        resetCappedWaveform();
+        m_streamDownloadPaused = false;
+        m_pendingSeekSeconds = -1.0;
         m_downloadTimer.start();
 
         m_trackKey = DeezerAPI::computeTrackKey(trackId);
@@ -206,6 +265,23 @@ void AudioEngine::startLoadingUrl(const QString& url)
         m_pushInitialOffset = 0;
         m_lastWaveformUpdateBytes = 0;
 
+        // Speculatively prefetched head: feed it straight into the pipeline and
+        // resume the download right after it (Range request)
+        if (!prefetchedHead.isEmpty()) {
+            onStreamChunkReady(prefetchedHead, trackId);
+            if (prefetchComplete) {
+                onProgressiveDownloadFinished(QString(), trackId);
+                return;
+            }
+            if (!m_progressiveMode)
+                return;  // Stream creation failed while consuming the head
+            emit debugLog(QString("[AudioEngine] Resuming progressive download at byte %1...").arg(prefetchedHead.size()));
+            QMetaObject::invokeMethod(m_streamDownloader, "resumeProgressiveDownload", Qt::QueuedConnection,
+                                      Q_ARG(QString, url), Q_ARG(QString, trackId),
+                                      Q_ARG(qint64, prefetchedHead.size()));
+            return;
+        }
+
         // Start progressive download on worker thread
         emit debugLog("[AudioEngine] Starting progressive download...");
         QMetaObject::invokeMethod(m_streamDownloader, "startProgressiveDownload", Qt::QueuedConnection,
@@ -216,7 +292,8 @@ void AudioEngine::startLoadingUrl(const QString& url)
         setState(Stopped);
         return;
     }
-    emit trackChanged(m_currentTrack);
+    emit trackChanged(m_currentTrack, m_mediaHeader.coverArt);
+    serveCachedWaveform();
     play();
 }
 
@@ -246,7 +323,7 @@ bool AudioEngine::createStream(const QString& url)
 
     // Create stream from URL with DECODE flag (required for mixer)
     {
-        QMutexLocker locker(&m_bassMutex);
+        QMutexLocker locker(&m_streamMutex);
         m_currentStream = BASS_StreamCreateURL(
             url.toUtf8().constData(),
             0,
@@ -254,6 +331,7 @@ bool AudioEngine::createStream(const QString& url)
             nullptr,
             nullptr
         );
+        publishStreamState();
     }
 
     if (!m_currentStream) {
@@ -283,8 +361,8 @@ HSTREAM AudioEngine::createSourceStream(const QByteArray& data)
 
     // Create decode stream (not for direct playback, will be added to mixer)
     // Let BASS auto-detect the format from the audio data
-    // The mixer (created with BASS_SAMPLE_FLOAT) will handle the conversion
-    QMutexLocker locker(&m_bassMutex);
+    // The mixer (created with BASS_SAMPLE_FLOAT) will handle the conversion.
+    // A new handle is private to the caller until it's added: no lock needed.
     HSTREAM stream = BASS_StreamCreateFile(
         TRUE,
         data.constData(),
@@ -306,16 +384,17 @@ HSTREAM AudioEngine::createSourceStream(const QByteArray& data)
 
 void AudioEngine::setupStreamSyncs(HSTREAM stream, HSYNC* endSyncPtr, HSYNC* nearEndSyncPtr)
 {
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_streamMutex);
     if (!stream) return;
 
     QWORD length = BASS_ChannelGetLength(stream, BASS_POS_BYTE);
     double lengthSeconds = (length != (QWORD)-1) ? BASS_ChannelBytes2Seconds(stream, length) : 0.0;
 
-    // Progressive push streams have a fake large length -- always use track metadata
+    // Progressive push streams have a fake large length -- use the seek index / track metadata
     if (m_pushStream != 0 || lengthSeconds <= 0.0) {
-        if (m_currentTrack && m_currentTrack->duration() > 0) {
-            lengthSeconds = m_currentTrack->duration();
+        double indexedSeconds = trackLengthSeconds();
+        if (indexedSeconds > 0.0) {
+            lengthSeconds = indexedSeconds;
             length = BASS_ChannelSeconds2Bytes(stream, lengthSeconds);
         }
     }
@@ -371,7 +450,7 @@ void AudioEngine::setupStreamSyncs(HSTREAM stream, HSYNC* endSyncPtr, HSYNC* nea
 
 void AudioEngine::addStreamToMixer(const QByteArray& data)
 {
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_streamMutex);
 
     // Create decode stream
     HSTREAM stream = createSourceStream(data);
@@ -396,6 +475,7 @@ void AudioEngine::addStreamToMixer(const QByteArray& data)
 
     // Update current stream for position tracking
     m_currentStream = stream;
+    publishStreamState();
 
     // Update stream info
     locker.unlock();
@@ -407,8 +487,7 @@ void AudioEngine::updateStreamInfo(HSTREAM stream)
 {
     if (!stream) return;
 
-    QMutexLocker locker(&m_bassMutex);
-
+    // Read-only BASS queries on a handle: BASS is thread-safe, no lock needed
     BASS_CHANNELINFO ci = {};
     if (BASS_ChannelGetInfo(stream, &ci)) {
         int bitrate = 0;
@@ -433,14 +512,16 @@ void AudioEngine::updateStreamInfo(HSTREAM stream)
 
 void AudioEngine::destroyStream()
 {
-    // Signal the blocking read callback to stop BEFORE locking m_bassMutex.
-    // pushStreamRead blocks on m_bufferMutex (not m_bassMutex), so setting
-    // this atomic flag lets it return EOF without touching m_bassMutex.
-    // This prevents deadlock: destroyStream holds m_bassMutex -> BASS_ChannelStop
+    // Signal the blocking read callback to stop BEFORE locking.
+    // pushStreamRead blocks on m_bufferMutex (not the engine locks), so setting
+    // this atomic flag lets it return EOF without touching them.
+    // This prevents deadlock: destroyStream holds m_mixerMutex -> BASS_ChannelStop
     // waits for mixer thread -> mixer thread in pushStreamRead checks atomic -> exits.
     m_progressiveMode.store(false);
 
-    QMutexLocker locker(&m_bassMutex);
+    // Stops the output (mixer control) and frees the sources (stream lifecycle)
+    QMutexLocker mixerLocker(&m_mixerMutex);
+    QMutexLocker locker(&m_streamMutex);
 
     // Remove queue sync BEFORE stopping, so dequeuing sources won't fire stale callbacks
     if (m_queueSync && m_mixerStream) {
@@ -482,9 +563,14 @@ void AudioEngine::destroyStream()
     m_currentStream = 0;
     m_preloadStream = 0;
     m_pushStream = 0;
+    publishStreamState();
+    m_playbackClock.publish(0.0);
+    m_playbackClock.setLengthSeconds(0.0);
     {
         QMutexLocker bufLock(&m_bufferMutex);
-        m_streamBuffer.clear();
+        m_streamBuffer = StreamBuffer();
+        m_streamBufferBase = 0;
+        m_streamTotalBytes = 0;
     }
 
     // Restore QUEUE mode if it was disabled for progressive streaming
@@ -499,6 +585,14 @@ void AudioEngine::destroyStream()
     m_pushInitialOffset = 0;
     m_lastWaveformUpdateBytes = 0;
     m_trackKey.clear();
+    m_mediaHeader = MediaHeaderInfo();
+    m_currentStreamUrl.clear();
+    m_streamRequestId.clear();
+    m_streamDownloadCompleted = false;
+    m_streamCapped = false;
+    resetCappedWaveform();
+    m_streamDownloadPaused = false;
+    m_pendingSeekSeconds = -1.0;
     m_totalBytesReceived = 0;
 
     // Cancel worker downloads (empty URL aborts any in-progress download)
@@ -546,7 +640,7 @@ void AudioEngine::handleStreamDequeued(DWORD streamHandle, int generation)
     emit debugLog(QString("[AudioEngine] Stream %1 dequeued from mixer (current: %2)")
                  .arg(streamHandle).arg(m_currentStream));
 
-    QMutexLocker locker(&m_bassMutex);
+    QMutexLocker locker(&m_streamMutex);
 
     // BASS_SYNC_MIXER_QUEUE fires when a source STARTS playing (dequeued from waiting queue).
     // If it matches m_currentStream, this is the initial activation -- ignore it.
@@ -583,11 +677,32 @@ void AudioEngine::handleStreamDequeued(DWORD streamHandle, int generation)
     if (oldStream) {
         BASS_Mixer_ChannelRemove(oldStream);
         BASS_StreamFree(oldStream);
+        if (oldStream == m_pushStream)
+            m_pushStream = 0;  // The progressive stream is gone, position/length come from the new stream
     }
+    publishStreamState();
 
     // Now safe to replace the buffer -- no BASS stream references the old data.
     m_streamBuffer = m_preloadBuffer;
+    m_mediaHeader = parseMediaHeader(m_preloadBuffer);
     m_preloadBuffer.clear();
+    m_currentStreamFormat = m_preloadFormat;
+
+    // The new track is entirely in memory: leave memory-capped streaming of the old one
+    m_streamBufferBase = 0;
+    m_streamTotalBytes = 0;
+    m_streamCapped = false;
+    resetCappedWaveform();
+    m_streamDownloadPaused = false;
+    m_streamDownloadCompleted = true;
+    m_pendingSeekSeconds = -1.0;
+    m_streamRequestId.clear();
+    m_currentStreamUrl.clear();
+    if (m_progressiveMode.exchange(false)) {
+        // A Range re-fetch of the old track was still running
+        QMetaObject::invokeMethod(m_streamDownloader, "startProgressiveDownload", Qt::QueuedConnection,
+                                  Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+    }
 
     // Set up syncs on the new current stream (preloaded streams don't have them)
     m_currentEndSync = 0;
@@ -603,7 +718,7 @@ void AudioEngine::handleStreamDequeued(DWORD streamHandle, int generation)
 
     if (m_currentIndex < queueSize) {
         nextTrack = m_queue[m_currentIndex];
-        m_currentTrack = nextTrack;
+        setCurrentTrack(nextTrack);
 
         emit debugLog(QString("[AudioEngine] Next track set to: %1 (index %2/%3)")
                      .arg(nextTrack ? nextTrack->title() : "Unknown")
@@ -615,6 +730,7 @@ void AudioEngine::handleStreamDequeued(DWORD streamHandle, int generation)
 
     // IMPORTANT: Unlock BEFORE emitting signals to avoid deadlocks
     locker.unlock();
+    publishQueueState();
 
     if (nextTrack) {
         emit debugLog(QString("[AudioEngine] About to emit trackChanged signal for track: %1 (duration: %2s)")
@@ -622,15 +738,18 @@ void AudioEngine::handleStreamDequeued(DWORD streamHandle, int generation)
                      .arg(nextTrack->duration()));
 
         // Emit signals to update UI
-        emit trackChanged(nextTrack);
+        emit trackChanged(nextTrack, m_mediaHeader.coverArt);
 
         emit debugLog(QString("[AudioEngine] trackChanged signal emitted"));
 
+        // Usually analysed while preloaded, so this is a cache hit
+        startWaveformComputation();
+
         // Preload next track
         preloadNextTrack();
     } else {
         emit debugLog("[AudioEngine] Reached end of queue");
-        m_currentTrack.reset();
-        emit trackChanged(nullptr);
+        setCurrentTrack(nullptr);
+        emit trackChanged(nullptr, QByteArray());
     }
 }
@@ -1,166 +1,300 @@
 #include "audioengine.h"
 #include "deezerapi.h"
+#include "spectrumengine.h"
 #include <QTimer>
-#include <QtConcurrent>
-#include <QFutureWatcher>
+#include <cmath>
 
 extern "C" {
 #include "bassmix.h"
 #include "basswasapi.h"
 }
 
-// ── Waveform computation (runs on thread-pool, never blocks the UI) ─────────
+// ── Track Analysis (runs on the analysis executor, never blocks the UI) ──
 
-// Thread-safe free function: takes a copy of the audio buffer (QByteArray COW)
-// and returns normalised peak amplitudes. Only uses its own BASS decode handle.
-// Aborts if currentGeneration != *generationPtr
-QVector<float> computeWaveformFromBuffer(const QByteArray& data, int numPeaks,
-                                               std::atomic<int>* generationPtr, int currentGeneration,
-                                               QRecursiveMutex* bassMutex,
-                                               double completionRatio = 1.0)
+static constexpr double NORMALIZATION_TARGET_LUFS = -14.0;
+static constexpr DWORD NORMALIZATION_SLIDE_MS = 500;  // Gain found mid-track fades in
+static constexpr double MAX_TRIM_SECONDS = 10.0;      // Longer silences are part of the track
+
+void AudioEngine::startWaveformComputation()
 {
-    QVector<float> peaks;
-    if (data.isEmpty() || numPeaks <= 0)
-        return peaks;
-
-    HSTREAM decode = 0;
-    {
-        QMutexLocker locker(bassMutex);
-        decode = BASS_StreamCreateFile(
-            TRUE,
-            data.constData(),
-            0,
-            static_cast<QWORD>(data.size()),
-            BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT
-        );
+    if (m_streamBuffer.isEmpty() || !m_currentTrack)
+        return;
+
+    // Analysed before (this session or on disk): no second decode
+    TrackAnalysis cached;
+    if (m_analysisCache.find(m_currentTrack->id(), m_currentStreamFormat, &cached)) {
+        publishAnalysis(m_currentTrack->id(), m_currentStreamFormat, cached);
+        emit waveformReady(cached.waveform);
+        applyLoudnessGain(m_currentStream, m_currentTrack);
+        applyGapTrimming();
+        return;
     }
-    if (!decode)
-        return peaks;
-
-    QWORD totalBytes = BASS_ChannelGetLength(decode, BASS_POS_BYTE);
-    if (totalBytes == 0 || totalBytes == static_cast<QWORD>(-1)) {
-        QMutexLocker locker(bassMutex);
-        BASS_StreamFree(decode);
-        return peaks;
+    if (m_streamCapped) {
+        analyzeCappedRange();  // Only a window of the file is in memory: its last ranges complete the waveform
+        return;
     }
 
-    // For partial waveform (progressive download), only fill the first portion of peaks
-    int filledCount = (completionRatio >= 1.0)
-        ? numPeaks
-        : qBound(1, static_cast<int>(numPeaks * completionRatio), numPeaks);
-
-    peaks.resize(numPeaks);
-    peaks.fill(0.0f);
-    const QWORD bytesPerPeak = totalBytes / qMax(1, filledCount);
-
-    static constexpr int BUF_SAMPLES = 8192;
-    float buffer[BUF_SAMPLES];
-
-    for (int i = 0; i < filledCount; ++i) {
-        float sum = 0.0f;
-        int count = 0;
-        QWORD remainingSegmentBytes = bytesPerPeak;
-
-        while (remainingSegmentBytes > 0) {
-            // Early abort check: if generation changed, user skipped to a new track
-            if (generationPtr && generationPtr->load() != currentGeneration) {
-                QMutexLocker locker(bassMutex);
-                BASS_StreamFree(decode);
-                return QVector<float>();
-            }
+    // The segments are implicitly shared: the worker keeps cheap references and
+    // reads them in place. If loadTrack() clears m_streamBuffer before the worker
+    // reads, its copy stays valid - no data race.
+    submitAnalysisJob(m_currentTrack, m_currentStreamFormat, m_streamBuffer, 1.0, AnalysisExecutor::Current);
+}
 
-            DWORD toRead = static_cast<DWORD>(
-                qMin(static_cast<QWORD>(BUF_SAMPLES * sizeof(float)), remainingSegmentBytes));
+// Called right after trackChanged: a track analysed before gets its full
+// waveform before any audio is decoded, and the partial progressive passes
+// are skipped for it.
+bool AudioEngine::serveCachedWaveform()
+{
+    m_currentAnalysisCached = false;
+    if (!m_currentTrack)
+        return false;
+
+    TrackAnalysis cached;
+    if (!m_analysisCache.find(m_currentTrack->id(), m_currentStreamFormat, &cached))
+        return false;
+
+    m_currentAnalysisCached = true;
+    publishAnalysis(m_currentTrack->id(), m_currentStreamFormat, cached);
+    emit waveformReady(cached.waveform);
+    return true;
+}
 
-            DWORD bytesRead = 0;
-            {
-                QMutexLocker locker(bassMutex);
-                bytesRead = BASS_ChannelGetData(decode, buffer, toRead);
+void AudioEngine::submitAnalysisJob(const std::shared_ptr<Track>& track, const QString& format,
+                                    const StreamBuffer& data, double completionRatio,
+                                    AnalysisExecutor::Priority priority)
+{
+    if (!track)
+        return;
+
+    const QString trackId = track->id();
+    m_analysisExecutor.submit(trackId, priority,
+                              [this, trackId, format, data, completionRatio](const AnalysisExecutor::CancellationToken& token) {
+        TrackAnalysis analysis = analyzeTrack(data, WaveformPyramid::FINEST_BUCKETS, token, completionRatio);
+        if (!analysis.isValid() || token.isCancelled())
+            return;
+
+        // The file write stays on the worker; the engine thread only updates memory
+        if (analysis.complete)
+            m_analysisCache.writeToDisk(trackId, format, analysis);
+
+        QMetaObject::invokeMethod(this, [this, trackId, format, analysis, token]() {
+            // Still cancelled if the track changed while the result was queued. A
+            // complete result is kept anyway: it may replace a remembered cache miss.
+            if (token.isCancelled()) {
+                if (analysis.complete)
+                    m_analysisCache.insert(trackId, format, analysis);
+                return;
             }
+            handleTrackAnalysis(trackId, format, analysis);
+        }, Qt::QueuedConnection);
+    });
+}
 
-            if (bytesRead == static_cast<DWORD>(-1) || bytesRead == 0)
-                break; // error, end-of-stream, or no data
+void AudioEngine::handleTrackAnalysis(const QString& trackId, const QString& format,
+                                      const TrackAnalysis& analysis)
+{
+    const bool isCurrent = m_currentTrack && m_currentTrack->id() == trackId;
+    if (isCurrent)
+        emit waveformReady(analysis.waveform);
+    if (!analysis.complete)
+        return;
 
-            int samples = static_cast<int>(bytesRead / sizeof(float));
-            for (int s = 0; s < samples; ++s) {
-                sum += qAbs(buffer[s]);
-            }
-            count += samples;
-            remainingSegmentBytes -= bytesRead;
-        }
-        peaks[i] = (count > 0) ? (sum / count) : 0.0f;
-    }
+    m_analysisCache.insert(trackId, format, analysis);
+    publishAnalysis(trackId, format, analysis);
 
-    {
-        QMutexLocker locker(bassMutex);
-        BASS_StreamFree(decode);
-    }
+    auto toDb = [](float linear) { return linear > 0.0f ? 20.0 * std::log10(linear) : -100.0; };
+    emit debugLog(QString("[AudioEngine] Analysis %1: peak %2 dBFS, RMS %3 dBFS, %4 LUFS, silence %5 s / %6 s")
+                  .arg(trackId)
+                  .arg(toDb(analysis.peak), 0, 'f', 1).arg(toDb(analysis.rms), 0, 'f', 1)
+                  .arg(analysis.loudnessLufs, 0, 'f', 1)
+                  .arg(analysis.leadingSilenceSeconds, 0, 'f', 2).arg(analysis.trailingSilenceSeconds, 0, 'f', 2));
 
-    // Normalise peaks to 0.0 - 1.0
-    float maxPeak = 0.0f;
-    for (float p : peaks)
-        if (p > maxPeak) maxPeak = p;
-
-    if (maxPeak > 0.0f) {
-        for (float& p : peaks) {
-            p /= maxPeak;
-            // Apply a power transform to increase visual dynamic range.
-            // pow(p, 1.5) makes quiet parts smaller and loud parts stand out,
-            // avoiding the "blocky" look on compressed modern tracks.
-            p = std::pow(p, 1.5f);
-        }
+    if (isCurrent)
+        applyLoudnessGain(m_currentStream, m_currentTrack);
+    if (m_preloadTrack && m_preloadTrack->id() == trackId)
+        applyLoudnessGain(m_preloadStream, m_preloadTrack);
+    applyGapTrimming();
+
+    emit trackAnalysisReady(trackId, format);
+}
+
+// Keeps the analyses of the current and preloaded tracks for trackAnalysis();
+// entries for any other track are dropped
+void AudioEngine::publishAnalysis(const QString& trackId, const QString& format,
+                                  const TrackAnalysis& analysis)
+{
+    const QString currentId = m_currentTrack ? m_currentTrack->id() : QString();
+    const QString preloadId = m_preloadTrack ? m_preloadTrack->id() : QString();
+
+    QMutexLocker locker(&m_queueStateMutex);
+    m_publishedAnalyses.removeIf([&](const PublishedAnalysis& entry) {
+        return (entry.trackId == trackId && entry.format == format) ||
+               (entry.trackId != currentId && entry.trackId != preloadId);
+    });
+    m_publishedAnalyses.append({trackId, format, analysis});
+}
+
+TrackAnalysis AudioEngine::trackAnalysis(const QString& trackId, const QString& format) const
+{
+    QMutexLocker locker(&m_queueStateMutex);
+    for (const PublishedAnalysis& entry : m_publishedAnalyses) {
+        if (entry.trackId == trackId && entry.format == format)
+            return entry.analysis;
     }
+    return TrackAnalysis();
+}
 
-    return peaks;
+// Format of the stream a track is playing or queued in (analyses are per format)
+QString AudioEngine::streamFormat(HSTREAM stream) const
+{
+    return stream && stream == m_preloadStream ? m_preloadFormat : m_currentStreamFormat;
 }
 
-void AudioEngine::startWaveformComputation()
+void AudioEngine::setLoudnessNormalization(bool enabled)
 {
-    if (m_streamBuffer.isEmpty())
+    if (postToEngineThread([this, enabled]() { setLoudnessNormalization(enabled); }))
         return;
 
-    const int generation = m_waveformGeneration.load();
-    // QByteArray is copy-on-write: the worker keeps a cheap reference to the
-    // buffer.  If loadTrack() clears m_streamBuffer before the worker reads,
-    // the COW copy detaches safely - no data race.
-    QByteArray bufferSnapshot = m_streamBuffer;
-
-    auto *watcher = new QFutureWatcher<QVector<float>>(this);
-    connect(watcher, &QFutureWatcher<QVector<float>>::finished, this,
-            [this, watcher, generation]() {
-        // Only accept the result if no newer track has been loaded since we started
-        if (generation == m_waveformGeneration.load()) {
-            QVector<float> peaks = watcher->result();
-            if (!peaks.isEmpty()) {
-                emit waveformReady(peaks);
-                emit debugLog(QString("[AudioEngine] Waveform computed: %1 peaks").arg(peaks.size()));
-            }
+    m_loudnessNormalization = enabled;
+    applyLoudnessGain(m_currentStream, m_currentTrack);
+    applyLoudnessGain(m_preloadStream, m_preloadTrack);
+}
+
+void AudioEngine::setSilenceTrimming(bool enabled)
+{
+    if (postToEngineThread([this, enabled]() { setSilenceTrimming(enabled); }))
+        return;
+
+    m_silenceTrimming = enabled;
+    applyGapTrimming();
+}
+
+// Per-source volume in the mixer (the user volume stays on the mixer itself).
+// The playing stream slides to the new gain; a queued one just takes it.
+void AudioEngine::applyLoudnessGain(HSTREAM stream, const std::shared_ptr<Track>& track)
+{
+    if (!stream || !track)
+        return;
+
+    float gain = 1.0f;
+    TrackAnalysis cached;
+    if (m_loudnessNormalization && m_analysisCache.find(track->id(), streamFormat(stream), &cached))
+        gain = cached.normalizationGain(NORMALIZATION_TARGET_LUFS);
+
+    QMutexLocker locker(&m_streamMutex);
+    if (stream == m_currentStream)
+        BASS_ChannelSlideAttribute(stream, BASS_ATTRIB_VOL, gain, NORMALIZATION_SLIDE_MS);
+    else
+        BASS_ChannelSetAttribute(stream, BASS_ATTRIB_VOL, gain);
+}
+
+// Gapless transitions skip the silence between tracks: the queued stream starts
+// at its first audible sample and the current one ends after its last. Each
+// side is applied once its analysis is known (cached or just computed).
+void AudioEngine::applyGapTrimming()
+{
+    if (!m_silenceTrimming || !m_gaplessEnabled)
+        return;
+
+    if (!m_preloadTrack || !m_currentTrack)
+        return;
+
+    // The cache may read from disk: look both tracks up before taking the lock
+    // (the tracks and formats only change on this thread)
+    TrackAnalysis next;
+    TrackAnalysis current;
+    const bool haveNext = m_analysisCache.find(m_preloadTrack->id(), m_preloadFormat, &next);
+    const bool haveCurrent = m_analysisCache.find(m_currentTrack->id(), m_currentStreamFormat, &current);
+    if (!haveNext && !haveCurrent)
+        return;
+
+    QMutexLocker locker(&m_streamMutex);
+    if (!m_preloadStream || !m_currentStream)
+        return;  // Nothing queued: the current track ends normally
+
+    if (haveNext && m_trimmedLeadStream != m_preloadStream) {
+        const double lead = qMin(next.leadingSilenceSeconds, MAX_TRIM_SECONDS);
+        // Only before the queued stream started
+        if (lead > 0.0 && BASS_ChannelGetPosition(m_preloadStream, BASS_POS_BYTE) == 0) {
+            BASS_Mixer_ChannelSetPosition(m_preloadStream, BASS_ChannelSeconds2Bytes(m_preloadStream, lead),
+                                          BASS_POS_BYTE);
+            emit debugLog(QString("[AudioEngine] Gap trim: next track starts after %1 s of silence")
+                          .arg(lead, 0, 'f', 2));
         }
-        watcher->deleteLater();
-    });
+        m_trimmedLeadStream = m_preloadStream;
+    }
+
+    // Push streams report a fake length, so their end can't be moved
+    if (haveCurrent && m_trimmedTailStream != m_currentStream && !m_pushStream) {
+        const double trail = qMin(current.trailingSilenceSeconds, MAX_TRIM_SECONDS);
+        const QWORD length = BASS_ChannelGetLength(m_currentStream, BASS_POS_BYTE);
+        const QWORD trailBytes = BASS_ChannelSeconds2Bytes(m_currentStream, trail);
+        if (trail > 0.0 && length != (QWORD)-1 && trailBytes < length &&
+            BASS_ChannelSetPosition(m_currentStream, length - trailBytes, BASS_POS_END)) {
+            emit debugLog(QString("[AudioEngine] Gap trim: current track ends %1 s early")
+                          .arg(trail, 0, 'f', 2));
+        }
+        m_trimmedTailStream = m_currentStream;
+    }
+}
+
+void AudioEngine::logAnalysisStats()
+{
+    const AnalysisExecutor::Stats stats = m_analysisExecutor.takeStats();
+    const AnalysisDecodeStats decode = takeAnalysisDecodeStats();
+    if (stats.submitted == 0 && stats.queued == 0 && stats.running == 0 && decode.reads == 0)
+        return;
 
-    watcher->setFuture(QtConcurrent::run(computeWaveformFromBuffer, bufferSnapshot, 500, &m_waveformGeneration, generation, &m_bassMutex, 1.0));
+    emit debugLog(QString("[AudioEngine] Analysis: %1 submitted, %2 completed, %3 cancelled, %4 coalesced; "
+                          "queue %5 (max %6), running %7")
+                  .arg(stats.submitted).arg(stats.completed).arg(stats.cancelled).arg(stats.coalesced)
+                  .arg(stats.queued).arg(stats.maxQueued).arg(stats.running));
+
+    // Decoding holds no engine lock: compare with the lock contention report
+    if (decode.reads > 0) {
+        const double megabytes = decode.bytes / (1024.0 * 1024.0);
+        const double seconds = decode.readNs / 1e9;
+        emit debugLog(QString("[AudioEngine] Analysis decode: %1 handles, %2 reads, %3 MB in %4 ms (%5 MB/s)")
+                      .arg(decode.decodes).arg(decode.reads)
+                      .arg(megabytes, 0, 'f', 1).arg(decode.readNs / 1e6, 0, 'f', 1)
+                      .arg(seconds > 0.0 ? megabytes / seconds : 0.0, 0, 'f', 0));
+    }
 }
 
 // ── Position & Duration Tracking ────────────────────────────────────────
 
+double AudioEngine::trackLengthSeconds() const
+{
+    // Push streams report a fake file length: prefer the container header
+    // (FLAC STREAMINFO, Xing/VBRI frame count) over the rounded track metadata
+    double seconds = m_mediaHeader.durationSeconds();
+    if (seconds <= 0.0 && m_currentTrack)
+        seconds = m_currentTrack->duration();
+    return seconds;
+}
+
+// Position/duration readers take no lock: they use the published handles and
+// read-only BASS calls (a handle freed meanwhile just makes the call fail).
+
 double AudioEngine::position() const
 {
-    QMutexLocker locker(&m_bassMutex);
-    if (!m_initialized || !m_mixerStream || !m_currentStream) {
+    const HSTREAM mixer = m_publishedMixer.load(std::memory_order_acquire);
+    const HSTREAM stream = m_publishedStream.load(std::memory_order_acquire);
+    if (!m_initialized || !mixer || !stream) {
         return 0.0;
     }
 
-    QWORD pos = BASS_Mixer_ChannelGetPosition(m_currentStream, BASS_POS_BYTE);
+    QWORD pos = BASS_Mixer_ChannelGetPosition(stream, BASS_POS_BYTE);
     if (pos == (QWORD)-1) return 0.0;
 
-    QWORD length = BASS_ChannelGetLength(m_currentStream, BASS_POS_BYTE);
+    QWORD length = BASS_ChannelGetLength(stream, BASS_POS_BYTE);
 
-    if (length == 0 || length == (QWORD)-1 || m_pushStream != 0) {
-        // Length unknown or unreliable (progressive push stream has fake length) -- use track metadata
-        if (m_currentTrack && m_currentTrack->duration() > 0) {
-            double seconds = BASS_ChannelBytes2Seconds(m_currentStream, pos);
-            return qBound(0.0, seconds / m_currentTrack->duration(), 1.0);
+    if (length == 0 || length == (QWORD)-1 || m_publishedPushStream.load(std::memory_order_acquire)) {
+        // Length unknown or unreliable (progressive push stream has fake length) -- use seek index / track metadata
+        double lengthSecs = trackLengthSeconds();
+        if (lengthSecs > 0.0) {
+            double seconds = BASS_ChannelBytes2Seconds(stream, pos);
+            return qBound(0.0, seconds / lengthSecs, 1.0);
         }
         return 0.0;
     }
@@ -170,30 +304,31 @@ double AudioEngine::position() const
 
 int AudioEngine::positionSeconds() const
 {
-    QMutexLocker locker(&m_bassMutex);
+    const HSTREAM mixer = m_publishedMixer.load(std::memory_order_acquire);
+    const HSTREAM stream = m_publishedStream.load(std::memory_order_acquire);
 
     // Check if initialized and mixer exists
-    if (!m_initialized || !m_mixerStream) {
+    if (!m_initialized || !mixer) {
         return 0;
     }
 
     // Try to get position from current stream (if set)
-    if (m_currentStream) {
+    if (stream) {
         // Verify stream is still valid and active in mixer
-        DWORD active = BASS_Mixer_ChannelIsActive(m_currentStream);
+        DWORD active = BASS_Mixer_ChannelIsActive(stream);
         if (active != BASS_ACTIVE_PLAYING && active != BASS_ACTIVE_PAUSED
             && active != BASS_ACTIVE_STALLED) {
             return 0;
         }
 
-        QWORD pos = BASS_Mixer_ChannelGetPosition(m_currentStream, BASS_POS_BYTE);
+        QWORD pos = BASS_Mixer_ChannelGetPosition(stream, BASS_POS_BYTE);
 
         // Check for error conditions
         if (pos == (QWORD)-1) {
             return 0;
         }
 
-        double seconds = BASS_ChannelBytes2Seconds(m_currentStream, pos);
+        double seconds = BASS_ChannelBytes2Seconds(stream, pos);
 
         // Ensure non-negative result
         if (seconds < 0.0) {
@@ -205,18 +340,18 @@ int AudioEngine::positionSeconds() const
 
     // Fallback: try to get position from mixer directly
     // This works when m_currentStream hasn't been set yet (during transitions)
-    QWORD pos = BASS_ChannelGetPosition(m_mixerStream, BASS_POS_BYTE);
+    QWORD pos = BASS_ChannelGetPosition(mixer, BASS_POS_BYTE);
 
     if (pos == (QWORD)-1) {
         return 0;
     }
 
-    QWORD length = BASS_ChannelGetLength(m_mixerStream, BASS_POS_BYTE);
+    QWORD length = BASS_ChannelGetLength(mixer, BASS_POS_BYTE);
     if (length == 0 || length == (QWORD)-1) {
         return 0;
     }
 
-    double seconds = BASS_ChannelBytes2Seconds(m_mixerStream, pos);
+    double seconds = BASS_ChannelBytes2Seconds(mixer, pos);
 
     // Ensure non-negative result
     if (seconds < 0.0) {
@@ -226,30 +361,34 @@ int AudioEngine::positionSeconds() const
     return static_cast<int>(seconds);
 }
 
-int AudioEngine::durationSeconds() const
+double AudioEngine::streamLengthSeconds() const
 {
-    QMutexLocker locker(&m_bassMutex);
-    if (!m_initialized || !m_currentStream) {
+    const HSTREAM stream = m_publishedStream.load(std::memory_order_acquire);
+    if (!m_initialized || !stream) {
         if (m_currentTrack)
             return m_currentTrack->duration();
-        return 0;
+        return 0.0;
     }
 
-    QWORD length = BASS_ChannelGetLength(m_currentStream, BASS_POS_BYTE);
-    if (length == (QWORD)-1 || m_pushStream != 0) {
-        // Stream length unknown or unreliable (progressive push stream has fake length) -- use track metadata
-        if (m_currentTrack)
-            return m_currentTrack->duration();
-        return 0;
+    QWORD length = BASS_ChannelGetLength(stream, BASS_POS_BYTE);
+    if (length == (QWORD)-1 || m_publishedPushStream.load(std::memory_order_acquire)) {
+        // Stream length unknown or unreliable (progressive push stream has fake length) -- use seek index / track metadata
+        return trackLengthSeconds();
     }
-    double seconds = BASS_ChannelBytes2Seconds(m_currentStream, length);
+    return BASS_ChannelBytes2Seconds(stream, length);
+}
 
-    return static_cast<int>(seconds);
+int AudioEngine::durationSeconds() const
+{
+    // Set by publishStreamState() whenever the current stream changes
+    return static_cast<int>(m_playbackClock.lengthSeconds());
 }
 
 void AudioEngine::updatePosition()
 {
-    int currentSeconds = positionSeconds();
+    // Position and length both come from the mixer-fed clock
+    updateTapLatency();
+    int currentSeconds = static_cast<int>(m_playbackClock.seconds());
 
     if (currentSeconds != m_lastPositionSeconds) {
         m_lastPositionSeconds = currentSeconds;
@@ -263,7 +402,14 @@ void AudioEngine::updatePosition()
             int duration = durationSeconds();
             if (duration <= 0) duration = m_currentTrack->duration();
 
-            m_deezerAPI->reportListen(trackId, duration, m_currentStreamFormat, m_contextType, m_contextId);
+            // DeezerAPI's network access lives on the GUI thread
+            DeezerAPI* api = m_deezerAPI;
+            const QString format = m_currentStreamFormat;
+            const QString contextType = m_contextType;
+            const QString contextId = m_contextId;
+            QMetaObject::invokeMethod(api, [api, trackId, duration, format, contextType, contextId]() {
+                api->reportListen(trackId, duration, format, contextType, contextId);
+            });
             QString contextInfo = (!m_contextType.isEmpty() && !m_contextId.isEmpty())
                 ? QString(" [Context: %1/%2]").arg(m_contextType, m_contextId)
                 : QString();
@@ -272,109 +418,122 @@ void AudioEngine::updatePosition()
         }
     }
 
-    // Fine-grained position for smooth waveform playhead (~10 updates/sec)
-    emit positionTick(position());
+    // Fine-grained position (~10 updates/sec); UI playheads poll playbackClock() for smoother motion
+    emit positionTick(m_playbackClock.fraction());
+
+    // Memory-capped streaming follows the read position
+    if (m_streamCapped)
+        maintainStreamWindow();
+
+    // Contention report every ~10 s (only logs when a lock had to wait)
+    if (++m_lockStatsTicks >= 100) {
+        m_lockStatsTicks = 0;
+        logLockContention();
+        logAnalysisStats();
+    }
 }
 
 // ── Spectrum Analysis ───────────────────────────────────────────────────
 
-void AudioEngine::setSpectrumEnabled(bool enabled)
+void AudioEngine::subscribeVisualization(QObject* consumer, int feeds, int fps)
 {
-    m_spectrumEnabled = enabled;
+    if (!consumer)
+        return;
 
-    if (enabled) {
-        m_spectrumTimer->start();
-    } else {
-        m_spectrumTimer->stop();
-    }
+    // The consumer is only known to be alive in the caller's thread, so watch
+    // for its destruction here; the engine thread only uses it as a key
+    QMetaObject::Connection destroyedConnection =
+        connect(consumer, &QObject::destroyed, this, [this, consumer]() {
+            unsubscribeVisualization(consumer);
+        });
+
+    if (postToEngineThread([=]() { addVisualizationSubscriber(consumer, feeds, fps, destroyedConnection); }))
+        return;
+    addVisualizationSubscriber(consumer, feeds, fps, destroyedConnection);
 }
 
-void AudioEngine::updateSpectrum()
+void AudioEngine::addVisualizationSubscriber(QObject* consumer, int feeds, int fps,
+                                             const QMetaObject::Connection& destroyedConnection)
 {
-    static int callCount = 0;
-    callCount++;
+    VisualizationSubscription& subscription = m_visualizationSubscribers[consumer];
+    if (subscription.destroyedConnection)
+        disconnect(destroyedConnection);  // Already watched (re-subscription)
+    else
+        subscription.destroyedConnection = destroyedConnection;
+    subscription.feeds = feeds;
+    subscription.fps = qBound(1, fps, 120);
+
+    updateVisualizationDemand();
+}
 
-    if (!m_spectrumEnabled || !m_mixerStream) {
+void AudioEngine::unsubscribeVisualization(QObject* consumer)
+{
+    if (postToEngineThread([this, consumer]() { unsubscribeVisualization(consumer); }))
         return;
-    }
 
-    QMutexLocker locker(&m_bassMutex);
-
-    // Get PCM data from mixer output (512 samples per channel for 30fps visualizer)
-    static constexpr int PCM_SAMPLES = 512;
-    static std::vector<float> pcmLeft(PCM_SAMPLES);
-    static std::vector<float> pcmRight(PCM_SAMPLES);
-    static float pcmInterleaved[PCM_SAMPLES * 2];
-
-    // CRITICAL: In WASAPI mode the mixer is a decode channel. BASS_ChannelGetData
-    // on a decode channel CONSUMES data from the decode pipeline, stealing it from
-    // WASAPI output and causing broken/choppy audio. Use BASS_WASAPI_GetData instead
-    // which reads from the WASAPI output buffer without consuming decode data.
-    bool useWasapi = (m_outputMode != OutputDirectSound);
-
-    DWORD result = useWasapi
-        ? BASS_WASAPI_GetData(pcmInterleaved, BASS_DATA_FLOAT | PCM_SAMPLES * 2 * sizeof(float))
-        : BASS_ChannelGetData(m_mixerStream, pcmInterleaved, BASS_DATA_FLOAT | PCM_SAMPLES * 2 * sizeof(float));
-
-    if (result == (DWORD)-1) {
-        if (callCount <= 3) {
-            emit debugLog(QString("[AudioEngine] %1 failed, error code: %2")
-                         .arg(useWasapi ? "BASS_WASAPI_GetData" : "BASS_ChannelGetData")
-                         .arg(BASS_ErrorGetCode()));
-        }
-        return; // No data or error
-    }
+    auto it = m_visualizationSubscribers.find(consumer);
+    if (it == m_visualizationSubscribers.end())
+        return;
 
-    // Deinterleave PCM data (L R L R L R -> LLL..., RRR...)
-    int samplesRetrieved = result / (2 * sizeof(float));
-    samplesRetrieved = qMin(samplesRetrieved, PCM_SAMPLES);
+    disconnect(it->destroyedConnection);
+    m_visualizationSubscribers.erase(it);
 
-    for (int i = 0; i < samplesRetrieved; ++i) {
-        pcmLeft[i] = pcmInterleaved[i * 2];      // Left channel
-        pcmRight[i] = pcmInterleaved[i * 2 + 1]; // Right channel
-    }
+    updateVisualizationDemand();
+}
 
-    // Fill remaining with zeros if needed
-    for (int i = samplesRetrieved; i < PCM_SAMPLES; ++i) {
-        pcmLeft[i] = 0.0f;
-        pcmRight[i] = 0.0f;
+void AudioEngine::updateVisualizationDemand()
+{
+    int spectrumFps = 0;
+    bool pcmWanted = false;
+    for (const VisualizationSubscription& subscription : m_visualizationSubscribers) {
+        if (subscription.feeds & SpectrumFeed)
+            spectrumFps = qMax(spectrumFps, subscription.fps);
+        if (subscription.feeds & PcmFeed)
+            pcmWanted = true;
     }
 
-    // Get FFT data for spectrum
-    float fft[4096];
-    result = useWasapi
-        ? BASS_WASAPI_GetData(fft, BASS_DATA_FFT8192)
-        : BASS_ChannelGetData(m_mixerStream, fft, BASS_DATA_FFT8192);
-
-    // Convert FFT bins to 32 frequency bands (logarithmic grouping)
-    const int numBands = 32;
-    QVector<float> magnitudes(numBands, 0.0f);
-
-    if (result != (DWORD)-1) {
-        // Logarithmic frequency distribution
-        for (int band = 0; band < numBands; ++band) {
-            // Calculate bin range for this band
-            float lowFreq = 20.0f * qPow(2.0f, band * qLn(20000.0f / 20.0f) / (numBands * qLn(2.0f)));
-            float highFreq = 20.0f * qPow(2.0f, (band + 1) * qLn(20000.0f / 20.0f) / (numBands * qLn(2.0f)));
-
-            int startBin = static_cast<int>(lowFreq * 4096 / 22050.0f);
-            int endBin = static_cast<int>(highFreq * 4096 / 22050.0f);
-
-            if (endBin > 4096) endBin = 4096;
-            if (startBin >= endBin) startBin = endBin - 1;
-
-            // Average magnitude across bins in this band
-            float sum = 0.0f;
-            for (int bin = startBin; bin < endBin; ++bin) {
-                sum += fft[bin];
-            }
-            float avg = sum / (endBin - startBin);
+    const bool tapActive = spectrumFps > 0 || pcmWanted;
+    if (spectrumFps == m_spectrumFps && tapActive == m_tapActive.load(std::memory_order_relaxed))
+        return;
 
-            // Apply scaling
-            magnitudes[band] = qBound(0.0f, avg * 50.0f, 1.0f);
-        }
+    m_tapActive.store(tapActive, std::memory_order_relaxed);
+
+    if (spectrumFps != m_spectrumFps) {
+        QMetaObject::invokeMethod(m_spectrumEngine, "setRate", Qt::QueuedConnection, Q_ARG(int, spectrumFps));
+        m_spectrumFps = spectrumFps;
     }
 
-    emit spectrumDataReady(magnitudes);
-    emit pcmDataReady(pcmLeft, pcmRight);
+    emit debugLog(QString("[AudioEngine] Visualization demand: spectrum %1 fps, PCM %2")
+                  .arg(spectrumFps).arg(pcmWanted ? "on" : "off"));
+}
+
+void AudioEngine::setSpectrumResolution(int fftSize, int bandCount)
+{
+    QMetaObject::invokeMethod(m_spectrumEngine, "setResolution", Qt::QueuedConnection,
+                              Q_ARG(int, fftSize), Q_ARG(int, bandCount));
+}
+
+void AudioEngine::updateTapLatency()
+{
+    const HSTREAM mixer = m_publishedMixer.load(std::memory_order_acquire);
+    if (!mixer)
+        return;
+
+    // Data rendered by the mixer (and copied to the tap) that the device hasn't played yet
+    if (m_outputMode != OutputDirectSound) {
+        BASS_WASAPI_INFO info;
+        DWORD buffered = BASS_WASAPI_GetData(nullptr, BASS_DATA_AVAILABLE);
+        if (buffered == (DWORD)-1 || !BASS_WASAPI_GetInfo(&info) || info.chans == 0)
+            return;
+        DWORD sampleBytes = 4;
+        if (info.format == BASS_WASAPI_FORMAT_8BIT) sampleBytes = 1;
+        else if (info.format == BASS_WASAPI_FORMAT_16BIT) sampleBytes = 2;
+        else if (info.format == BASS_WASAPI_FORMAT_24BIT) sampleBytes = 3;
+        m_audioTap.setLatencyFrames(buffered / (info.chans * sampleBytes));
+    } else {
+        DWORD buffered = BASS_ChannelGetData(mixer, nullptr, BASS_DATA_AVAILABLE);
+        if (buffered == (DWORD)-1)
+            return;
+        m_audioTap.setLatencyFrames(static_cast<qint64>(BASS_ChannelBytes2Seconds(mixer, buffered) * m_audioTap.sampleRate()));
+    }
 }
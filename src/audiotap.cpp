@@ -0,0 +1,106 @@
+#include "audiotap.h"
+#include <algorithm>
+#include <cstring>
+
+static int roundUpToPowerOfTwo(int value)
+{
+    int result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+AudioTap::AudioTap(int capacityFrames)
+    : m_capacity(roundUpToPowerOfTwo(qMax(capacityFrames, 1024)))
+    , m_ring(static_cast<size_t>(m_capacity) * CHANNELS, 0.0f)
+{
+}
+
+void AudioTap::setFormat(int sampleRate, bool floatSamples)
+{
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    m_floatSamples.store(floatSamples, std::memory_order_relaxed);
+}
+
+void AudioTap::write(const void* data, int bytes)
+{
+    const bool isFloat = m_floatSamples.load(std::memory_order_relaxed);
+    const int frameBytes = CHANNELS * (isFloat ? static_cast<int>(sizeof(float)) : static_cast<int>(sizeof(qint16)));
+    int frames = bytes / frameBytes;
+    if (frames <= 0)
+        return;
+
+    // A block larger than the ring only keeps its tail
+    const char* bytesIn = static_cast<const char*>(data);
+    if (frames > m_capacity) {
+        bytesIn += static_cast<size_t>(frames - m_capacity) * frameBytes;
+        frames = m_capacity;
+    }
+
+    const qint64 start = m_written.load(std::memory_order_relaxed);
+    const qint64 end = start + frames;
+
+    // Announce the frames about to be overwritten before touching them
+    m_reserved.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    int offset = static_cast<int>(start & (m_capacity - 1));
+    int done = 0;
+    while (done < frames) {
+        const int run = qMin(frames - done, m_capacity - offset);
+        float* out = m_ring.data() + static_cast<size_t>(offset) * CHANNELS;
+        if (isFloat) {
+            std::memcpy(out, bytesIn + static_cast<size_t>(done) * frameBytes,
+                        static_cast<size_t>(run) * frameBytes);
+        } else {
+            const qint16* in = reinterpret_cast<const qint16*>(bytesIn) + static_cast<size_t>(done) * CHANNELS;
+            for (int i = 0; i < run * CHANNELS; ++i)
+                out[i] = in[i] * (1.0f / 32768.0f);
+        }
+        done += run;
+        offset = 0;
+    }
+
+    m_written.store(end, std::memory_order_release);
+}
+
+qint64 AudioTap::playingFrame() const
+{
+    const qint64 written = m_written.load(std::memory_order_acquire);
+    const qint64 latency = m_latencyFrames.load(std::memory_order_relaxed);
+    return qMax<qint64>(0, written - latency);
+}
+
+bool AudioTap::copy(qint64 startFrame, float* dst, int frames) const
+{
+    if (frames <= 0)
+        return true;
+
+    const qint64 endFrame = startFrame + frames;
+    const qint64 written = m_written.load(std::memory_order_acquire);
+    if (endFrame > written || written - qMax<qint64>(startFrame, 0) > m_capacity)
+        return false;
+
+    // Silence before the first frame
+    int done = 0;
+    if (startFrame < 0) {
+        done = static_cast<int>(qMin<qint64>(-startFrame, frames));
+        std::fill(dst, dst + static_cast<size_t>(done) * CHANNELS, 0.0f);
+    }
+
+    const qint64 firstReal = startFrame + done;
+    int offset = static_cast<int>(firstReal & (m_capacity - 1));
+    while (done < frames) {
+        const int run = qMin(frames - done, m_capacity - offset);
+        std::memcpy(dst + static_cast<size_t>(done) * CHANNELS,
+                    m_ring.data() + static_cast<size_t>(offset) * CHANNELS,
+                    static_cast<size_t>(run) * CHANNELS * sizeof(float));
+        done += run;
+        offset = 0;
+    }
+
+    // Anything the writer started overwriting while we copied is torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const qint64 reserved = m_reserved.load(std::memory_order_relaxed);
+    return reserved - m_capacity <= firstReal;
+}
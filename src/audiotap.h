@@ -0,0 +1,54 @@
+#ifndef AUDIOTAP_H
+#define AUDIOTAP_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+/**
+ * Ring buffer of the post-mix audio (stereo, float), written by a DSP on the
+ * mixer thread and read lock-free by any number of visualization consumers,
+ * each at its own rate. Frames are addressed by their absolute index since
+ * the tap was created; readers detect data overwritten while they copied it.
+ */
+class AudioTap
+{
+public:
+    static constexpr int CHANNELS = 2;
+
+    explicit AudioTap(int capacityFrames = 1 << 18);
+
+    // Sample format of the mixer feeding write(); set before the DSP is installed
+    void setFormat(int sampleRate, bool floatSamples);
+
+    // Writer side (mixer thread): raw mixer buffer, float or 16-bit interleaved
+    void write(const void* data, int bytes);
+
+    // Frames written to the ring but not audible yet (output buffer), set from
+    // the thread that owns the output
+    void setLatencyFrames(qint64 frames) { m_latencyFrames.store(frames, std::memory_order_relaxed); }
+
+    int sampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+    int capacityFrames() const { return m_capacity; }
+    qint64 writtenFrames() const { return m_written.load(std::memory_order_acquire); }
+
+    // Index of the frame leaving the speakers now
+    qint64 playingFrame() const;
+
+    // Copy frames [startFrame, startFrame + frames) interleaved into dst.
+    // Frames before the start of the tap read as silence. Returns false if part
+    // of the range isn't written yet or was overwritten during the copy.
+    bool copy(qint64 startFrame, float* dst, int frames) const;
+
+private:
+    const int m_capacity;  // Power of two
+    std::vector<float> m_ring;
+
+    std::atomic<qint64> m_written{0};   // Frames completely written
+    std::atomic<qint64> m_reserved{0};  // Frames the writer may be writing (>= m_written)
+    std::atomic<qint64> m_latencyFrames{0};
+    std::atomic<int> m_sampleRate{44100};
+    std::atomic<bool> m_floatSamples{true};
+};
+
+#endif // AUDIOTAP_H
@@ -0,0 +1,72 @@
+#ifndef COUNTINGMUTEX_H
+#define COUNTINGMUTEX_H
+
+#include <QRecursiveMutex>
+#include <QElapsedTimer>
+#include <atomic>
+
+/**
+ * Recursive mutex that counts how often lockers had to wait and for how long.
+ * Drop-in for QRecursiveMutex with QMutexLocker; takeStats() returns and resets
+ * the counters so contention can be logged per interval.
+ */
+class CountingMutex
+{
+public:
+    struct Stats {
+        quint64 acquisitions = 0;
+        quint64 contended = 0;   // Acquisitions that had to wait for another thread
+        qint64 waitNs = 0;       // Total time spent waiting
+        qint64 maxWaitNs = 0;
+    };
+
+    void lock()
+    {
+        if (m_mutex.tryLock()) {
+            m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        m_mutex.lock();
+        const qint64 waited = timer.nsecsElapsed();
+
+        m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        m_contended.fetch_add(1, std::memory_order_relaxed);
+        m_waitNs.fetch_add(waited, std::memory_order_relaxed);
+        qint64 previousMax = m_maxWaitNs.load(std::memory_order_relaxed);
+        while (waited > previousMax &&
+               !m_maxWaitNs.compare_exchange_weak(previousMax, waited, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool tryLock()
+    {
+        if (!m_mutex.tryLock())
+            return false;
+        m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock() { m_mutex.unlock(); }
+
+    Stats takeStats()
+    {
+        Stats stats;
+        stats.acquisitions = m_acquisitions.exchange(0, std::memory_order_relaxed);
+        stats.contended = m_contended.exchange(0, std::memory_order_relaxed);
+        stats.waitNs = m_waitNs.exchange(0, std::memory_order_relaxed);
+        stats.maxWaitNs = m_maxWaitNs.exchange(0, std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    QRecursiveMutex m_mutex;
+    std::atomic<quint64> m_acquisitions{0};
+    std::atomic<quint64> m_contended{0};
+    std::atomic<qint64> m_waitNs{0};
+    std::atomic<qint64> m_maxWaitNs{0};
+};
+
+#endif // COUNTINGMUTEX_H
@@ -90,7 +90,8 @@ void DeezerAPI::ensureSid()
     // The auth class will handle initialization
 }
 
-QNetworkReply* DeezerAPI::callGatewayMethod(const QString& method, const QJsonObject& params, bool useSid)
+QNetworkReply* DeezerAPI::callGatewayMethod(const QString& method, const QJsonObject& params, bool useSid,
+                                            QNetworkRequest::Priority priority)
 {
     if (s_mobileApiKey.isEmpty()) {
         emit error("MOBILE_API_KEY not set. Call DeezerAPI::setApiKey().");
@@ -116,6 +117,7 @@ QNetworkReply* DeezerAPI::callGatewayMethod(const QString& method, const QJsonOb
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("User-Agent", USER_AGENT);
+    request.setPriority(priority);
 
     QNetworkReply* reply = m_networkManager->post(request, postData);
     m_pendingRequests[reply] = method;
@@ -486,8 +488,16 @@ void DeezerAPI::removeFavoriteTrack(const QString& trackId, const QString& conte
     callWebGatewayMethod("favorite_song.remove", params);
 }
 
-void DeezerAPI::getLyrics(const QString& trackId)
+void DeezerAPI::getLyrics(const QString& trackId, bool prefetch)
 {
+    // Already requested (e.g. prefetched): its answer serves this caller too
+    for (const QString& pendingId : std::as_const(m_lyricsTrackIds)) {
+        if (pendingId == trackId) {
+            emit debugLog(QString("[song.getLyrics] Track %1: request already in flight").arg(trackId));
+            return;
+        }
+    }
+
     QJsonObject params;
     // Convert trackId to number - API expects numeric SNG_ID
     bool ok;
@@ -497,7 +507,9 @@ void DeezerAPI::getLyrics(const QString& trackId)
     } else {
         params["SNG_ID"] = trackId;  // Fallback to string if conversion fails
     }
-    QNetworkReply* reply = callGatewayMethod("song.getLyrics", params);
+    QNetworkReply* reply = callGatewayMethod("song.getLyrics", params, true,
+                                             prefetch ? QNetworkRequest::LowPriority
+                                                      : QNetworkRequest::NormalPriority);
     if (reply) {
         m_lyricsTrackIds[reply] = trackId;  // Store track ID for later retrieval
     }
@@ -583,8 +595,15 @@ void DeezerAPI::handleNetworkReply(QNetworkReply* reply)
     reply->deleteLater();
     QString method = m_pendingRequests.value(reply, "");
     m_pendingRequests.remove(reply);
+    // Taken before any error return, so a failed request doesn't block later ones
+    const QString lyricsTrackId = m_lyricsTrackIds.take(reply);
 
     if (reply->error() != QNetworkReply::NoError) {
+        // Lyrics are fetched in the background (prefetch included): never a dialog
+        if (method == "song.getLyrics") {
+            emit debugLog(QString("[song.getLyrics] Track %1: %2").arg(lyricsTrackId, reply->errorString()));
+            return;
+        }
         emit error(reply->errorString());
         return;
     }
@@ -633,6 +652,12 @@ void DeezerAPI::handleNetworkReply(QNetworkReply* reply)
             QString logLine = QString("[%1] API error: %2\nRaw response: %3")
                                  .arg(method, msg, rawResponse.left(2000));
             emit debugLog(logLine);
+            // Deezer answers with an error for tracks without lyrics: an empty
+            // result, so the cache remembers the miss
+            if (method == "song.getLyrics") {
+                emit lyricsReceived(lyricsTrackId, QString(), QJsonArray());
+                return;
+            }
             if (method == "mobile_userAuth" || method == "deezer.getUserData" || method.startsWith("mobile_user"))
                 emit authenticationFailed(msg);
             else
@@ -695,9 +720,7 @@ void DeezerAPI::handleNetworkReply(QNetworkReply* reply)
     if (method == "song.getLyrics") {
         QJsonObject results = resultsVal.isObject() ? resultsVal.toObject() : QJsonObject();
 
-        // Retrieve track ID from stored map
-        QString trackId = m_lyricsTrackIds.value(reply, QString());
-        m_lyricsTrackIds.remove(reply);  // Clean up
+        const QString& trackId = lyricsTrackId;
 
         // Extract plain text lyrics
         QString lyrics;
@@ -72,8 +72,9 @@ public:
     void getAlbum(const QString& albumId);        // Returns album + songs (like diezel getAlbum)
     void getAlbumTracks(const QString& albumId);  // Legacy: just tracks
 
-    // Lyrics
-    void getLyrics(const QString& trackId);
+    // Lyrics. A request for a track whose lyrics are already in flight is
+    // coalesced with it; prefetches go out at low network priority.
+    void getLyrics(const QString& trackId, bool prefetch = false);
 
     // User
     void getUserInfo();
@@ -131,7 +132,8 @@ private slots:
 
 private:
     void ensureSid();  // Calls initializeKeys() if no SID (async)
-    QNetworkReply* callGatewayMethod(const QString& method, const QJsonObject& params, bool useSid = true);
+    QNetworkReply* callGatewayMethod(const QString& method, const QJsonObject& params, bool useSid = true,
+                                     QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
     void callWebGatewayMethod(const QString& method, const QJsonObject& params);
     QByteArray buildGatewayPostBody(const QJsonObject& params);
 
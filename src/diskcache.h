@@ -0,0 +1,143 @@
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <atomic>
+
+/**
+ * Storage shared by the per-track caches: an in-memory LRU in front of one
+ * file per key under the cache location. Each file holds a magic, a version
+ * and the key, then the body written by Codec:
+ *
+ *   static void serialize(QDataStream& out, const Payload& payload);
+ *   static bool deserialize(QDataStream& in, Payload* payload);
+ *
+ * A file that doesn't match reads as a miss. The directory keeps the
+ * MAX_DISK_ENTRIES most recently used files.
+ */
+template <typename Payload, typename Codec>
+class DiskCache
+{
+public:
+    static constexpr int MAX_DISK_ENTRIES = 5000;
+    static constexpr int PRUNE_INTERVAL = 50;  // Writes between directory scans
+
+    DiskCache(const QString& subdirectory, const QString& suffix, quint32 magic, quint32 version,
+              int memoryEntries)
+        : m_directory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1Char('/') + subdirectory)
+        , m_suffix(suffix)
+        , m_magic(magic)
+        , m_version(version)
+        , m_memoryEntries(qMax(1, memoryEntries))
+    {
+    }
+
+    // ── Memory (owner thread only) ──────────────────────────────────────
+
+    // True if the key is in memory; it becomes the most recently used
+    bool findInMemory(const QString& key, Payload* out)
+    {
+        auto it = m_memory.constFind(key);
+        if (it == m_memory.constEnd())
+            return false;
+        m_memoryOrder.removeOne(key);
+        m_memoryOrder.append(key);
+        if (out)
+            *out = *it;
+        return true;
+    }
+
+    void remember(const QString& key, const Payload& payload)
+    {
+        m_memory.insert(key, payload);
+        m_memoryOrder.removeOne(key);
+        m_memoryOrder.append(key);
+        while (m_memoryOrder.size() > m_memoryEntries)
+            m_memory.remove(m_memoryOrder.takeFirst());
+    }
+
+    // ── Disk (any thread: files are replaced atomically) ────────────────
+
+    bool readFromDisk(const QString& key, Payload* out) const
+    {
+        QFile file(filePath(key));
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic = 0, version = 0;
+        QString storedKey;
+        in >> magic >> version >> storedKey;
+        if (in.status() != QDataStream::Ok || magic != m_magic || version != m_version || storedKey != key)
+            return false;
+
+        Payload payload;
+        if (!Codec::deserialize(in, &payload))
+            return false;
+        file.close();
+
+        // Recently played tracks survive pruning
+        if (file.open(QIODevice::ReadWrite))
+            file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+
+        *out = payload;
+        return true;
+    }
+
+    void writeToDisk(const QString& key, const Payload& payload) const
+    {
+        if (!QDir().mkpath(m_directory))
+            return;
+
+        QSaveFile file(filePath(key));
+        if (!file.open(QIODevice::WriteOnly))
+            return;
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << m_magic << m_version << key;
+        Codec::serialize(out, payload);
+        if (!file.commit())
+            return;
+
+        if (m_writes.fetch_add(1, std::memory_order_relaxed) % PRUNE_INTERVAL == 0)
+            pruneDisk();
+    }
+
+private:
+    QString filePath(const QString& key) const
+    {
+        const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+        return m_directory + QLatin1Char('/') + QString::fromLatin1(hash) + m_suffix;
+    }
+
+    void pruneDisk() const
+    {
+        QDir dir(m_directory);
+        const QFileInfoList files = dir.entryInfoList({QLatin1Char('*') + m_suffix}, QDir::Files, QDir::Time);
+        // Newest first: everything past the limit goes
+        for (int i = MAX_DISK_ENTRIES; i < files.size(); ++i)
+            QFile::remove(files[i].absoluteFilePath());
+    }
+
+    const QString m_directory;
+    const QString m_suffix;  // File extension, also what pruneDisk() scans for
+    const quint32 m_magic;
+    const quint32 m_version;
+    const int m_memoryEntries;
+    QHash<QString, Payload> m_memory;
+    QStringList m_memoryOrder;  // Least recently used first
+    mutable std::atomic<int> m_writes{0};
+};
+
+#endif // DISKCACHE_H
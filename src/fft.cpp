@@ -0,0 +1,122 @@
+#include "fft.h"
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FFT_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static constexpr double PI = 3.14159265358979323846;
+
+RealFft::RealFft(int size)
+    : m_size(size)
+    , m_half(size / 2)
+    , m_bitReverse(m_half)
+    , m_re(m_half)
+    , m_im(m_half)
+{
+    int bits = 0;
+    while ((1 << bits) < m_half)
+        ++bits;
+    for (int i = 0; i < m_half; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        m_bitReverse[i] = reversed;
+    }
+
+    // Contiguous twiddles per stage so the butterflies load them linearly
+    m_stageTwiddleRe.resize(m_half);
+    m_stageTwiddleIm.resize(m_half);
+    for (int half = 1; half < m_half; half <<= 1) {
+        for (int k = 0; k < half; ++k) {
+            const double angle = -PI * k / half;
+            m_stageTwiddleRe[half - 1 + k] = static_cast<float>(std::cos(angle));
+            m_stageTwiddleIm[half - 1 + k] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    m_splitTwiddleRe.resize(m_half);
+    m_splitTwiddleIm.resize(m_half);
+    for (int k = 0; k < m_half; ++k) {
+        const double angle = -2.0 * PI * k / m_size;
+        m_splitTwiddleRe[k] = static_cast<float>(std::cos(angle));
+        m_splitTwiddleIm[k] = static_cast<float>(std::sin(angle));
+    }
+}
+
+void RealFft::complexTransform()
+{
+    float* re = m_re.data();
+    float* im = m_im.data();
+
+    for (int half = 1; half < m_half; half <<= 1) {
+        const float* twRe = m_stageTwiddleRe.data() + half - 1;
+        const float* twIm = m_stageTwiddleIm.data() + half - 1;
+        const int length = half * 2;
+
+        for (int start = 0; start < m_half; start += length) {
+            float* aRe = re + start;
+            float* aIm = im + start;
+            float* bRe = aRe + half;
+            float* bIm = aIm + half;
+            int k = 0;
+#ifdef FFT_USE_SSE
+            for (; k + 4 <= half; k += 4) {
+                const __m128 wr = _mm_loadu_ps(twRe + k);
+                const __m128 wi = _mm_loadu_ps(twIm + k);
+                const __m128 br = _mm_loadu_ps(bRe + k);
+                const __m128 bi = _mm_loadu_ps(bIm + k);
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                const __m128 ar = _mm_loadu_ps(aRe + k);
+                const __m128 ai = _mm_loadu_ps(aIm + k);
+                _mm_storeu_ps(aRe + k, _mm_add_ps(ar, tr));
+                _mm_storeu_ps(aIm + k, _mm_add_ps(ai, ti));
+                _mm_storeu_ps(bRe + k, _mm_sub_ps(ar, tr));
+                _mm_storeu_ps(bIm + k, _mm_sub_ps(ai, ti));
+            }
+#endif
+            for (; k < half; ++k) {
+                const float tr = bRe[k] * twRe[k] - bIm[k] * twIm[k];
+                const float ti = bRe[k] * twIm[k] + bIm[k] * twRe[k];
+                bRe[k] = aRe[k] - tr;
+                bIm[k] = aIm[k] - ti;
+                aRe[k] += tr;
+                aIm[k] += ti;
+            }
+        }
+    }
+}
+
+void RealFft::magnitudes(const float* input, float* output)
+{
+    // Pack even/odd samples as real/imaginary parts, in bit-reversed order
+    for (int n = 0; n < m_half; ++n) {
+        const int target = m_bitReverse[n];
+        m_re[target] = input[2 * n];
+        m_im[target] = input[2 * n + 1];
+    }
+
+    complexTransform();
+
+    // Split the packed spectrum: X[k] = E[k] + W^k * O[k]
+    const float scale = 2.0f / m_size;
+    for (int k = 0; k < m_half; ++k) {
+        const int mirror = (m_half - k) & (m_half - 1);
+        const float zr = m_re[k], zi = m_im[k];
+        const float cr = m_re[mirror], ci = -m_im[mirror];  // conj(Z[M - k])
+
+        const float evenRe = 0.5f * (zr + cr);
+        const float evenIm = 0.5f * (zi + ci);
+        // O[k] = -i/2 * (Z[k] - conj(Z[M - k]))
+        const float oddRe = 0.5f * (zi - ci);
+        const float oddIm = -0.5f * (zr - cr);
+
+        const float wr = m_splitTwiddleRe[k], wi = m_splitTwiddleIm[k];
+        const float xr = evenRe + oddRe * wr - oddIm * wi;
+        const float xi = evenIm + oddRe * wi + oddIm * wr;
+        output[k] = std::sqrt(xr * xr + xi * xi) * scale;
+    }
+}
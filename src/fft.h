@@ -0,0 +1,37 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+
+/**
+ * Real-input FFT of a fixed power-of-two size. Bit-reversal and per-stage
+ * twiddle tables are built once in the constructor; the N-point real
+ * transform runs as an N/2-point complex FFT on split real/imaginary arrays,
+ * with SSE butterflies where available.
+ */
+class RealFft
+{
+public:
+    explicit RealFft(int size);
+
+    int size() const { return m_size; }
+
+    // size input samples (already windowed) -> size / 2 magnitudes, scaled by
+    // 2 / size (a full-scale sine under a Hann window peaks at ~0.5, like BASS_DATA_FFT)
+    void magnitudes(const float* input, float* output);
+
+private:
+    void complexTransform();
+
+    int m_size;
+    int m_half;  // Complex transform size
+    std::vector<int> m_bitReverse;
+    std::vector<float> m_stageTwiddleRe;  // Stage with half-length h starts at index h - 1
+    std::vector<float> m_stageTwiddleIm;
+    std::vector<float> m_splitTwiddleRe;  // exp(-2*pi*i*k/size) for the real-FFT split
+    std::vector<float> m_splitTwiddleIm;
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+};
+
+#endif // FFT_H
@@ -0,0 +1,69 @@
+#include "lyricscache.h"
+#include <QJsonDocument>
+
+static constexpr quint32 FILE_MAGIC = 0x445a4c59;  // "DZLY"
+
+LyricsCache::LyricsCache(int memoryEntries)
+    : m_store(QStringLiteral("lyrics"), QStringLiteral(".lyr"), FILE_MAGIC, FORMAT_VERSION, memoryEntries)
+{
+}
+
+bool LyricsCache::find(const QString& trackId, QString* lyrics, QJsonArray* syncedLyrics)
+{
+    Entry entry;
+    if (!m_store.findInMemory(trackId, &entry)) {
+        if (!m_store.readFromDisk(trackId, &entry))
+            return false;
+        m_store.remember(trackId, entry);
+    }
+
+    if (lyrics)
+        *lyrics = entry.lyrics;
+    if (syncedLyrics)
+        *syncedLyrics = entry.syncedLyrics;
+    return true;
+}
+
+void LyricsCache::insert(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics)
+{
+    if (trackId.isEmpty())
+        return;
+
+    Entry entry;
+    entry.lyrics = lyrics;
+    entry.syncedLyrics = syncedLyrics;
+    m_store.remember(trackId, entry);
+    if (!lyrics.isEmpty() || !syncedLyrics.isEmpty())
+        m_store.writeToDisk(trackId, entry);
+}
+
+void LyricsCache::Codec::serialize(QDataStream& out, const Entry& entry)
+{
+    QByteArray body;
+    {
+        QDataStream bodyOut(&body, QIODevice::WriteOnly);
+        bodyOut.setVersion(QDataStream::Qt_6_0);
+        bodyOut << entry.lyrics << QJsonDocument(entry.syncedLyrics).toJson(QJsonDocument::Compact);
+    }
+    out << qCompress(body);
+}
+
+bool LyricsCache::Codec::deserialize(QDataStream& in, Entry* entry)
+{
+    QByteArray payload;
+    in >> payload;
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    QDataStream body(qUncompress(payload));
+    body.setVersion(QDataStream::Qt_6_0);
+    QString lyrics;
+    QByteArray synced;
+    body >> lyrics >> synced;
+    if (body.status() != QDataStream::Ok)
+        return false;
+
+    entry->lyrics = lyrics;
+    entry->syncedLyrics = QJsonDocument::fromJson(synced).array();
+    return true;
+}
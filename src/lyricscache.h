@@ -0,0 +1,40 @@
+#ifndef LYRICSCACHE_H
+#define LYRICSCACHE_H
+
+#include <QString>
+#include <QJsonArray>
+#include "diskcache.h"
+
+/**
+ * Lyrics by track id: an in-memory LRU in front of one compressed file per
+ * track under the cache location, so a track's lyrics are fetched once and
+ * survive restarts. "No lyrics" answers are only remembered in memory, so
+ * lyrics added on Deezer's side later are picked up next session.
+ */
+class LyricsCache
+{
+public:
+    static constexpr quint32 FORMAT_VERSION = 1;
+
+    explicit LyricsCache(int memoryEntries = 128);
+
+    // Memory first, then disk (promoted to memory)
+    bool find(const QString& trackId, QString* lyrics, QJsonArray* syncedLyrics);
+    void insert(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics);
+
+private:
+    struct Entry {
+        QString lyrics;
+        QJsonArray syncedLyrics;
+    };
+
+    // File body: plain text and the synced lines as compact JSON, compressed together
+    struct Codec {
+        static void serialize(QDataStream& out, const Entry& entry);
+        static bool deserialize(QDataStream& in, Entry* entry);
+    };
+
+    DiskCache<Entry, Codec> m_store;
+};
+
+#endif // LYRICSCACHE_H
@@ -1,34 +1,48 @@
 #include "lyricswidget.h"
-#include <QFont>
+#include <QFontMetrics>
 #include <QJsonObject>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QTextOption>
+#include <QWheelEvent>
+#include <QtMath>
+#include <algorithm>
+
+static constexpr int MARGIN = 20;             // Left/right, and top/bottom for plain text
+static constexpr int LINE_PADDING = 8;        // Around the text inside a line's slot
+static constexpr int LINE_SPACING = 8;
+static constexpr int SCROLL_LEAD_MS = 400;    // The view starts moving this long before the next line
+static constexpr int USER_SCROLL_HOLD_MS = 3000;  // Auto-follow pause after a manual scroll
+
+static const QColor COLOR_BACKGROUND(0x1a, 0x1a, 0x1a);
+static const QColor COLOR_TEXT(0x88, 0x88, 0x88);
+static const QColor COLOR_CURRENT_TEXT(0xff, 0xff, 0xff);
+static const QColor COLOR_CURRENT_BACKGROUND(0x33, 0x33, 0x33);
+static const QColor COLOR_MESSAGE(0x66, 0x66, 0x66);
 
 LyricsWidget::LyricsWidget(QWidget *parent)
-    : QWidget(parent)
+    : QAbstractScrollArea(parent)
+    , m_layoutWidth(-1)
+    , m_contentHeight(0)
+    , m_message("No lyrics loaded")
     , m_currentLineIndex(-1)
     , m_hasSyncedLyrics(false)
 {
-    QVBoxLayout* mainLayout = new QVBoxLayout(this);
-    mainLayout->setContentsMargins(0, 0, 0, 0);
-
-    m_scrollArea = new QScrollArea(this);
-    m_scrollArea->setWidgetResizable(true);
-    m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_scrollArea->setStyleSheet("QScrollArea { background: #1a1a1a; border: none; }");
-
-    m_contentWidget = new QWidget();
-    m_contentLayout = new QVBoxLayout(m_contentWidget);
-    m_contentLayout->setContentsMargins(20, 20, 20, 20);
-    m_contentLayout->setSpacing(8);
-    m_contentLayout->addStretch();
+    setFrameShape(QFrame::NoFrame);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAutoFillBackground(false);
 
-    m_scrollArea->setWidget(m_contentWidget);
-    mainLayout->addWidget(m_scrollArea);
+    // Arrows, page clicks, keys and dragging pause auto-follow like the wheel.
+    // Programmatic setValue() triggers no action, so following doesn't count.
+    QScrollBar* bar = verticalScrollBar();
+    connect(bar, &QScrollBar::actionTriggered, this, [this]() { m_userScroll.start(); });
+    connect(bar, &QScrollBar::sliderPressed, this, [this]() { m_userScroll.start(); });
 
-    // Default message
-    QLabel* emptyLabel = new QLabel("No lyrics loaded", this);
-    emptyLabel->setAlignment(Qt::AlignCenter);
-    emptyLabel->setStyleSheet("color: #666; font-size: 14px;");
-    m_contentLayout->addWidget(emptyLabel);
+    m_font = font();
+    m_font.setPointSize(13);
+    m_highlightFont = m_font;
+    m_highlightFont.setBold(true);
 }
 
 void LyricsWidget::setLyrics(const QString& lyrics, const QJsonArray& syncedLyrics)
@@ -57,15 +71,13 @@ void LyricsWidget::setLyrics(const QString& lyrics, const QJsonArray& syncedLyri
     }
     // No lyrics available
     else {
-        QLabel* noLyricsLabel = new QLabel("Lyrics not available for this track", m_contentWidget);
-        noLyricsLabel->setAlignment(Qt::AlignCenter);
-        noLyricsLabel->setStyleSheet("color: #666; font-size: 14px;");
-        m_contentLayout->insertWidget(0, noLyricsLabel);
-        m_lineLabels.append(noLyricsLabel);
+        m_message = "Lyrics not available for this track";
+        viewport()->update();
         return;
     }
 
-    rebuildUI();
+    m_message.clear();
+    relayout();
 }
 
 void LyricsWidget::parsePlainTextLyrics(const QString& lyrics)
@@ -109,7 +121,7 @@ void LyricsWidget::parseSyncedLyrics(const QJsonArray& syncedLyrics)
             if (parts.size() == 2) {
                 int minutes = parts[0].toInt();
                 double seconds = parts[1].toDouble();
-                lyricLine.milliseconds = (minutes * 60 * 1000) + (seconds * 1000);
+                lyricLine.milliseconds = static_cast<int>((minutes * 60 * 1000) + (seconds * 1000));
             }
         } else if (lineObj.contains("time")) {
             lyricLine.milliseconds = lineObj["time"].toString().toInt();
@@ -121,102 +133,219 @@ void LyricsWidget::parseSyncedLyrics(const QJsonArray& syncedLyrics)
             m_lines.append(lyricLine);
         }
     }
+
+    // The line lookup is a binary search over the timestamps
+    std::stable_sort(m_lines.begin(), m_lines.end(), [](const LyricLine& a, const LyricLine& b) {
+        return a.milliseconds < b.milliseconds;
+    });
 }
 
-void LyricsWidget::rebuildUI()
+// ── Layout ──────────────────────────────────────────────────────────
+
+// Wraps every line at the current width. Runs when the lyrics or the width
+// change, never on a line change.
+void LyricsWidget::relayout()
 {
-    // Clear existing labels
-    qDeleteAll(m_lineLabels);
-    m_lineLabels.clear();
+    m_layoutWidth = viewport()->width();
+    const int textWidth = qMax(1, m_layoutWidth - 2 * MARGIN - 2 * LINE_PADDING);
+
+    QTextOption option(Qt::AlignHCenter);
+    option.setWrapMode(QTextOption::WordWrap);
 
-    // Create label for each line
+    m_layouts.resize(m_lines.size());
+    int top = 0;
     for (int i = 0; i < m_lines.size(); ++i) {
-        QLabel* lineLabel = new QLabel(m_lines[i].text, m_contentWidget);
-        lineLabel->setWordWrap(true);
-        lineLabel->setAlignment(Qt::AlignCenter);
+        LineLayout& layout = m_layouts[i];
+        layout.text = QStaticText(m_lines[i].text);
+        layout.highlighted = QStaticText(m_lines[i].text);
+        for (QStaticText* text : {&layout.text, &layout.highlighted}) {
+            text->setTextFormat(Qt::PlainText);
+            text->setTextOption(option);
+            text->setTextWidth(textWidth);
+        }
+        layout.text.prepare(QTransform(), m_font);
+        layout.highlighted.prepare(QTransform(), m_highlightFont);
+
+        layout.top = top;
+        layout.height = qCeil(qMax(layout.text.size().height(), layout.highlighted.size().height()))
+                        + 2 * LINE_PADDING;
+        top += layout.height + LINE_SPACING;
+    }
+    m_contentHeight = qMax(0, top - LINE_SPACING);
+
+    // Synced lyrics scroll any line to the centre; plain text scrolls like a page
+    QScrollBar* bar = verticalScrollBar();
+    bar->setPageStep(viewport()->height());
+    bar->setSingleStep(QFontMetrics(m_font).height() + LINE_SPACING);
+    if (m_hasSyncedLyrics)
+        bar->setRange(0, m_contentHeight);
+    else
+        bar->setRange(0, qMax(0, m_contentHeight + 2 * MARGIN - viewport()->height()));
+
+    viewport()->update();
+}
+
+int LyricsWidget::topPadding() const
+{
+    return m_hasSyncedLyrics ? viewport()->height() / 2 : MARGIN;
+}
+
+QRect LyricsWidget::lineRect(int index) const
+{
+    if (index < 0 || index >= m_layouts.size())
+        return QRect();
+    const LineLayout& layout = m_layouts[index];
+    return QRect(MARGIN, topPadding() + layout.top - verticalScrollBar()->value(),
+                 viewport()->width() - 2 * MARGIN, layout.height);
+}
+
+void LyricsWidget::updateLine(int index)
+{
+    const QRect rect = lineRect(index);
+    if (!rect.isNull())
+        viewport()->update(rect);
+}
 
-        QFont font = lineLabel->font();
-        font.setPointSize(13);
-        lineLabel->setFont(font);
+void LyricsWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    if (!m_lines.isEmpty() && viewport()->width() != m_layoutWidth)
+        relayout();
+    else if (!m_lines.isEmpty())
+        verticalScrollBar()->setPageStep(viewport()->height());
+}
 
-        lineLabel->setStyleSheet("color: #888; padding: 4px;");
+// ── Painting ────────────────────────────────────────────────────────
 
-        m_contentLayout->insertWidget(i, lineLabel);
-        m_lineLabels.append(lineLabel);
+void LyricsWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter p(viewport());
+    p.fillRect(event->rect(), COLOR_BACKGROUND);
+
+    if (m_lines.isEmpty()) {
+        p.setPen(COLOR_MESSAGE);
+        QFont messageFont = font();
+        messageFont.setPixelSize(14);
+        p.setFont(messageFont);
+        p.drawText(viewport()->rect(), Qt::AlignCenter, m_message);
+        return;
     }
+
+    // Only the lines intersecting the exposed area
+    const int offset = topPadding() - verticalScrollBar()->value();
+    const int exposedTop = event->rect().top() - offset;
+    const int exposedBottom = event->rect().bottom() - offset;
+    auto first = std::upper_bound(m_layouts.cbegin(), m_layouts.cend(), exposedTop,
+                                  [](int y, const LineLayout& layout) { return y < layout.top + layout.height; });
+
+    p.setRenderHint(QPainter::Antialiasing, true);
+    for (auto it = first; it != m_layouts.cend() && it->top <= exposedBottom; ++it) {
+        const int index = static_cast<int>(it - m_layouts.cbegin());
+        const QRect rect = lineRect(index);
+        const bool current = index == m_currentLineIndex;
+        const QStaticText& text = current ? it->highlighted : it->text;
+
+        if (current) {
+            p.setPen(Qt::NoPen);
+            p.setBrush(COLOR_CURRENT_BACKGROUND);
+            p.drawRoundedRect(rect, 4, 4);
+        }
+        p.setFont(current ? m_highlightFont : m_font);
+        p.setPen(current ? COLOR_CURRENT_TEXT : COLOR_TEXT);
+        const int textTop = rect.top() + (rect.height() - qCeil(text.size().height())) / 2;
+        p.drawStaticText(rect.left() + LINE_PADDING, textTop, text);
+    }
+}
+
+// ── Scrolling ───────────────────────────────────────────────────────
+
+void LyricsWidget::scrollContentsBy(int dx, int dy)
+{
+    // Blit what stays visible, repaint only the uncovered strip
+    viewport()->scroll(dx, dy);
+}
+
+void LyricsWidget::wheelEvent(QWheelEvent *event)
+{
+    m_userScroll.start();
+    QAbstractScrollArea::wheelEvent(event);
 }
 
-void LyricsWidget::setPosition(int seconds)
+// Scroll value that centres the current line, easing towards the next one
+// during the last SCROLL_LEAD_MS before it starts
+int LyricsWidget::followOffset(int milliseconds) const
 {
-    if (m_lines.isEmpty()) return;
+    auto center = [this](int index) {
+        const LineLayout& layout = m_layouts[qBound(0, index, m_layouts.size() - 1)];
+        return layout.top + layout.height / 2;
+    };
 
-    int newLineIndex = findCurrentLineIndex(seconds);
+    const int current = m_currentLineIndex;
+    const int next = current + 1;
+    if (next >= m_lines.size())
+        return center(current);
+
+    const int remaining = m_lines[next].milliseconds - milliseconds;
+    if (current < 0 || remaining >= SCROLL_LEAD_MS)
+        return center(current);
+
+    double t = 1.0 - qMax(0, remaining) / static_cast<double>(SCROLL_LEAD_MS);
+    t = t * t * (3.0 - 2.0 * t);  // Smoothstep
+    return qRound(center(current) + (center(next) - center(current)) * t);
+}
+
+// ── Synchronisation ─────────────────────────────────────────────────
+
+void LyricsWidget::setPosition(int milliseconds)
+{
+    if (m_lines.isEmpty() || !m_hasSyncedLyrics) return;
+
+    int newLineIndex = findCurrentLineIndex(milliseconds);
 
     if (newLineIndex != m_currentLineIndex) {
+        const int previousLineIndex = m_currentLineIndex;
         m_currentLineIndex = newLineIndex;
-        emit debugLog(QString("[LyricsWidget] Position %1s -> line %2/%3: '%4'")
-                     .arg(seconds)
+        emit debugLog(QString("[LyricsWidget] Position %1ms -> line %2/%3: '%4'")
+                     .arg(milliseconds)
                      .arg(m_currentLineIndex)
                      .arg(m_lines.size() - 1)
                      .arg(m_currentLineIndex >= 0 && m_currentLineIndex < m_lines.size()
                           ? m_lines[m_currentLineIndex].text : "none"));
-        updateHighlight();
 
-        // Auto-scroll to current line
-        if (m_currentLineIndex >= 0 && m_currentLineIndex < m_lineLabels.size()) {
-            QLabel* currentLabel = m_lineLabels[m_currentLineIndex];
-            m_scrollArea->ensureWidgetVisible(currentLabel, 0, m_scrollArea->height() / 2);
-        }
+        // Just the line losing and the line gaining the highlight
+        updateLine(previousLineIndex);
+        updateLine(m_currentLineIndex);
     }
+
+    // Called at display rate by the lyrics window: follow the playback clock
+    const bool userScrolling = verticalScrollBar()->isSliderDown() ||
+                               (m_userScroll.isValid() && m_userScroll.elapsed() < USER_SCROLL_HOLD_MS);
+    if (!userScrolling)
+        verticalScrollBar()->setValue(followOffset(milliseconds));
 }
 
-int LyricsWidget::findCurrentLineIndex(int seconds) const
+int LyricsWidget::findCurrentLineIndex(int milliseconds) const
 {
     if (!m_hasSyncedLyrics) {
         // For plain text lyrics, don't highlight
         return -1;
     }
 
-    int milliseconds = seconds * 1000;
-    int currentIndex = -1;
-
-    for (int i = 0; i < m_lines.size(); ++i) {
-        if (m_lines[i].milliseconds <= milliseconds) {
-            currentIndex = i;
-        } else {
-            break;
-        }
-    }
-
-    return currentIndex;
-}
-
-void LyricsWidget::updateHighlight()
-{
-    // Reset all labels to default style
-    for (int i = 0; i < m_lineLabels.size(); ++i) {
-        if (i == m_currentLineIndex) {
-            // Highlight current line
-            m_lineLabels[i]->setStyleSheet(
-                "color: #ffffff; "
-                "background: #333; "
-                "border-radius: 4px; "
-                "padding: 8px; "
-                "font-weight: bold;"
-            );
-        } else {
-            // Dim non-current lines
-            m_lineLabels[i]->setStyleSheet("color: #888; padding: 4px;");
-        }
-    }
+    // Last line starting at or before the position
+    auto it = std::upper_bound(m_lines.cbegin(), m_lines.cend(), milliseconds,
+                               [](int ms, const LyricLine& line) { return ms < line.milliseconds; });
+    return static_cast<int>(it - m_lines.cbegin()) - 1;
 }
 
 void LyricsWidget::clear()
 {
-    // Clear all labels
-    qDeleteAll(m_lineLabels);
-    m_lineLabels.clear();
     m_lines.clear();
+    m_layouts.clear();
+    m_contentHeight = 0;
+    m_message = "No lyrics loaded";
     m_currentLineIndex = -1;
     m_hasSyncedLyrics = false;
+    m_userScroll.invalidate();
+    verticalScrollBar()->setRange(0, 0);
+    viewport()->update();
 }
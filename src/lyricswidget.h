@@ -1,19 +1,25 @@
 #ifndef LYRICSWIDGET_H
 #define LYRICSWIDGET_H
 
-#include <QWidget>
-#include <QScrollArea>
-#include <QVBoxLayout>
-#include <QLabel>
+#include <QAbstractScrollArea>
+#include <QElapsedTimer>
+#include <QFont>
 #include <QJsonArray>
+#include <QStaticText>
 #include <QVector>
 
 struct LyricLine {
     QString text;
-    int milliseconds;  // Timestamp in milliseconds
+    int milliseconds = -1;  // Timestamp in milliseconds (-1 = plain text)
 };
 
-class LyricsWidget : public QWidget
+/**
+ * Lyrics drawn directly on the viewport. Lines are laid out once per lyrics /
+ * width change (wrapped static texts for the normal and highlighted look);
+ * a line change repaints just the two lines involved, and the view scrolls
+ * smoothly to the next line as playback approaches it.
+ */
+class LyricsWidget : public QAbstractScrollArea
 {
     Q_OBJECT
 
@@ -21,26 +27,45 @@ public:
     explicit LyricsWidget(QWidget *parent = nullptr);
 
     void setLyrics(const QString& lyrics, const QJsonArray& syncedLyrics);
-    void setPosition(int seconds);
+    void setPosition(int milliseconds);
     void clear();
 
 signals:
     void debugLog(const QString& message);
 
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void wheelEvent(QWheelEvent *event) override;
+
 private:
+    struct LineLayout {
+        int top = 0;     // In content coordinates, without the view padding
+        int height = 0;  // Slot height, fits both looks
+        QStaticText text;
+        QStaticText highlighted;
+    };
+
     void parsePlainTextLyrics(const QString& lyrics);
     void parseSyncedLyrics(const QJsonArray& syncedLyrics);
-    void rebuildUI();
-    void updateHighlight();
-    int findCurrentLineIndex(int seconds) const;
-
-    QScrollArea* m_scrollArea;
-    QWidget* m_contentWidget;
-    QVBoxLayout* m_contentLayout;
-    QVector<QLabel*> m_lineLabels;
+    void relayout();
+    void updateLine(int index);
+    int findCurrentLineIndex(int milliseconds) const;
+    int followOffset(int milliseconds) const;
+    int topPadding() const;
+    QRect lineRect(int index) const;  // Viewport coordinates
+
     QVector<LyricLine> m_lines;
+    QVector<LineLayout> m_layouts;
+    int m_layoutWidth;
+    int m_contentHeight;
+    QString m_message;  // Shown instead of lines (nothing loaded / not available)
+    QFont m_font;
+    QFont m_highlightFont;
     int m_currentLineIndex;
     bool m_hasSyncedLyrics;
+    QElapsedTimer m_userScroll;  // Auto-follow pauses after manual scrolling
 };
 
 #endif // LYRICSWIDGET_H
@@ -21,6 +21,16 @@ LyricsWindow::LyricsWindow(QWidget *parent)
     // Forward debug logs
     connect(m_lyricsWidget, &LyricsWidget::debugLog, this, &LyricsWindow::debugLog);
 
+    // Display rate: the lyrics view scrolls smoothly with the clock
+    m_syncTimer = new QTimer(this);
+    m_syncTimer->setInterval(16);
+    m_syncTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_syncTimer, &QTimer::timeout, this, [this]() {
+        if (isVisible()) {
+            syncToClock();
+        }
+    });
+
     // Restore window geometry if saved
     QSettings settings;
     QByteArray geometry = settings.value("LyricsWindow/geometry").toByteArray();
@@ -45,6 +55,9 @@ void LyricsWindow::setAudioEngine(AudioEngine* engine)
         // Connect to position updates for synchronization
         connect(m_audioEngine, &AudioEngine::positionChanged,
                 this, &LyricsWindow::onPositionChanged);
+        connect(m_audioEngine, &AudioEngine::stateChanged,
+                this, &LyricsWindow::onStateChanged);
+        onStateChanged(m_audioEngine->state());
     }
 }
 
@@ -70,7 +83,26 @@ void LyricsWindow::onTrackChanged(std::shared_ptr<Track> track)
 
 void LyricsWindow::onPositionChanged(int seconds)
 {
-    m_lyricsWidget->setPosition(seconds);
+    // Whole seconds are too coarse for line timestamps: prefer the interpolated clock
+    if (m_audioEngine) {
+        syncToClock();
+    } else {
+        m_lyricsWidget->setPosition(seconds * 1000);
+    }
+}
+
+void LyricsWindow::syncToClock()
+{
+    m_lyricsWidget->setPosition(static_cast<int>(m_audioEngine->playbackClock().seconds() * 1000.0));
+}
+
+void LyricsWindow::onStateChanged(AudioEngine::PlaybackState state)
+{
+    if (state == AudioEngine::Playing) {
+        m_syncTimer->start();
+    } else {
+        m_syncTimer->stop();
+    }
 }
 
 void LyricsWindow::updateLyrics(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics)
@@ -4,6 +4,7 @@
 #include <QWidget>
 #include <QCloseEvent>
 #include <QJsonArray>
+#include <QTimer>
 #include <memory>
 #include "lyricswidget.h"
 #include "audioengine.h"
@@ -20,6 +21,7 @@ public:
     void setAudioEngine(AudioEngine* engine);
     void onTrackChanged(std::shared_ptr<Track> track);
     void onPositionChanged(int seconds);
+    void onStateChanged(AudioEngine::PlaybackState state);
     void updateLyrics(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics);
 
 protected:
@@ -30,9 +32,12 @@ signals:
     void debugLog(const QString& message);
 
 private:
+    void syncToClock();
+
     LyricsWidget* m_lyricsWidget;
     AudioEngine* m_audioEngine;
     QString m_currentTrackId;
+    QTimer* m_syncTimer;  // Polls the playback clock while playing (~60 Hz), for highlighting and scrolling
 };
 
 #endif // LYRICSWINDOW_H
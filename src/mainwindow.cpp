@@ -27,7 +27,7 @@
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
-    , m_audioEngine(new AudioEngine(this))
+    , m_audioEngine(new AudioEngine())  // Parentless so it can move to its control thread
     , m_deezerAPI(new DeezerAPI(this))
     , m_imageManager(new QNetworkAccessManager(this))
     , m_discordManager(new DiscordManager())
@@ -56,6 +56,9 @@ MainWindow::MainWindow(QWidget *parent)
     // Load audio output mode before initializing the engine
     {
         QSettings settings;
+        if (settings.value("Audio/engineThread", true).toBool())
+            m_audioEngine->startControlThread();
+
         int outputMode = settings.value("Audio/outputMode", 0).toInt();
         int wasapiDevice = settings.value("Audio/wasapiDeviceIndex", -1).toInt();
         if (outputMode >= 0 && outputMode <= 2) {
@@ -82,7 +85,11 @@ MainWindow::~MainWindow()
 {
     m_discordThread->quit();
     m_discordThread->wait();
+
+    // Back on this thread, the engine is torn down with the other children as before
+    m_audioEngine->stopControlThread();
     m_audioEngine->shutdown();
+    m_audioEngine->setParent(this);
 }
 
 void MainWindow::setupUI()
@@ -276,6 +283,12 @@ void MainWindow::setupMenus()
     m_gaplessAction = m_settingsMenu->addAction("Gapless Playback");
     m_gaplessAction->setCheckable(true);
     m_gaplessAction->setChecked(true);
+    m_normalizationAction = m_settingsMenu->addAction("Normalize Loudness");
+    m_normalizationAction->setCheckable(true);
+    m_normalizationAction->setChecked(false);
+    m_trimSilenceAction = m_settingsMenu->addAction("Trim Silence Between Tracks");
+    m_trimSilenceAction->setCheckable(true);
+    m_trimSilenceAction->setChecked(false);
     m_discordRpcAction = m_settingsMenu->addAction("Discord Presence");
     m_discordRpcAction->setCheckable(true);
     m_discordRpcAction->setChecked(true);
@@ -361,6 +374,8 @@ void MainWindow::setupMenus()
     connect(debugLogAction, &QAction::triggered, this, &MainWindow::onViewDebugLog);
     connect(aboutAction, &QAction::triggered, this, &MainWindow::onAboutClicked);
     connect(m_gaplessAction, &QAction::toggled, this, &MainWindow::onToggleGaplessClicked);
+    connect(m_normalizationAction, &QAction::toggled, this, &MainWindow::onToggleNormalizationClicked);
+    connect(m_trimSilenceAction, &QAction::toggled, this, &MainWindow::onToggleTrimSilenceClicked);
     connect(m_discordRpcAction, &QAction::toggled, this, &MainWindow::onToggleDiscordRpcClicked);
     connect(m_spectrumAction, &QAction::toggled, this, &MainWindow::onToggleSpectrumClicked);
     connect(m_lyricsAction, &QAction::toggled, this, &MainWindow::onToggleLyricsClicked);
@@ -402,6 +417,8 @@ void MainWindow::createConnections()
 
     // Search
     connect(m_searchWidget, &SearchWidget::trackDoubleClicked, this, &MainWindow::onTrackDoubleClicked);
+    connect(m_searchWidget, &SearchWidget::speculativePreloadRequested, m_audioEngine, &AudioEngine::speculativePreload);
+    connect(m_searchWidget, &SearchWidget::speculativePreloadCancelled, m_audioEngine, &AudioEngine::cancelSpeculativePreload);
     connect(m_searchWidget, &SearchWidget::albumDoubleClicked, this, &MainWindow::onAlbumDoubleClicked);
     connect(m_searchWidget, &SearchWidget::playlistDoubleClicked, this, &MainWindow::onPlaylistDoubleClicked);
     connect(m_searchWidget, &SearchWidget::debugLog, this, &MainWindow::onDebugLog);
@@ -528,21 +545,29 @@ void MainWindow::createConnections()
     connect(m_audioEngine, &AudioEngine::streamInfoChanged, m_queueHeader, &QueueHeaderWidget::setStreamInfo);
     
     // Sync queue widget in Now Playing tab
-    connect(m_audioEngine, &AudioEngine::trackChanged, [this](std::shared_ptr<Track> track) {
+    connect(m_audioEngine, &AudioEngine::trackChanged, this, [this](std::shared_ptr<Track> track) {
         if (track) m_queueWidget->setCurrentTrackId(track->id());
         // Flow: auto-fetch more tracks when reaching the last song
         if (m_flowMode && m_audioEngine->currentIndex() >= m_audioEngine->queue().size() - 1) {
             m_deezerAPI->getUserRadio();
         }
     });
-    connect(m_audioEngine, &AudioEngine::queueChanged, [this]() {
-        m_queueWidget->setTracks(m_audioEngine->queue());
-        if (m_audioEngine->currentTrack())
-            m_queueWidget->setCurrentTrackId(m_audioEngine->currentTrack()->id());
+    // Queue edits are replayed on the rows; a full reload only if the view fell out of step
+    connect(m_audioEngine, &AudioEngine::queueEdited, this, [this](const QueueChangeSet& changes) {
+        if (!m_queueWidget->applyQueueChanges(changes)) {
+            emit debugLog("[Queue] View out of sync with the engine, reloading");
+            m_queueWidget->setTracks(m_audioEngine->queue());
+        }
     });
     
     // Track from queue table in Now Playing
     connect(m_queueWidget, &TrackListWidget::trackDoubleClicked, this, &MainWindow::onTrackDoubleClicked);
+    connect(m_queueWidget, &TrackListWidget::speculativePreloadRequested, m_audioEngine, &AudioEngine::speculativePreload);
+    connect(m_queueWidget, &TrackListWidget::speculativePreloadCancelled, m_audioEngine, &AudioEngine::cancelSpeculativePreload);
+
+    // Hidden track list kept for the queue display: same speculative prefetch
+    connect(m_trackListWidget, &TrackListWidget::speculativePreloadRequested, m_audioEngine, &AudioEngine::speculativePreload);
+    connect(m_trackListWidget, &TrackListWidget::speculativePreloadCancelled, m_audioEngine, &AudioEngine::cancelSpeculativePreload);
 
     // Queue management - set queue widget to queue mode
     m_queueWidget->setMode(TrackListWidget::QueueMode);
@@ -555,7 +580,10 @@ void MainWindow::createConnections()
             m_audioEngine, QOverload<const QList<int>&>::of(&AudioEngine::removeFromQueue));
 
     connect(m_queueWidget, &TrackListWidget::moveRequested,
-            m_audioEngine, &AudioEngine::moveInQueue);
+            m_audioEngine, QOverload<int, int>::of(&AudioEngine::moveInQueue));
+
+    connect(m_queueWidget, &TrackListWidget::moveMultipleRequested,
+            m_audioEngine, QOverload<const QList<int>&, int>::of(&AudioEngine::moveInQueue));
 
     // Favorite toggle
     connect(m_queueWidget, &TrackListWidget::favoriteToggled,
@@ -570,8 +598,19 @@ void MainWindow::createConnections()
     });
 
     // Sync "Now Playing" visuals
-    connect(m_audioEngine, &AudioEngine::trackChanged, this, [this](std::shared_ptr<Track> track) {
+    connect(m_audioEngine, &AudioEngine::trackChanged, this,
+            [this](std::shared_ptr<Track> track, const QByteArray& embeddedData) {
         if (track) {
+            // Cover art embedded in the file saves a download, if it's big enough for this view
+            QPixmap embedded;
+            if (!embeddedData.isEmpty() && embedded.loadFromData(embeddedData) &&
+                qMin(embedded.width(), embedded.height()) >= 1000) {
+                m_largeAlbumArtLabel->setPixmap(embedded);
+                m_albumDominantColor = extractDominantColor(embedded);
+                updateAppBackground();
+                return;
+            }
+
             QString artUrl = track->albumArt();
             // Request higher resolution for the large Now Playing album art
             artUrl.replace("1000x1000", "1900x1900");
@@ -603,14 +642,10 @@ void MainWindow::createConnections()
         }
     });
 
-    connect(m_audioEngine, &AudioEngine::queueChanged, this, [this]() {
-        m_queueWidget->setTracks(m_audioEngine->queue());
-    });
-    
     connect(m_audioEngine, &AudioEngine::trackChanged, m_discordManager, [this](std::shared_ptr<Track> track) {
         // Capture data on UI thread
         bool isPlaying = (m_audioEngine->state() == AudioEngine::Playing);
-        int pos = m_audioEngine->positionSeconds();
+        int pos = static_cast<int>(m_audioEngine->playbackClock().seconds());
 
         QMetaObject::invokeMethod(m_discordManager, "updatePresence",
             Qt::QueuedConnection,
@@ -619,21 +654,19 @@ void MainWindow::createConnections()
             Q_ARG(int, pos));
     });
 
-    // Fetch lyrics when track changes
+    // Fetch lyrics when track changes (usually prefetched with the preload, so already there)
     connect(m_audioEngine, &AudioEngine::trackChanged, this, [this](std::shared_ptr<Track> track) {
         if (track && m_lyricsWindow) {
-            // Only fetch if lyrics window is open and track doesn't have lyrics cached
-            if (track->lyrics().isEmpty() && track->syncedLyrics().isEmpty()) {
-                m_deezerAPI->getLyrics(track->id());
-            }
+            fetchLyrics(track, false);
         }
     });
+    connect(m_audioEngine, &AudioEngine::preloadStarted, this, &MainWindow::onPreloadStarted);
 
     connect(m_audioEngine, &AudioEngine::stateChanged, m_discordManager, [this]() {
         // Capture data on UI thread
         auto track = m_audioEngine->currentTrack();
         bool isPlaying = (m_audioEngine->state() == AudioEngine::Playing);
-        int pos = m_audioEngine->positionSeconds();
+        int pos = static_cast<int>(m_audioEngine->playbackClock().seconds());
         
         QMetaObject::invokeMethod(m_discordManager, "updatePresence", 
             Qt::QueuedConnection, 
@@ -651,7 +684,7 @@ void MainWindow::createConnections()
     connect(m_lastFmAPI, &LastFmAPI::error, this, &MainWindow::onError);
 
     // Fetch scrobble data when queue changes
-    connect(m_audioEngine, &AudioEngine::queueChanged, this, &MainWindow::fetchScrobbleDataForQueue);
+    connect(m_audioEngine, &AudioEngine::queueEdited, this, &MainWindow::fetchScrobbleDataForQueue);
 }
 
 void MainWindow::onLoginClicked()
@@ -809,6 +842,25 @@ void MainWindow::onToggleGaplessClicked(bool checked)
     settings.setValue("Preferences/gaplessPlayback", checked);
 }
 
+void MainWindow::onToggleNormalizationClicked(bool checked)
+{
+    m_audioEngine->setLoudnessNormalization(checked);
+    statusBar()->showMessage(QString("Loudness Normalization: %1").arg(checked ? "Enabled" : "Disabled"));
+
+    QSettings settings;
+    settings.setValue("Preferences/loudnessNormalization", checked);
+}
+
+void MainWindow::onToggleTrimSilenceClicked(bool checked)
+{
+    m_audioEngine->setSilenceTrimming(checked);
+    statusBar()->showMessage(QString("Trim Silence Between Tracks: %1 (with gapless playback)")
+                             .arg(checked ? "Enabled" : "Disabled"));
+
+    QSettings settings;
+    settings.setValue("Preferences/trimSilence", checked);
+}
+
 void MainWindow::onToggleDiscordRpcClicked(bool checked)
 {
     QMetaObject::invokeMethod(m_discordManager, "setEnabled",
@@ -820,7 +872,7 @@ void MainWindow::onToggleDiscordRpcClicked(bool checked)
         // Force an immediate update
         auto track = m_audioEngine->currentTrack();
         bool isPlaying = (m_audioEngine->state() == AudioEngine::Playing);
-        int pos = m_audioEngine->positionSeconds();
+        int pos = static_cast<int>(m_audioEngine->playbackClock().seconds());
 
         QMetaObject::invokeMethod(m_discordManager, "updatePresence",
             Qt::QueuedConnection,
@@ -854,13 +906,11 @@ void MainWindow::onToggleSpectrumClicked(bool checked)
             }
         }
         m_spectrumWindow->show();
-        m_audioEngine->setSpectrumEnabled(true);
         statusBar()->showMessage("Spectrum Visualizer: Enabled");
     } else {
         if (m_spectrumWindow) {
             m_spectrumWindow->hide();
         }
-        m_audioEngine->setSpectrumEnabled(false);
         statusBar()->showMessage("Spectrum Visualizer: Disabled");
     }
 
@@ -897,11 +947,9 @@ void MainWindow::onToggleLyricsClicked(bool checked)
         // Fetch lyrics for current track if available
         auto currentTrack = m_audioEngine->currentTrack();
         if (currentTrack) {
-            if (currentTrack->lyrics().isEmpty() && currentTrack->syncedLyrics().isEmpty()) {
-                m_deezerAPI->getLyrics(currentTrack->id());
-            } else {
-                m_lyricsWindow->onTrackChanged(currentTrack);
-            }
+            // The window must know the track before fetched lyrics are delivered to it
+            m_lyricsWindow->onTrackChanged(currentTrack);
+            fetchLyrics(currentTrack, false);
         }
     } else {
         if (m_lyricsWindow) {
@@ -916,6 +964,40 @@ void MainWindow::onToggleLyricsClicked(bool checked)
 }
 
 void MainWindow::onLyricsReceived(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics)
+{
+    m_lyricsCache.insert(trackId, lyrics, syncedLyrics);
+    applyLyrics(trackId, lyrics, syncedLyrics);
+}
+
+void MainWindow::onPreloadStarted(std::shared_ptr<Track> track, std::shared_ptr<Track> followingTrack)
+{
+    if (!track || !m_lyricsWindow) {
+        return;
+    }
+
+    // The preloaded track and the one after it: their lyrics are ready when they start
+    fetchLyrics(track, true);
+    fetchLyrics(followingTrack, true);
+}
+
+void MainWindow::fetchLyrics(const std::shared_ptr<Track>& track, bool prefetch)
+{
+    if (!track || !track->lyrics().isEmpty() || !track->syncedLyrics().isEmpty()) {
+        return;
+    }
+
+    QString lyrics;
+    QJsonArray syncedLyrics;
+    if (m_lyricsCache.find(track->id(), &lyrics, &syncedLyrics)) {
+        track->setLyrics(lyrics);
+        track->setSyncedLyrics(syncedLyrics);
+        applyLyrics(track->id(), lyrics, syncedLyrics);
+        return;
+    }
+    m_deezerAPI->getLyrics(track->id(), prefetch);
+}
+
+void MainWindow::applyLyrics(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics)
 {
     // Update the track with lyrics
     auto currentTrack = m_audioEngine->currentTrack();
@@ -1244,6 +1326,14 @@ void MainWindow::loadSettings()
     m_gaplessAction->setChecked(gapless);
     m_audioEngine->setGaplessEnabled(gapless);
 
+    // Restore analysis-driven playback preferences
+    bool normalization = settings.value("Preferences/loudnessNormalization", false).toBool();
+    m_normalizationAction->setChecked(normalization);
+    m_audioEngine->setLoudnessNormalization(normalization);
+    bool trimSilence = settings.value("Preferences/trimSilence", false).toBool();
+    m_trimSilenceAction->setChecked(trimSilence);
+    m_audioEngine->setSilenceTrimming(trimSilence);
+
     // Restore Discord RPC preference
     bool discordEnabled = settings.value("Preferences/discordRPC", false).toBool();
     m_discordRpcAction->setChecked(discordEnabled);
@@ -1293,6 +1383,8 @@ void MainWindow::saveSettings()
 
     // Save preferences
     settings.setValue("Preferences/gaplessPlayback", m_gaplessAction->isChecked());
+    settings.setValue("Preferences/loudnessNormalization", m_normalizationAction->isChecked());
+    settings.setValue("Preferences/trimSilence", m_trimSilenceAction->isChecked());
     settings.setValue("Preferences/discordRPC", m_discordRpcAction->isChecked());
     settings.setValue("Preferences/spectrum", m_spectrumAction->isChecked());
     settings.setValue("Preferences/lyrics", m_lyricsAction->isChecked());
@@ -1551,11 +1643,8 @@ void MainWindow::fetchScrobbleDataForQueue()
         m_pendingScrobbleFetches.append(QPair<QString, QString>(artist, title));
     }
 
-    // Refresh queue widget to show cached data
-    m_queueWidget->setTracks(queue);
-    if (m_audioEngine->currentTrack()) {
-        m_queueWidget->setCurrentTrackId(m_audioEngine->currentTrack()->id());
-    }
+    // Show the cached counts (the queue view shares these Track objects)
+    m_queueWidget->refreshScrobbleCounts();
 
     // Calculate and update album scrobble count from tracks
     updateAlbumScrobbleCount();
@@ -1642,12 +1731,12 @@ void MainWindow::updateAppBackground()
 
         setStyleSheet(QString(
             "QMainWindow, QWidget, QSplitter, QTabWidget::pane, "
-            "QHeaderView, QHeaderView::section, QTableWidget "
+            "QHeaderView, QHeaderView::section, QTableView "
             "{ background-color: %1; color: %2; border: none; }"
             "QLabel { color: %2; }"
             "QHeaderView::section { color: %3; border: none; }"
-            "QTableWidget { color: %2; border: none; gridline-color: transparent; }"
-            "QTableWidget::item:selected { background-color: %4; }"
+            "QTableView { color: %2; border: none; gridline-color: transparent; }"
+            "QTableView::item:selected { background-color: %4; }"
             "QPushButton, QToolButton, QSlider, QComboBox, QLineEdit, QMenuBar, QMenu "
             "{ background-color: none; }"
             "QTabBar::tab { background: %5; color: %3; padding: 4px 12px; font-size: 11px; border: none; }"
@@ -24,6 +24,7 @@
 #include "queueheaderwidget.h"
 #include "projectmwindow.h"
 #include "recentwidget.h"
+#include "lyricscache.h"
 #include <QListWidget>
 
 class QDialog;
@@ -89,6 +90,8 @@ private slots:
     void onQuitClicked();
     void onAboutClicked();
     void onToggleGaplessClicked(bool checked);
+    void onToggleNormalizationClicked(bool checked);
+    void onToggleTrimSilenceClicked(bool checked);
     void onToggleDiscordRpcClicked(bool checked);
     void onToggleSpectrumClicked(bool checked);
     void onToggleLyricsClicked(bool checked);
@@ -119,6 +122,7 @@ private slots:
 
     // Lyrics
     void onLyricsReceived(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics);
+    void onPreloadStarted(std::shared_ptr<Track> track, std::shared_ptr<Track> followingTrack);
 
     // Error handling
     void onError(const QString& error);
@@ -154,6 +158,8 @@ private:
     void autoLogin();
     QColor extractDominantColor(const QPixmap& pixmap);
     void updateAppBackground();
+    void fetchLyrics(const std::shared_ptr<Track>& track, bool prefetch);  // Cache first, then Deezer
+    void applyLyrics(const QString& trackId, const QString& lyrics, const QJsonArray& syncedLyrics);
 
     // Core components
     AudioEngine* m_audioEngine;
@@ -194,6 +200,8 @@ private:
     QAction* m_loginAction;
     QAction* m_logoutAction;
     QAction* m_gaplessAction;
+    QAction* m_normalizationAction;
+    QAction* m_trimSilenceAction;
     QAction* m_discordRpcAction;
     QAction* m_spectrumAction;
     QAction* m_lyricsAction;
@@ -213,6 +221,7 @@ private:
 
     class SpectrumWindow* m_spectrumWindow = nullptr;
     class LyricsWindow* m_lyricsWindow = nullptr;
+    LyricsCache m_lyricsCache;
     ProjectMWindow* m_projectMWindow = nullptr;
 
     // Last.fm integration
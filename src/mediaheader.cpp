@@ -0,0 +1,569 @@
+#include "mediaheader.h"
+#include <cstring>
+
+// Audio bytes buffered after the header before the stream is created. BASS reads
+// the first frames during creation (MPEG sync/Xing header, FLAC frame header);
+// 64KB covers several frames at any bitrate Deezer serves.
+static constexpr qint64 FIRST_FRAMES_BYTES = 65536;
+
+// Enough to recognize any of the supported containers
+static constexpr qint64 MIN_PROBE_BYTES = 12;
+
+// The first MPEG frame, including a Xing TOC or a typical VBRI table
+static constexpr qint64 MPEG_FIRST_FRAME_BYTES = 2048;
+
+static quint32 readBE24(const uchar* p)
+{
+    return (quint32(p[0]) << 16) | (quint32(p[1]) << 8) | quint32(p[2]);
+}
+
+static quint32 readBE32(const uchar* p)
+{
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+static quint64 readBE64(const uchar* p)
+{
+    return (quint64(readBE32(p)) << 32) | quint64(readBE32(p + 4));
+}
+
+// ID3v2 sizes use 7 bits per byte
+static quint32 readSyncsafe32(const uchar* p)
+{
+    return (quint32(p[0] & 0x7F) << 21) | (quint32(p[1] & 0x7F) << 14) |
+           (quint32(p[2] & 0x7F) << 7) | quint32(p[3] & 0x7F);
+}
+
+static bool isMpegFrameSync(const uchar* p)
+{
+    // 11 sync bits, version != reserved, layer != reserved
+    return p[0] == 0xFF && (p[1] & 0xE0) == 0xE0 &&
+           ((p[1] >> 3) & 0x03) != 0x01 && ((p[1] >> 1) & 0x03) != 0x00;
+}
+
+// Keep the first picture, but let a front cover (picture type 3) replace any other
+static void offerCover(MediaHeaderInfo& info, int& bestType, int pictureType,
+                       const uchar* data, qint64 length, const QString& mimeType)
+{
+    if (length <= 0)
+        return;
+    if (info.coverArt.isEmpty() || (pictureType == 3 && bestType != 3)) {
+        info.coverArt = QByteArray(reinterpret_cast<const char*>(data), static_cast<int>(length));
+        info.coverMimeType = mimeType;
+        bestType = pictureType;
+    }
+}
+
+// ── ID3v2 ───────────────────────────────────────────────────────────────
+
+static void parseId3v2Pictures(const uchar* tag, qint64 tagSize, MediaHeaderInfo& info)
+{
+    const int major = tag[3];
+    const quint8 flags = tag[5];
+    if (major < 2 || major > 4)
+        return;
+    if ((flags & 0x80) && major < 4)
+        return;  // Tag-wide unsynchronisation (rare): not worth decoding for a cover
+
+    qint64 pos = 10;
+    if ((flags & 0x40) && major >= 3) {
+        if (pos + 4 > tagSize)
+            return;
+        pos += (major == 4) ? readSyncsafe32(tag + pos) : readBE32(tag + pos) + 4;
+    }
+
+    const int headerLen = (major == 2) ? 6 : 10;
+    int bestType = -1;
+
+    while (pos + headerLen <= tagSize) {
+        const uchar* frame = tag + pos;
+        if (frame[0] == 0)
+            break;  // Padding
+
+        qint64 frameSize = (major == 2) ? readBE24(frame + 3)
+                         : (major == 4) ? readSyncsafe32(frame + 4)
+                         : readBE32(frame + 4);
+        const qint64 bodyStart = pos + headerLen;
+        if (frameSize <= 0 || bodyStart + frameSize > tagSize)
+            break;
+        pos = bodyStart + frameSize;
+
+        const bool isPicture = (major == 2) ? std::memcmp(frame, "PIC", 3) == 0
+                                            : std::memcmp(frame, "APIC", 4) == 0;
+        if (!isPicture)
+            continue;
+
+        const quint16 frameFlags = (major == 2) ? 0 : quint16((frame[8] << 8) | frame[9]);
+        const uchar* body = tag + bodyStart;
+        qint64 i = 0;
+        if (major == 3) {
+            if (frameFlags & 0x00C0)
+                continue;  // Compressed or encrypted
+            if (frameFlags & 0x0020)
+                i += 1;    // Group identifier
+        } else if (major == 4) {
+            if (frameFlags & 0x000E)
+                continue;  // Compressed, encrypted or unsynchronised
+            if (frameFlags & 0x0040)
+                i += 1;    // Group identifier
+            if (frameFlags & 0x0001)
+                i += 4;    // Data length indicator
+        }
+        if (i >= frameSize)
+            continue;
+
+        const int encoding = body[i++];
+        QString mimeType;
+        if (major == 2) {
+            if (i + 3 > frameSize)
+                continue;
+            mimeType = std::memcmp(body + i, "PNG", 3) == 0 ? QStringLiteral("image/png")
+                                                             : QStringLiteral("image/jpeg");
+            i += 3;
+        } else {
+            qint64 end = i;
+            while (end < frameSize && body[end])
+                ++end;
+            mimeType = QString::fromLatin1(reinterpret_cast<const char*>(body + i), static_cast<int>(end - i));
+            i = end + 1;
+        }
+        if (i >= frameSize || mimeType == QLatin1String("-->"))
+            continue;  // Truncated, or a link to an external file
+
+        const int pictureType = body[i++];
+
+        // Description: terminated by 0x00, or 0x00 0x00 for the UTF-16 encodings
+        if (encoding == 1 || encoding == 2) {
+            while (i + 1 < frameSize && (body[i] || body[i + 1]))
+                i += 2;
+            i += 2;
+        } else {
+            while (i < frameSize && body[i])
+                ++i;
+            i += 1;
+        }
+
+        if (i < frameSize)
+            offerCover(info, bestType, pictureType, body + i, frameSize - i, mimeType);
+    }
+}
+
+// ── FLAC ────────────────────────────────────────────────────────────────
+
+static void parseFlacPicture(const uchar* block, qint64 length, MediaHeaderInfo& info, int& bestType)
+{
+    qint64 pos = 0;
+    if (pos + 8 > length)
+        return;
+    const int pictureType = static_cast<int>(readBE32(block));
+    const qint64 mimeLength = readBE32(block + 4);
+    pos = 8;
+    if (pos + mimeLength + 4 > length)
+        return;
+    const QString mimeType = QString::fromLatin1(reinterpret_cast<const char*>(block + pos), static_cast<int>(mimeLength));
+    pos += mimeLength;
+    const qint64 descLength = readBE32(block + pos);
+    pos += 4 + descLength;
+    pos += 16;  // Width, height, colour depth, palette size
+    if (pos + 4 > length)
+        return;
+    const qint64 dataLength = readBE32(block + pos);
+    pos += 4;
+    if (pos + dataLength > length)
+        return;
+    offerCover(info, bestType, pictureType, block + pos, dataLength, mimeType);
+}
+
+// STREAMINFO: sample rate (20 bits) and total samples (36 bits) at byte 10
+static void parseFlacStreamInfo(const uchar* block, qint64 length, MediaHeaderInfo& info)
+{
+    if (length < 18)
+        return;
+    info.sampleRate = static_cast<int>((quint32(block[10]) << 12) | (quint32(block[11]) << 4) | (block[12] >> 4));
+    info.totalSamples = (qint64(block[13] & 0x0F) << 32) | qint64(readBE32(block + 14));
+}
+
+// SEEKTABLE: 18-byte points (sample, offset from the first frame, frame samples)
+static void parseFlacSeekTable(const uchar* block, qint64 length, MediaHeaderInfo& info)
+{
+    for (qint64 pos = 0; pos + 18 <= length; pos += 18) {
+        const quint64 sample = readBE64(block + pos);
+        if (sample == 0xFFFFFFFFFFFFFFFFULL)
+            continue;  // Placeholder
+        const qint64 offset = static_cast<qint64>(readBE64(block + pos + 8));
+        if (!info.seekPoints.isEmpty() &&
+            (qint64(sample) <= info.seekPoints.last().sample || offset < info.seekPoints.last().offset)) {
+            continue;
+        }
+        info.seekPoints.append({ static_cast<qint64>(sample), offset });
+    }
+}
+
+static void parseFlac(const uchar* p, qint64 size, qint64 start, MediaHeaderInfo& info)
+{
+    info.container = MediaHeaderInfo::Flac;
+    int bestType = -1;
+
+    // Metadata blocks follow the "fLaC" marker; the last one has bit 7 set
+    qint64 pos = start + 4;
+    while (true) {
+        if (pos + 4 > size) {
+            info.bytesNeeded = pos + 4;
+            return;
+        }
+        const bool last = (p[pos] & 0x80) != 0;
+        const int type = p[pos] & 0x7F;
+        const qint64 blockEnd = pos + 4 + readBE24(p + pos + 1);
+        if (type == 127) {
+            info.container = MediaHeaderInfo::Unknown;  // Invalid block type
+            info.complete = true;
+            return;
+        }
+        if (blockEnd > size) {
+            info.bytesNeeded = blockEnd + (last ? 0 : 4);
+            return;
+        }
+        if (type == 0)
+            parseFlacStreamInfo(p + pos + 4, blockEnd - pos - 4, info);
+        else if (type == 3)
+            parseFlacSeekTable(p + pos + 4, blockEnd - pos - 4, info);
+        else if (type == 6)
+            parseFlacPicture(p + pos + 4, blockEnd - pos - 4, info, bestType);
+        pos = blockEnd;
+        if (last)
+            break;
+    }
+
+    // Seek point offsets are relative to the first frame
+    for (MediaHeaderInfo::SeekPoint& point : info.seekPoints)
+        point.offset += pos;
+    if (info.seekPoints.isEmpty() || info.seekPoints.first().sample > 0)
+        info.seekPoints.prepend({ 0, pos });
+
+    info.audioStart = pos;
+    info.bytesNeeded = pos + FIRST_FRAMES_BYTES;
+    info.complete = true;
+}
+
+// ── MPEG audio ──────────────────────────────────────────────────────────
+
+// Frame header fields plus the Xing/Info or VBRI header of the first frame
+static void parseMpegFirstFrame(const uchar* p, qint64 size, qint64 start, MediaHeaderInfo& info)
+{
+    static const int BITRATES_V1[3][16] = {
+        { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },  // Layer I
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },     // Layer II
+        { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },      // Layer III
+    };
+    static const int BITRATES_V2[2][16] = {
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },     // Layer I
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },          // Layer II/III
+    };
+    static const int SAMPLE_RATES[3] = { 44100, 48000, 32000 };
+
+    const uchar* h = p + start;
+    const int version = (h[1] >> 3) & 0x03;  // 0 = 2.5, 2 = 2, 3 = 1
+    const int layer = 4 - ((h[1] >> 1) & 0x03);
+    const int bitrateIndex = h[2] >> 4;
+    const int rateIndex = (h[2] >> 2) & 0x03;
+    const bool mono = (h[3] >> 6) == 0x03;
+    if (rateIndex == 3)
+        return;
+
+    const bool mpeg1 = version == 3;
+    info.sampleRate = SAMPLE_RATES[rateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+    info.bitrate = 1000 * (mpeg1 ? BITRATES_V1[layer - 1][bitrateIndex]
+                                 : BITRATES_V2[layer == 1 ? 0 : 1][bitrateIndex]);
+    const int samplesPerFrame = layer == 1 ? 384 : (layer == 3 && !mpeg1) ? 576 : 1152;
+
+    // Xing/Info sits after the side information of the first frame
+    const qint64 xing = start + 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+    if (xing + 8 <= size && (std::memcmp(p + xing, "Xing", 4) == 0 || std::memcmp(p + xing, "Info", 4) == 0)) {
+        const quint32 flags = readBE32(p + xing + 4);
+        qint64 pos = xing + 8;
+        qint64 frames = 0;
+        qint64 bytes = 0;
+        if ((flags & 0x1) && pos + 4 <= size) {
+            frames = readBE32(p + pos);
+            pos += 4;
+        }
+        if ((flags & 0x2) && pos + 4 <= size) {
+            bytes = readBE32(p + pos);
+            pos += 4;
+        }
+        if (frames > 0)
+            info.totalSamples = frames * samplesPerFrame;
+
+        info.seekPoints.clear();
+        info.seekPoints.append({ 0, start });
+        if ((flags & 0x4) && pos + 100 <= size && frames > 0 && bytes > 0) {
+            // 100 entries: byte position (1/256 of the file) at each percent of the duration
+            for (int i = 1; i < 100; ++i) {
+                const MediaHeaderInfo::SeekPoint point = { info.totalSamples * i / 100,
+                                                           start + bytes * p[pos + i] / 256 };
+                if (point.offset >= info.seekPoints.last().offset)
+                    info.seekPoints.append(point);
+            }
+        }
+        if (frames > 0 && bytes > 0)
+            info.seekPoints.append({ info.totalSamples, start + bytes });
+        if (info.seekPoints.size() < 2)
+            info.seekPoints.clear();
+        return;
+    }
+
+    // VBRI (Fraunhofer) sits 32 bytes after the frame header
+    const qint64 vbri = start + 4 + 32;
+    if (vbri + 26 <= size && std::memcmp(p + vbri, "VBRI", 4) == 0) {
+        const qint64 bytes = readBE32(p + vbri + 10);
+        const qint64 frames = readBE32(p + vbri + 14);
+        const int entries = (p[vbri + 18] << 8) | p[vbri + 19];
+        const int scale = (p[vbri + 20] << 8) | p[vbri + 21];
+        const int entrySize = (p[vbri + 22] << 8) | p[vbri + 23];
+        const int framesPerEntry = (p[vbri + 24] << 8) | p[vbri + 25];
+        if (frames > 0)
+            info.totalSamples = frames * samplesPerFrame;
+
+        // Each entry is the byte size of the next framesPerEntry frames
+        info.seekPoints.clear();
+        info.seekPoints.append({ 0, start });
+        qint64 pos = vbri + 26;
+        qint64 offset = start;
+        if (entrySize >= 1 && entrySize <= 4 && framesPerEntry > 0) {
+            for (int i = 0; i < entries && pos + entrySize <= size; ++i, pos += entrySize) {
+                qint64 length = 0;
+                for (int b = 0; b < entrySize; ++b)
+                    length = (length << 8) | p[pos + b];
+                offset += length * scale;
+                info.seekPoints.append({ qint64(i + 1) * framesPerEntry * samplesPerFrame, offset });
+            }
+        }
+        if (frames > 0 && bytes > 0 && info.seekPoints.last().sample < info.totalSamples)
+            info.seekPoints.append({ info.totalSamples, start + bytes });
+        if (info.seekPoints.size() < 2)
+            info.seekPoints.clear();
+    }
+}
+
+// ── MP4 ─────────────────────────────────────────────────────────────────
+
+// Find a child box inside a container payload; returns its payload
+static const uchar* findMp4Box(const uchar* p, qint64 size, const char* type, qint64* payloadSize)
+{
+    qint64 pos = 0;
+    while (pos + 8 <= size) {
+        qint64 boxSize = readBE32(p + pos);
+        qint64 headerLen = 8;
+        if (boxSize == 1) {
+            if (pos + 16 > size)
+                return nullptr;
+            boxSize = static_cast<qint64>(readBE64(p + pos + 8));
+            headerLen = 16;
+        } else if (boxSize == 0) {
+            boxSize = size - pos;
+        }
+        if (boxSize < headerLen || pos + boxSize > size)
+            return nullptr;
+        if (std::memcmp(p + pos + 4, type, 4) == 0) {
+            *payloadSize = boxSize - headerLen;
+            return p + pos + headerLen;
+        }
+        pos += boxSize;
+    }
+    return nullptr;
+}
+
+static void parseMp4Cover(const uchar* moov, qint64 moovSize, MediaHeaderInfo& info)
+{
+    qint64 size = 0;
+    const uchar* udta = findMp4Box(moov, moovSize, "udta", &size);
+    if (!udta)
+        return;
+    const uchar* meta = findMp4Box(udta, size, "meta", &size);
+    if (!meta)
+        return;
+    // iTunes 'meta' is a full box (4 bytes version/flags before the children)
+    if (size >= 12 && std::memcmp(meta + 8, "hdlr", 4) == 0) {
+        meta += 4;
+        size -= 4;
+    }
+    const uchar* ilst = findMp4Box(meta, size, "ilst", &size);
+    if (!ilst)
+        return;
+    const uchar* covr = findMp4Box(ilst, size, "covr", &size);
+    if (!covr)
+        return;
+    const uchar* data = findMp4Box(covr, size, "data", &size);
+    if (!data || size <= 8)
+        return;
+
+    // 'data' payload: type indicator (13 = JPEG, 14 = PNG), locale, image bytes
+    const quint32 dataType = readBE32(data) & 0x00FFFFFF;
+    const QString mimeType = dataType == 14 ? QStringLiteral("image/png") : QStringLiteral("image/jpeg");
+    int bestType = -1;
+    offerCover(info, bestType, 3, data + 8, size - 8, mimeType);
+}
+
+static void parseMp4(const uchar* p, qint64 size, MediaHeaderInfo& info)
+{
+    info.container = MediaHeaderInfo::Mp4;
+    bool haveMoov = false;
+
+    qint64 pos = 0;
+    while (true) {
+        if (pos + 16 > size) {
+            info.bytesNeeded = pos + 16;
+            return;
+        }
+        qint64 boxSize = readBE32(p + pos);
+        qint64 headerLen = 8;
+        if (boxSize == 1) {
+            boxSize = static_cast<qint64>(readBE64(p + pos + 8));
+            headerLen = 16;
+        }
+        const uchar* type = p + pos + 4;
+
+        if (std::memcmp(type, "mdat", 4) == 0) {
+            info.complete = true;
+            if (!haveMoov) {
+                // Sample tables come after the media data: BASS needs the whole file
+                info.needsWholeFile = true;
+                return;
+            }
+            info.audioStart = pos + headerLen;
+            info.bytesNeeded = info.audioStart + FIRST_FRAMES_BYTES;
+            return;
+        }
+        if (boxSize < headerLen) {
+            info.container = MediaHeaderInfo::Unknown;  // Corrupt or size-to-EOF box before 'mdat'
+            info.complete = true;
+            return;
+        }
+        if (std::memcmp(type, "moov", 4) == 0) {
+            if (pos + boxSize > size) {
+                info.bytesNeeded = pos + boxSize;
+                return;
+            }
+            haveMoov = true;
+            parseMp4Cover(p + pos + headerLen, boxSize - headerLen, info);
+        }
+        pos += boxSize;
+    }
+}
+
+// ── Entry point ─────────────────────────────────────────────────────────
+
+MediaHeaderInfo parseMediaHeader(const QByteArray& data)
+{
+    MediaHeaderInfo info;
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    const qint64 size = data.size();
+
+    if (size < MIN_PROBE_BYTES) {
+        info.bytesNeeded = MIN_PROBE_BYTES;
+        return info;
+    }
+
+    // An ID3v2 tag may precede MPEG audio (and, rarely, FLAC)
+    qint64 offset = 0;
+    bool hasId3 = false;
+    if (std::memcmp(p, "ID3", 3) == 0) {
+        hasId3 = true;
+        offset = 10 + readSyncsafe32(p + 6) + ((p[5] & 0x10) ? 10 : 0);  // Header + body + footer
+        if (offset + MIN_PROBE_BYTES > size) {
+            info.container = MediaHeaderInfo::Mpeg;  // Most likely; confirmed once the tag is complete
+            info.bytesNeeded = offset + MIN_PROBE_BYTES;
+            return info;
+        }
+        parseId3v2Pictures(p, offset, info);
+    }
+
+    if (std::memcmp(p + offset, "fLaC", 4) == 0) {
+        parseFlac(p, size, offset, info);
+        return info;
+    }
+    if (!hasId3 && std::memcmp(p + 4, "ftyp", 4) == 0) {
+        parseMp4(p, size, info);
+        return info;
+    }
+
+    // MPEG audio: the first frame may sit behind padding that the tag size doesn't cover
+    const qint64 scanEnd = qMin(size - 1, offset + 4096);
+    for (qint64 i = offset; i < scanEnd; ++i) {
+        if (isMpegFrameSync(p + i)) {
+            info.container = MediaHeaderInfo::Mpeg;
+            if (i + MPEG_FIRST_FRAME_BYTES > size) {
+                info.bytesNeeded = i + MPEG_FIRST_FRAME_BYTES;  // Wait for the Xing/VBRI header
+                return info;
+            }
+            parseMpegFirstFrame(p, size, i, info);
+            info.audioStart = i;
+            info.bytesNeeded = i + FIRST_FRAMES_BYTES;
+            info.complete = true;
+            return info;
+        }
+    }
+    if (hasId3) {
+        // Tag present but no frame sync nearby: let BASS look for it
+        info.container = MediaHeaderInfo::Mpeg;
+        info.audioStart = offset;
+        info.bytesNeeded = offset + FIRST_FRAMES_BYTES;
+        info.complete = true;
+        return info;
+    }
+
+    info.complete = true;  // Not recognized: caller falls back to trial-and-error stream creation
+    return info;
+}
+
+// ── Seek index ──────────────────────────────────────────────────────────
+
+double MediaHeaderInfo::durationSeconds() const
+{
+    if (sampleRate <= 0 || totalSamples <= 0)
+        return 0.0;
+    return static_cast<double>(totalSamples) / sampleRate;
+}
+
+// Index of the segment [i, i + 1] to interpolate on; the last one extrapolates
+static int seekSegment(const QVector<MediaHeaderInfo::SeekPoint>& points, double value, bool bySample)
+{
+    int i = 0;
+    while (i + 2 < points.size() &&
+           (bySample ? points[i + 1].sample : points[i + 1].offset) <= value) {
+        ++i;
+    }
+    return i;
+}
+
+qint64 MediaHeaderInfo::byteForTime(double seconds) const
+{
+    if (sampleRate > 0 && seekPoints.size() >= 2) {
+        const double sample = qMax(0.0, seconds) * sampleRate;
+        const int i = seekSegment(seekPoints, sample, true);
+        const SeekPoint& a = seekPoints[i];
+        const SeekPoint& b = seekPoints[i + 1];
+        if (b.sample <= a.sample)
+            return a.offset;
+        return a.offset + static_cast<qint64>((sample - a.sample) * (b.offset - a.offset) / (b.sample - a.sample));
+    }
+    if (bitrate > 0)
+        return audioStart + static_cast<qint64>(qMax(0.0, seconds) * bitrate / 8.0);  // CBR
+    return -1;
+}
+
+double MediaHeaderInfo::timeForByte(qint64 offset) const
+{
+    if (sampleRate > 0 && seekPoints.size() >= 2) {
+        const int i = seekSegment(seekPoints, static_cast<double>(offset), false);
+        const SeekPoint& a = seekPoints[i];
+        const SeekPoint& b = seekPoints[i + 1];
+        if (b.offset <= a.offset)
+            return static_cast<double>(a.sample) / sampleRate;
+        const double sample = a.sample + static_cast<double>(offset - a.offset) * (b.sample - a.sample) / (b.offset - a.offset);
+        return qMax(0.0, sample / sampleRate);
+    }
+    if (bitrate > 0)
+        return qMax(0.0, static_cast<double>(offset - audioStart) * 8.0 / bitrate);
+    return -1.0;
+}
@@ -0,0 +1,45 @@
+#ifndef MEDIAHEADER_H
+#define MEDIAHEADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Result of parsing the start of an audio file (FLAC metadata blocks, ID3v2 tag,
+// MP4 boxes). Tells how many bytes must be buffered before BASS can create a
+// stream, so progressive playback attempts stream creation exactly once.
+struct MediaHeaderInfo {
+    enum Container { Unknown, Flac, Mpeg, Mp4 };
+
+    Container container = Unknown;
+    bool complete = false;        // Header fully parsed (or format not recognized)
+    bool needsWholeFile = false;  // MP4 with 'moov' after 'mdat': not streamable
+    qint64 audioStart = 0;        // Offset of the first audio frame (MP4: 'mdat' payload)
+    qint64 bytesNeeded = 0;       // Bytes to buffer before creating the stream
+
+    // Embedded front cover (FLAC PICTURE, ID3v2 APIC/PIC, MP4 'covr'), if any
+    QByteArray coverArt;
+    QString coverMimeType;
+
+    // Timing from FLAC STREAMINFO or the MPEG Xing/Info/VBRI header (0 = unknown)
+    int sampleRate = 0;
+    qint64 totalSamples = 0;
+    int bitrate = 0;  // MPEG: bits/s of the first frame, for CBR files without a TOC
+
+    // Seek index (FLAC SEEKTABLE, Xing TOC, VBRI table): ascending sample -> file offset
+    struct SeekPoint {
+        qint64 sample;
+        qint64 offset;
+    };
+    QVector<SeekPoint> seekPoints;
+
+    double durationSeconds() const;             // 0 if unknown
+    qint64 byteForTime(double seconds) const;   // -1 if there is no index
+    double timeForByte(qint64 offset) const;    // -1 if there is no index
+};
+
+// Parse as much of the header as data contains. When the header is cut off,
+// complete is false and bytesNeeded is the next size worth re-parsing at.
+MediaHeaderInfo parseMediaHeader(const QByteArray& data);
+
+#endif // MEDIAHEADER_H
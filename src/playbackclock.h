@@ -0,0 +1,104 @@
+#ifndef PLAYBACKCLOCK_H
+#define PLAYBACKCLOCK_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/**
+ * Playback position published by the mixer thread, readable from any thread
+ * without locks or BASS calls. Each publish stores the source position together
+ * with a steady-clock timestamp (seqlock); readers extrapolate from that pair
+ * while playing, so UI playheads can run at display rate between mixer updates.
+ */
+class PlaybackClock
+{
+public:
+    // Store a new anchor. Usually called from the mixer DSP; the engine also
+    // calls it on seek / track change so readers jump immediately.
+    void publish(double seconds)
+    {
+        const qint64 now = nowNs();
+
+        // Writers exclude each other by taking the sequence to an odd value
+        quint32 seq = m_seq.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1) == 0 &&
+                m_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+                break;
+            std::this_thread::yield();
+            seq = m_seq.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_seconds.store(seconds, std::memory_order_relaxed);
+        m_timestampNs.store(now, std::memory_order_relaxed);
+
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Running = the mixer is producing audio, so readers may extrapolate.
+    // Stopping freezes the clock at the current extrapolated position.
+    void setRunning(bool running)
+    {
+        if (!running && m_running.load(std::memory_order_relaxed))
+            publish(seconds());
+        m_running.store(running, std::memory_order_release);
+    }
+
+    void setLengthSeconds(double seconds) { m_lengthSeconds.store(seconds, std::memory_order_relaxed); }
+
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+    double lengthSeconds() const { return m_lengthSeconds.load(std::memory_order_relaxed); }
+
+    // Current position in seconds, extrapolated from the last anchor
+    double seconds() const
+    {
+        double anchor;
+        qint64 timestamp;
+        quint32 before, after;
+        do {
+            before = m_seq.load(std::memory_order_acquire);
+            anchor = m_seconds.load(std::memory_order_relaxed);
+            timestamp = m_timestampNs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        if (!m_running.load(std::memory_order_acquire))
+            return anchor;
+
+        // Cap so a stalled mixer (underrun, device switch) doesn't run the playhead away
+        const qint64 elapsed = qBound<qint64>(0, nowNs() - timestamp, MAX_EXTRAPOLATION_NS);
+        return anchor + static_cast<double>(elapsed) / 1e9;
+    }
+
+    // 0.0-1.0 of the track length (0 while the length is unknown)
+    double fraction() const
+    {
+        const double length = lengthSeconds();
+        if (length <= 0.0)
+            return 0.0;
+        return qBound(0.0, seconds() / length, 1.0);
+    }
+
+    static qint64 nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    // Longer than any mixer update / WASAPI period, short enough to hide stalls
+    static constexpr qint64 MAX_EXTRAPOLATION_NS = 250'000'000;
+
+    std::atomic<quint32> m_seq{0};
+    std::atomic<double> m_seconds{0.0};
+    std::atomic<qint64> m_timestampNs{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<double> m_lengthSeconds{0.0};
+};
+
+#endif // PLAYBACKCLOCK_H
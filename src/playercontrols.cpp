@@ -80,6 +80,11 @@ PlayerControls::PlayerControls(QWidget *parent)
 
     connect(m_volumeSlider, &QSlider::valueChanged, this, &PlayerControls::onVolumeSliderChanged);
     connect(m_repeatButton, &QPushButton::clicked, this, &PlayerControls::onRepeatClicked);
+
+    m_playheadTimer = new QTimer(this);
+    m_playheadTimer->setTimerType(Qt::PreciseTimer);
+    m_playheadTimer->setInterval(16);
+    connect(m_playheadTimer, &QTimer::timeout, this, &PlayerControls::onPlayheadFrame);
 }
 
 void PlayerControls::setAudioEngine(AudioEngine* engine)
@@ -117,8 +122,13 @@ void PlayerControls::onPlayPauseClicked()
 
 void PlayerControls::onStateChanged(AudioEngine::PlaybackState state)
 {
-    Q_UNUSED(state);
     updatePlayPauseButton();
+
+    if (state == AudioEngine::Playing) {
+        m_playheadTimer->start();
+    } else {
+        m_playheadTimer->stop();
+    }
 }
 
 void PlayerControls::onTrackChanged(std::shared_ptr<Track> track)
@@ -133,6 +143,7 @@ void PlayerControls::onTrackChanged(std::shared_ptr<Track> track)
             .arg(track->title());
         m_trackInfoLabel->setText(info);
         m_durationLabel->setText(track->durationString());
+        m_waveformWidget->setVisibleRange(0.0, 1.0);
     } else {
         m_trackInfoLabel->setText("No track loaded");
         m_durationLabel->setText("0:00");
@@ -152,9 +163,17 @@ void PlayerControls::onPositionTick(double position)
     m_waveformWidget->setPosition(position);
 }
 
-void PlayerControls::onWaveformReady(const QVector<float>& peaks)
+void PlayerControls::onPlayheadFrame()
+{
+    if (!m_audioEngine || !isVisible()) {
+        return;
+    }
+    m_waveformWidget->setPosition(m_audioEngine->playbackClock().fraction());
+}
+
+void PlayerControls::onWaveformReady(const WaveformPyramid& waveform)
 {
-    m_waveformWidget->setPeaks(peaks);
+    m_waveformWidget->setWaveform(waveform);
 }
 
 void PlayerControls::onVolumeSliderChanged(int value)
@@ -5,6 +5,7 @@
 #include <QPushButton>
 #include <QSlider>
 #include <QLabel>
+#include <QTimer>
 #include "audioengine.h"
 #include "waveformwidget.h"
 
@@ -33,7 +34,8 @@ private slots:
     void onTrackChanged(std::shared_ptr<Track> track);
     void onPositionChanged(int seconds);
     void onPositionTick(double position);
-    void onWaveformReady(const QVector<float>& peaks);
+    void onPlayheadFrame();
+    void onWaveformReady(const WaveformPyramid& waveform);
     void onVolumeSliderChanged(int value);
     void onRepeatClicked();
     void onRepeatModeChanged(AudioEngine::RepeatMode mode);
@@ -52,6 +54,7 @@ private:
     QPushButton* m_repeatButton;
 
     WaveformWidget* m_waveformWidget;
+    QTimer* m_playheadTimer;  // ~60 Hz while playing, reads the engine's playback clock
     QSlider* m_volumeSlider;
 
     QLabel* m_trackInfoLabel;
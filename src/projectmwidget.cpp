@@ -15,16 +15,12 @@ ProjectMWidget::ProjectMWidget(QWidget* parent)
     : QOpenGLWidget(parent)
     , m_initialized(false)
     , m_sampleCount(0)
-    , m_phase(0.0f)
     , m_frameCount(0)
     , m_currentPresetIndex(-1)
+    , m_audioTap(nullptr)
+    , m_tapCursor(-1)
+    , m_pcmBatch(PCM_BATCH_FRAMES * AudioTap::CHANNELS)
 {
-    m_spectrumData.fill(0.0f, NUM_BANDS);
-    m_pcmDataLeft.resize(PCM_BUFFER_SIZE);
-    m_pcmDataRight.resize(PCM_BUFFER_SIZE);
-    m_pcmDataLeft.fill(0.0f);
-    m_pcmDataRight.fill(0.0f);
-
     setMinimumSize(400, 300);
 
     // Render timer for smooth animation
@@ -207,6 +203,8 @@ void ProjectMWidget::paintGL()
     }
 
     try {
+        feedPcmFromTap();
+
         // Render projectM visualization to Qt's framebuffer
         // QOpenGLWidget uses its own FBO, not the default framebuffer (0)
         m_projectM->RenderFrame(defaultFramebufferObject());
@@ -221,77 +219,33 @@ void ProjectMWidget::paintGL()
     }
 }
 
-void ProjectMWidget::setSpectrumData(const QVector<float>& magnitudes)
+void ProjectMWidget::setAudioTap(const AudioTap* tap)
 {
-    QMutexLocker locker(&m_dataMutex);
-
-    if (magnitudes.size() != NUM_BANDS) return;
-
-    // Apply smoothing
-    for (int i = 0; i < NUM_BANDS; ++i) {
-        m_spectrumData[i] = m_spectrumData[i] * 0.7f + magnitudes[i] * 0.3f;
-    }
-
+    m_audioTap = tap;
+    m_tapCursor = -1;
 }
 
-void ProjectMWidget::setPCMData(const std::vector<float>& leftChannel, const std::vector<float>& rightChannel)
+void ProjectMWidget::feedPcmFromTap()
 {
-    if (!m_initialized || !m_projectM) {
+    if (!m_audioTap) {
         return;
     }
 
-    static int callCount = 0;
-    callCount++;
-
-    int count = qMin(leftChannel.size(), rightChannel.size());
-    
-    // Update m_pcmData arrays for waveform visualization
-    QMutexLocker locker(&m_dataMutex);
-    for (int i = 0; i < count && i < PCM_BUFFER_SIZE; ++i) {
-        m_pcmDataLeft[i] = leftChannel[i];
-        m_pcmDataRight[i] = rightChannel[i];
+    // Everything between our cursor and the frame leaving the speakers, in
+    // batches of projectM's buffer size
+    const qint64 playing = m_audioTap->playingFrame();
+    if (m_tapCursor < 0 || m_tapCursor > playing || playing - m_tapCursor > MAX_CATCH_UP_FRAMES) {
+        m_tapCursor = playing - PCM_BATCH_FRAMES;
     }
 
-    // Feed PCM to projectM
-    std::vector<float> interleaved(count * 2);
-    for (int i = 0; i < count; ++i) {
-        interleaved[i * 2] = leftChannel[i];
-        interleaved[i * 2 + 1] = rightChannel[i];
-    }
-    m_projectM->PCM().Add(interleaved.data(), 2, count);
-
-}
-
-void ProjectMWidget::generatePCMData()
-{
-    // Convert spectrum data (frequency domain) back to PCM (time domain)
-    // This is an approximation using inverse FFT-like synthesis
-
-    QMutexLocker locker(&m_dataMutex);
-
-    for (int i = 0; i < PCM_BUFFER_SIZE; ++i) {
-        float sample = 0.0f;
-
-        // Synthesize waveform from frequency bands
-        for (int band = 0; band < NUM_BANDS; ++band) {
-            float frequency = (band + 1) * 100.0f;  // Frequency in Hz
-            float amplitude = m_spectrumData[band];
-            float phase = m_phase + (i * frequency * 2.0f * M_PI / 44100.0f);
-
-            sample += amplitude * qSin(phase) / NUM_BANDS;
+    while (m_tapCursor < playing) {
+        const int frames = static_cast<int>(qMin<qint64>(playing - m_tapCursor, PCM_BATCH_FRAMES));
+        if (!m_audioTap->copy(m_tapCursor, m_pcmBatch.data(), frames)) {
+            m_tapCursor = -1;  // Fell behind the ring; resync next frame
+            return;
         }
-
-        // Clamp to valid range
-        sample = qBound(-1.0f, sample, 1.0f);
-
-        m_pcmDataLeft[i] = sample;
-        m_pcmDataRight[i] = sample;
-    }
-
-    // Update phase for continuity
-    m_phase += (PCM_BUFFER_SIZE * 2.0f * M_PI / 44100.0f);
-    if (m_phase > M_PI * 2) {
-        m_phase -= M_PI * 2;
+        m_projectM->PCM().Add(m_pcmBatch.data(), 2, frames);
+        m_tapCursor += frames;
     }
 }
 
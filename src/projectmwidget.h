@@ -6,9 +6,9 @@
 
 #include <QOpenGLWidget>
 #include <QTimer>
-#include <QVector>
-#include <QMutex>
 #include <memory>
+#include <vector>
+#include "audiotap.h"
 
 // Forward declare projectM to avoid header dependency
 namespace libprojectM {
@@ -23,8 +23,7 @@ public:
     explicit ProjectMWidget(QWidget* parent = nullptr);
     ~ProjectMWidget();
 
-    void setSpectrumData(const QVector<float>& magnitudes);
-    void setPCMData(const std::vector<float>& leftChannel, const std::vector<float>& rightChannel);
+    void setAudioTap(const AudioTap* tap);  // Read once per rendered frame
     void nextPreset();
     void previousPreset();
     void randomPreset();
@@ -46,20 +45,18 @@ protected:
 
 private:
     void initializeProjectM();
-    void generatePCMData();
+    void feedPcmFromTap();
 
     std::unique_ptr<libprojectM::ProjectM> m_projectM;
     QTimer* m_renderTimer;
 
-    // Audio data
-    QVector<float> m_spectrumData;
-    QVector<float> m_pcmDataLeft;
-    QVector<float> m_pcmDataRight;
-    QMutex m_dataMutex;
+    // Audio data: every tapped frame, in order, up to what is audible now
+    const AudioTap* m_audioTap;
+    qint64 m_tapCursor;  // Next tap frame to hand to projectM (-1 = resync)
+    std::vector<float> m_pcmBatch;
 
     bool m_initialized;
     int m_sampleCount;
-    float m_phase;
     uint32_t m_frameCount;
 
     // Preset management
@@ -67,8 +64,8 @@ private:
     int m_currentPresetIndex;       // Current preset index in the list
     QString m_currentPreset;        // Current preset file path
 
-    static constexpr int NUM_BANDS = 32;
-    static constexpr int PCM_BUFFER_SIZE = 512;
+    static constexpr int PCM_BATCH_FRAMES = 576;      // projectM's waveform buffer length
+    static constexpr int MAX_CATCH_UP_FRAMES = 16384; // Resync instead of flooding after a stall
 };
 
 #endif // PROJECTMWIDGET_H
@@ -12,6 +12,7 @@
 ProjectMWindow::ProjectMWindow(QWidget* parent)
     : QWidget(parent, Qt::Window)
     , m_audioEngine(nullptr)
+    , m_visualizationWatcher(new VisualizationWatcher(this, AudioEngine::PcmFeed, 30))
 {
     setWindowTitle("projectM Visualizer - Deezer Client");
     resize(1024, 768);
@@ -177,10 +178,7 @@ void ProjectMWindow::setAudioEngine(AudioEngine* engine)
     m_audioEngine = engine;
 
     if (m_audioEngine) {
-        connect(m_audioEngine, &AudioEngine::spectrumDataReady,
-                m_projectMWidget, &ProjectMWidget::setSpectrumData);
-        connect(m_audioEngine, &AudioEngine::pcmDataReady,
-                m_projectMWidget, &ProjectMWidget::setPCMData);
+        m_projectMWidget->setAudioTap(&m_audioEngine->audioTap());
 
         // Start/pause visualizer rendering based on audio playback state
         connect(m_audioEngine, &AudioEngine::stateChanged, this, [this](AudioEngine::PlaybackState state) {
@@ -190,6 +188,7 @@ void ProjectMWindow::setAudioEngine(AudioEngine* engine)
                 m_projectMWidget->pauseRendering();
             }
         });
+        m_visualizationWatcher->setAudioEngine(m_audioEngine);
     }
 }
 
@@ -5,6 +5,7 @@
 #include <QCloseEvent>
 #include "projectmwidget.h"
 #include "audioengine.h"
+#include "visualizationwatcher.h"
 
 class QLabel;
 class QPushButton;
@@ -36,6 +37,7 @@ private slots:
 private:
     ProjectMWidget* m_projectMWidget;
     AudioEngine* m_audioEngine;
+    VisualizationWatcher* m_visualizationWatcher;
 
     QLabel* m_presetLabel;
     QPushButton* m_prevButton;
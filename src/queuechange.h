@@ -0,0 +1,75 @@
+#ifndef QUEUECHANGE_H
+#define QUEUECHANGE_H
+
+#include <QList>
+#include <QMetaType>
+#include <memory>
+#include "track.h"
+
+/**
+ * One structural edit of the play queue, as the engine applied it. Views
+ * replay the edits in order to mirror the queue without copying it again;
+ * queueSize (the size right after the edit) lets them detect drift and fall
+ * back to a full reload.
+ */
+struct QueueChange
+{
+    enum Type {
+        Reset,     // Whole queue replaced: tracks holds the new queue
+        Inserted,  // tracks now occupy rows [first, last]
+        Removed,   // Rows [first, last] are gone
+        Moved      // Rows [first, last] now start at destination (final position)
+    };
+
+    Type type = Reset;
+    int first = 0;
+    int last = -1;
+    int destination = -1;
+    QList<std::shared_ptr<Track>> tracks;
+    int queueSize = 0;
+
+    int count() const { return last - first + 1; }
+
+    static QueueChange reset(const QList<std::shared_ptr<Track>>& queue)
+    {
+        QueueChange change;
+        change.tracks = queue;
+        change.last = queue.size() - 1;
+        return change;
+    }
+
+    static QueueChange inserted(int position, const QList<std::shared_ptr<Track>>& tracks)
+    {
+        QueueChange change;
+        change.type = Inserted;
+        change.first = position;
+        change.last = position + tracks.size() - 1;
+        change.tracks = tracks;
+        return change;
+    }
+
+    static QueueChange removed(int first, int last)
+    {
+        QueueChange change;
+        change.type = Removed;
+        change.first = first;
+        change.last = last;
+        return change;
+    }
+
+    static QueueChange moved(int first, int last, int destination)
+    {
+        QueueChange change;
+        change.type = Moved;
+        change.first = first;
+        change.last = last;
+        change.destination = destination;
+        return change;
+    }
+};
+
+using QueueChangeSet = QList<QueueChange>;
+
+Q_DECLARE_METATYPE(QueueChangeSet)
+
+#endif // QUEUECHANGE_H
@@ -5,12 +5,17 @@
 #include <QScrollBar>
 #include <QNetworkRequest>
 #include <QMenu>
+#include <QEvent>
 
 SearchWidget::SearchWidget(QWidget *parent)
     : QWidget(parent)
     , m_deezerAPI(nullptr)
     , m_imageLoader(new QNetworkAccessManager(this))
+    , m_preloader(new SpeculativePreloader(this))
 {
+    connect(m_preloader, &SpeculativePreloader::requested, this, &SearchWidget::speculativePreloadRequested);
+    connect(m_preloader, &SpeculativePreloader::cancelled, this, &SearchWidget::speculativePreloadCancelled);
+
     setupUI();
     connect(m_imageLoader, &QNetworkAccessManager::finished,
             this, &SearchWidget::onImageDownloaded);
@@ -45,6 +50,8 @@ void SearchWidget::setupUI()
     m_tracksList->setStyleSheet("QListWidget::item { padding: 5px; }");
     m_tracksList->setIconSize(QSize(48, 48));
     m_tracksList->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_tracksList->setMouseTracking(true);
+    m_tracksList->viewport()->installEventFilter(this);
     m_resultsTabWidget->addTab(m_tracksList, "Tracks");
 
     // Albums tab
@@ -69,6 +76,8 @@ void SearchWidget::setupUI()
     connect(m_albumsList, &QListWidget::itemDoubleClicked, this, &SearchWidget::onAlbumItemDoubleClicked);
     connect(m_playlistsList, &QListWidget::itemDoubleClicked, this, &SearchWidget::onPlaylistItemDoubleClicked);
     connect(m_tracksList, &QListWidget::customContextMenuRequested, this, &SearchWidget::onTracksContextMenu);
+    connect(m_tracksList, &QListWidget::itemEntered, this, &SearchWidget::onTrackItemEntered);
+    connect(m_tracksList, &QListWidget::currentRowChanged, this, &SearchWidget::scheduleSpeculativePreload);
 
     // Connect scroll events for lazy loading
     connect(m_tracksList->verticalScrollBar(), &QScrollBar::valueChanged,
@@ -111,6 +120,7 @@ void SearchWidget::onSearchTriggered()
     m_loadedAlbumItems.clear();
     m_loadedPlaylistItems.clear();
     m_pendingImages.clear();
+    m_preloader->reset();
 
     // Only search for the currently focused tab to reduce unnecessary API calls
     int currentTab = m_resultsTabWidget->currentIndex();
@@ -247,6 +257,25 @@ void SearchWidget::onTrackItemDoubleClicked(QListWidgetItem* item)
     }
 }
 
+void SearchWidget::onTrackItemEntered(QListWidgetItem* item)
+{
+    scheduleSpeculativePreload(m_tracksList->row(item));
+}
+
+void SearchWidget::scheduleSpeculativePreload(int row)
+{
+    if (row >= 0 && row < m_tracks.size())
+        m_preloader->schedule(m_tracks[row]);
+}
+
+bool SearchWidget::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj == m_tracksList->viewport() && event->type() == QEvent::Leave) {
+        m_preloader->cancel();
+    }
+    return QWidget::eventFilter(obj, event);
+}
+
 void SearchWidget::onAlbumItemDoubleClicked(QListWidgetItem* item)
 {
     int index = m_albumsList->row(item);
@@ -16,6 +16,7 @@
 #include "track.h"
 #include "album.h"
 #include "playlist.h"
+#include "speculativepreloader.h"
 
 class SearchWidget : public QWidget
 {
@@ -35,6 +36,13 @@ signals:
     void addToQueueRequested(QList<std::shared_ptr<Track>> tracks);
     void playNextRequested(QList<std::shared_ptr<Track>> tracks);
 
+    // Speculative preloading: pointer rested on a track (or it became current), and cancellation
+    void speculativePreloadRequested(std::shared_ptr<Track> track);
+    void speculativePreloadCancelled(std::shared_ptr<Track> track);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
 private slots:
     void onSearchTriggered();
     void onTabChanged(int index);
@@ -49,6 +57,7 @@ private slots:
     void onAlbumScrolled();
     void onPlaylistScrolled();
     void onTracksContextMenu(const QPoint& pos);
+    void onTrackItemEntered(QListWidgetItem* item);
 
 private:
     void setupUI();
@@ -56,6 +65,7 @@ private:
     void loadVisibleAlbumArt();
     void loadVisiblePlaylistCovers();
     void loadImage(const QString& url, QListWidgetItem* item);
+    void scheduleSpeculativePreload(int row);
 
     DeezerAPI* m_deezerAPI;  // Shared API for all operations
 
@@ -76,6 +86,8 @@ private:
     QSet<QListWidgetItem*> m_loadedTrackItems;
     QSet<QListWidgetItem*> m_loadedAlbumItems;
     QSet<QListWidgetItem*> m_loadedPlaylistItems;
+
+    SpeculativePreloader* m_preloader;  // Track results hovered or selected long enough
 };
 
 #endif // SEARCHWIDGET_H
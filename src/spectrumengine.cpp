@@ -0,0 +1,141 @@
+#include "spectrumengine.h"
+#include "audiotap.h"
+#include <QTimer>
+#include <cmath>
+
+static constexpr float MIN_FREQUENCY = 20.0f;
+static constexpr float MAX_FREQUENCY = 20000.0f;
+static constexpr float LEVEL_GAIN = 50.0f;          // Band average -> 0..1 bar height
+static constexpr float LEVEL_DECAY_PER_SECOND = 2.5f;
+static constexpr float PEAK_HOLD_SECONDS = 0.6f;
+static constexpr float PEAK_DECAY_PER_SECOND = 0.8f;
+
+SpectrumEngine::SpectrumEngine(const AudioTap* tap, QObject* parent)
+    : QObject(parent)
+    , m_tap(tap)
+    , m_timer(nullptr)
+    , m_fftSize(8192)
+    , m_bandCount(32)
+    , m_tableRate(0)
+{
+}
+
+SpectrumEngine::~SpectrumEngine()
+{
+}
+
+void SpectrumEngine::setRate(int fps)
+{
+    if (!m_timer) {
+        m_timer = new QTimer(this);
+        connect(m_timer, &QTimer::timeout, this, &SpectrumEngine::analyze);
+    }
+
+    if (fps > 0) {
+        if (!m_timer->isActive())
+            m_frameTimer.restart();
+        m_timer->start(1000 / fps);
+    } else {
+        m_timer->stop();
+    }
+}
+
+void SpectrumEngine::setResolution(int fftSize, int bandCount)
+{
+    // Round down to a power of two inside the supported range
+    fftSize = qBound(512, fftSize, 32768);
+    int size = 512;
+    while (size * 2 <= fftSize)
+        size *= 2;
+
+    m_fftSize = size;
+    m_bandCount = qBound(1, bandCount, 512);
+    m_tableRate = 0;
+}
+
+void SpectrumEngine::rebuildTables(int sampleRate)
+{
+    static constexpr double PI = 3.14159265358979323846;
+
+    if (!m_fft || m_fft->size() != m_fftSize)
+        m_fft = std::make_unique<RealFft>(m_fftSize);
+
+    m_window.resize(m_fftSize);
+    for (int i = 0; i < m_fftSize; ++i)
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / (m_fftSize - 1)));
+
+    m_frames.resize(static_cast<size_t>(m_fftSize) * AudioTap::CHANNELS);
+    m_mono.resize(m_fftSize);
+    m_bins.resize(m_fftSize / 2);
+
+    // Log-spaced bands from MIN_FREQUENCY to MAX_FREQUENCY (capped at Nyquist)
+    const int binCount = m_fftSize / 2;
+    const float binHz = static_cast<float>(sampleRate) / m_fftSize;
+    const float maxFrequency = qMin(MAX_FREQUENCY, sampleRate / 2.0f);
+    const float ratio = std::log(maxFrequency / MIN_FREQUENCY);
+
+    m_bandStart.resize(m_bandCount);
+    m_bandEnd.resize(m_bandCount);
+    for (int band = 0; band < m_bandCount; ++band) {
+        const float lowFreq = MIN_FREQUENCY * std::exp(ratio * band / m_bandCount);
+        const float highFreq = MIN_FREQUENCY * std::exp(ratio * (band + 1) / m_bandCount);
+
+        int startBin = qBound(0, static_cast<int>(lowFreq / binHz), binCount - 1);
+        int endBin = qBound(1, static_cast<int>(highFreq / binHz), binCount);
+        if (startBin >= endBin)
+            startBin = endBin - 1;
+
+        m_bandStart[band] = startBin;
+        m_bandEnd[band] = endBin;
+    }
+
+    m_levels.fill(0.0f, m_bandCount);
+    m_peaks.fill(0.0f, m_bandCount);
+    m_peakHold.assign(m_bandCount, 0.0f);
+    m_tableRate = sampleRate;
+}
+
+void SpectrumEngine::analyze()
+{
+    const int sampleRate = m_tap->sampleRate();
+    if (sampleRate != m_tableRate)
+        rebuildTables(sampleRate);
+
+    const qint64 endFrame = m_tap->playingFrame();
+    if (!m_tap->copy(endFrame - m_fftSize, m_frames.data(), m_fftSize))
+        return;  // Overwritten while copying; the next frame catches up
+
+    // Channels combined, like BASS_DATA_FFT without BASS_DATA_FFT_INDIVIDUAL
+    const float* frames = m_frames.data();
+    const float* window = m_window.data();
+    float* mono = m_mono.data();
+    for (int i = 0; i < m_fftSize; ++i)
+        mono[i] = 0.5f * (frames[i * 2] + frames[i * 2 + 1]) * window[i];
+
+    m_fft->magnitudes(mono, m_bins.data());
+
+    const float elapsed = qMin(0.25f, m_frameTimer.restart() / 1000.0f);
+    const float levelFall = LEVEL_DECAY_PER_SECOND * elapsed;
+    const float peakFall = PEAK_DECAY_PER_SECOND * elapsed;
+
+    for (int band = 0; band < m_bandCount; ++band) {
+        float sum = 0.0f;
+        for (int bin = m_bandStart[band]; bin < m_bandEnd[band]; ++bin)
+            sum += m_bins[bin];
+        const float level = qBound(0.0f, sum / (m_bandEnd[band] - m_bandStart[band]) * LEVEL_GAIN, 1.0f);
+
+        // Instant attack, linear fall
+        m_levels[band] = qMax(level, m_levels[band] - levelFall);
+
+        if (m_levels[band] >= m_peaks[band]) {
+            m_peaks[band] = m_levels[band];
+            m_peakHold[band] = PEAK_HOLD_SECONDS;
+        } else if (m_peakHold[band] > 0.0f) {
+            m_peakHold[band] -= elapsed;
+        } else {
+            m_peaks[band] = qMax(m_levels[band], m_peaks[band] - peakFall);
+        }
+    }
+
+    emit spectrumReady(m_levels, m_peaks);
+}
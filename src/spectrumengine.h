@@ -0,0 +1,62 @@
+#ifndef SPECTRUMENGINE_H
+#define SPECTRUMENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <memory>
+#include <vector>
+#include "fft.h"
+
+class QTimer;
+class AudioTap;
+
+/**
+ * Spectrum analyzer running on its own thread: reads the audible frames from
+ * the audio tap, applies a precomputed Hann window, runs the real FFT and maps
+ * bins to log-spaced bands through precomputed tables. Bars fall with a fixed
+ * decay, peaks are held briefly before falling, so the UI only paints.
+ */
+class SpectrumEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrumEngine(const AudioTap* tap, QObject* parent = nullptr);
+    ~SpectrumEngine();
+
+public slots:
+    void setRate(int fps);  // 0 stops the analysis
+    void setResolution(int fftSize, int bandCount);  // fftSize: power of two, 512-32768
+
+signals:
+    void spectrumReady(const QVector<float>& magnitudes, const QVector<float>& peaks);
+
+private slots:
+    void analyze();
+
+private:
+    void rebuildTables(int sampleRate);
+
+    const AudioTap* m_tap;
+    QTimer* m_timer;  // Created on the engine's thread by the first setRate()
+
+    int m_fftSize;
+    int m_bandCount;
+    int m_tableRate;  // Sample rate the band tables were built for (0 = rebuild)
+
+    std::unique_ptr<RealFft> m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_frames;  // Interleaved tap copy
+    std::vector<float> m_mono;
+    std::vector<float> m_bins;
+    std::vector<int> m_bandStart;
+    std::vector<int> m_bandEnd;
+
+    QVector<float> m_levels;
+    QVector<float> m_peaks;
+    std::vector<float> m_peakHold;  // Seconds left before each peak starts falling
+    QElapsedTimer m_frameTimer;
+};
+
+#endif // SPECTRUMENGINE_H
@@ -7,24 +7,22 @@ SpectrumWidget::SpectrumWidget(QWidget *parent)
     : QWidget(parent)
 {
     m_magnitudes.fill(0.0f, NUM_BANDS);
+    m_peaks.fill(0.0f, NUM_BANDS);
     setMinimumSize(300, 200);
 }
 
-void SpectrumWidget::setSpectrumData(const QVector<float>& magnitudes)
+void SpectrumWidget::setSpectrumData(const QVector<float>& magnitudes, const QVector<float>& peaks)
 {
-    if (magnitudes.size() != NUM_BANDS) return;
-
-    // Apply temporal smoothing to prevent jittery bars
-    for (int i = 0; i < NUM_BANDS; ++i) {
-        m_magnitudes[i] = m_magnitudes[i] * 0.7f + magnitudes[i] * 0.3f;
-    }
-
+    // Decay and peak hold are applied by the audio engine's analysis thread
+    m_magnitudes = magnitudes;
+    m_peaks = peaks.size() == magnitudes.size() ? peaks : magnitudes;
     update();
 }
 
 void SpectrumWidget::clear()
 {
     m_magnitudes.fill(0.0f);
+    m_peaks.fill(0.0f);
     update();
 }
 
@@ -38,7 +36,9 @@ void SpectrumWidget::paintEvent(QPaintEvent* event)
     const int w = width();
     const int h = height();
     const int numBars = m_magnitudes.size();
-    const int totalBarWidth = numBars * (BAR_WIDTH + BAR_GAP) - BAR_GAP;
+    if (numBars == 0) return;
+    const int barWidth = qBound(1, (w - 20) / numBars - BAR_GAP, BAR_WIDTH);
+    const int totalBarWidth = numBars * (barWidth + BAR_GAP) - BAR_GAP;
     const int offsetX = (w - totalBarWidth) / 2;
 
     // Background gradient
@@ -51,7 +51,7 @@ void SpectrumWidget::paintEvent(QPaintEvent* event)
     for (int i = 0; i < numBars; ++i) {
         float magnitude = m_magnitudes[i];
         int barHeight = static_cast<int>(magnitude * (h - 20));
-        int x = offsetX + i * (BAR_WIDTH + BAR_GAP);
+        int x = offsetX + i * (barWidth + BAR_GAP);
         int y = h - barHeight - 10;
 
         // Color gradient based on magnitude
@@ -61,11 +61,12 @@ void SpectrumWidget::paintEvent(QPaintEvent* event)
         QLinearGradient barGradient(x, y + barHeight, x, y);
         barGradient.setColorAt(0, barColor.darker(150));
         barGradient.setColorAt(1, barColor);
-        painter.fillRect(x, y, BAR_WIDTH, barHeight, barGradient);
+        painter.fillRect(x, y, barWidth, barHeight, barGradient);
 
-        // Peak cap (bright line at top)
-        if (barHeight > 0) {
-            painter.fillRect(x, y - 2, BAR_WIDTH, 2, barColor.lighter(150));
+        // Peak cap (bright line at the held peak)
+        int peakHeight = static_cast<int>(m_peaks[i] * (h - 20));
+        if (peakHeight > 0) {
+            painter.fillRect(x, h - peakHeight - 12, barWidth, 2, barColor.lighter(150));
         }
     }
 }
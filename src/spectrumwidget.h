@@ -13,7 +13,7 @@ class SpectrumWidget : public QWidget
 public:
     explicit SpectrumWidget(QWidget *parent = nullptr);
 
-    void setSpectrumData(const QVector<float>& magnitudes);
+    void setSpectrumData(const QVector<float>& magnitudes, const QVector<float>& peaks);
     void clear();
 
 protected:
@@ -23,8 +23,9 @@ private:
     QColor getColorForMagnitude(float magnitude);
 
     QVector<float> m_magnitudes;
-    static constexpr int NUM_BANDS = 32;
-    static constexpr int BAR_WIDTH = 12;
+    QVector<float> m_peaks;
+    static constexpr int NUM_BANDS = 32;  // Until the first frame arrives
+    static constexpr int BAR_WIDTH = 12;  // Maximum; narrower when many bands don't fit
     static constexpr int BAR_GAP = 2;
 };
 
@@ -5,6 +5,7 @@
 SpectrumWindow::SpectrumWindow(QWidget *parent)
     : QWidget(parent, Qt::Window)
     , m_audioEngine(nullptr)
+    , m_visualizationWatcher(new VisualizationWatcher(this, AudioEngine::SpectrumFeed, 30))
 {
     setWindowTitle("Spectrum Visualizer - Deezer Client");
     resize(600, 400);
@@ -37,6 +38,7 @@ void SpectrumWindow::setAudioEngine(AudioEngine* engine)
     if (m_audioEngine) {
         connect(m_audioEngine, &AudioEngine::spectrumDataReady,
                 m_spectrumWidget, &SpectrumWidget::setSpectrumData);
+        m_visualizationWatcher->setAudioEngine(m_audioEngine);
     }
 }
 
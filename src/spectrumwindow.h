@@ -5,6 +5,7 @@
 #include <QCloseEvent>
 #include "spectrumwidget.h"
 #include "audioengine.h"
+#include "visualizationwatcher.h"
 
 class SpectrumWindow : public QWidget
 {
@@ -25,6 +26,7 @@ signals:
 private:
     SpectrumWidget* m_spectrumWidget;
     AudioEngine* m_audioEngine;
+    VisualizationWatcher* m_visualizationWatcher;
 };
 
 #endif // SPECTRUMWINDOW_H
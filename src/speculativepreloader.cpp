@@ -0,0 +1,49 @@
+#include "speculativepreloader.h"
+#include <QTimer>
+
+SpeculativePreloader::SpeculativePreloader(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(DWELL_MS);
+    connect(m_timer, &QTimer::timeout, this, &SpeculativePreloader::onTimeout);
+}
+
+void SpeculativePreloader::schedule(std::shared_ptr<Track> track)
+{
+    if (!track || track == m_requestedTrack)
+        return;  // Nothing to do or already requested
+    if (track == m_pendingTrack && m_timer->isActive())
+        return;  // Same row, different column
+
+    m_pendingTrack = track;
+    m_timer->start();
+}
+
+void SpeculativePreloader::reset()
+{
+    m_timer->stop();
+    m_pendingTrack.reset();
+}
+
+void SpeculativePreloader::cancel()
+{
+    reset();
+    if (m_requestedTrack) {
+        emit cancelled(m_requestedTrack);
+        m_requestedTrack.reset();
+    }
+}
+
+void SpeculativePreloader::onTimeout()
+{
+    if (!m_pendingTrack)
+        return;
+
+    if (m_requestedTrack && m_requestedTrack != m_pendingTrack)
+        emit cancelled(m_requestedTrack);
+    m_requestedTrack = m_pendingTrack;
+    m_pendingTrack.reset();
+    emit requested(m_requestedTrack);
+}
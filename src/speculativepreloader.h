@@ -0,0 +1,42 @@
+#ifndef SPECULATIVEPRELOADER_H
+#define SPECULATIVEPRELOADER_H
+
+#include <QObject>
+#include <memory>
+#include "track.h"
+
+class QTimer;
+
+/**
+ * Dwell timer shared by the track lists. A track has to stay under the
+ * pointer (or selected) briefly before it is requested, so sweeping across
+ * rows doesn't start a download per row. Keeps at most one request alive and
+ * cancels it when another track takes its place.
+ */
+class SpeculativePreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpeculativePreloader(QObject *parent = nullptr);
+
+    void schedule(std::shared_ptr<Track> track);
+    void reset();   // Drop the pending track (list contents changed)
+    void cancel();  // Drop the pending track and cancel the request
+
+signals:
+    void requested(std::shared_ptr<Track> track);
+    void cancelled(std::shared_ptr<Track> track);
+
+private slots:
+    void onTimeout();
+
+private:
+    static constexpr int DWELL_MS = 250;
+
+    QTimer* m_timer;
+    std::shared_ptr<Track> m_pendingTrack;
+    std::shared_ptr<Track> m_requestedTrack;
+};
+
+#endif // SPECULATIVEPRELOADER_H
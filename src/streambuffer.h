@@ -0,0 +1,112 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include <QByteArray>
+#include <QList>
+#include <cstring>
+
+/**
+ * Decrypted bytes of the playing file as a list of segments. Normally a single
+ * growing segment, so data() hands out the buffer without copying. Memory-capped
+ * streaming switches to fixed-size segments: the played region is released by
+ * dropping whole segments from the front, which never moves the bytes that stay.
+ */
+class StreamBuffer
+{
+public:
+    StreamBuffer() = default;
+    StreamBuffer(const QByteArray& data)
+        : m_size(data.size())
+    {
+        if (!data.isEmpty())
+            m_segments.append(data);
+    }
+
+    qint64 size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // Keeps the segment size (a re-fetch refills the same layout)
+    void clear()
+    {
+        m_segments.clear();
+        m_size = 0;
+    }
+
+    // 0 = one growing segment (the default)
+    void setSegmentBytes(qint64 bytes) { m_segmentBytes = bytes; }
+
+    void append(const QByteArray& data)
+    {
+        if (data.isEmpty())
+            return;
+        if (m_segments.isEmpty() || (m_segmentBytes > 0 && m_segments.last().size() >= m_segmentBytes)) {
+            QByteArray segment;
+            if (m_segmentBytes > 0)
+                segment.reserve(static_cast<int>(qMax<qint64>(m_segmentBytes, data.size())));
+            segment.append(data);
+            m_segments.append(segment);
+        } else {
+            m_segments.last().append(data);
+        }
+        m_size += data.size();
+    }
+
+    // Copies up to length bytes starting at offset; returns the count copied
+    qint64 read(qint64 offset, char* dst, qint64 length) const
+    {
+        qint64 copied = 0;
+        for (const QByteArray& segment : m_segments) {
+            if (copied >= length)
+                break;
+            if (offset >= segment.size()) {
+                offset -= segment.size();
+                continue;
+            }
+            const qint64 n = qMin<qint64>(segment.size() - offset, length - copied);
+            memcpy(dst + copied, segment.constData() + offset, static_cast<size_t>(n));
+            copied += n;
+            offset = 0;
+        }
+        return copied;
+    }
+
+    // Shared, not copied: puts data in front as a segment of its own
+    void prepend(const QByteArray& data)
+    {
+        if (data.isEmpty())
+            return;
+        m_segments.prepend(data);
+        m_size += data.size();
+    }
+
+    // Drops whole segments within the first `bytes`; returns the count released
+    qint64 releaseFront(qint64 bytes)
+    {
+        qint64 released = 0;
+        while (m_segments.size() > 1 && released + m_segments.first().size() <= bytes) {
+            released += m_segments.first().size();
+            m_segments.removeFirst();
+        }
+        m_size -= released;
+        return released;
+    }
+
+    // Contiguous view: shared (no copy) unless the buffer is segmented
+    QByteArray data() const
+    {
+        if (m_segments.size() == 1)
+            return m_segments.first();
+        QByteArray joined;
+        joined.reserve(static_cast<int>(m_size));
+        for (const QByteArray& segment : m_segments)
+            joined.append(segment);
+        return joined;
+    }
+
+private:
+    QList<QByteArray> m_segments;
+    qint64 m_size = 0;
+    qint64 m_segmentBytes = 0;
+};
+
+#endif // STREAMBUFFER_H
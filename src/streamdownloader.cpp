@@ -23,6 +23,23 @@ StreamDownloader::~StreamDownloader()
 }
 
 void StreamDownloader::startProgressiveDownload(const QString& url, const QString& trackId)
+{
+    startRequest(url, trackId, 0, -1, false);
+}
+
+void StreamDownloader::startHeadDownload(const QString& url, const QString& trackId, qint64 offset, qint64 headBytes)
+{
+    if (headBytes <= offset)
+        return;
+    startRequest(url, trackId, offset, headBytes - offset, true);
+}
+
+void StreamDownloader::resumeProgressiveDownload(const QString& url, const QString& trackId, qint64 offset)
+{
+    startRequest(url, trackId, offset, -1, false);
+}
+
+void StreamDownloader::startRequest(const QString& url, const QString& trackId, qint64 offset, qint64 maxBytes, bool lowPriority)
 {
     if (m_reply) {
         QNetworkReply* oldReply = m_reply;
@@ -30,44 +47,117 @@ void StreamDownloader::startProgressiveDownload(const QString& url, const QStrin
         oldReply->abort();
         oldReply->deleteLater();
     }
+    if (url.isEmpty())
+        return;  // Empty URL only cancels
+
+    m_rangeOffset = qMax<qint64>(0, offset);
+    m_remainingBytes = (maxBytes > 0) ? maxBytes : -1;
+    m_skipBytes = 0;
+    m_rangeChecked = false;
+
     QUrl qurl(url);
     QNetworkRequest req(qurl);
     req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
     req.setRawHeader("User-Agent", USER_AGENT);
+    if (m_rangeOffset > 0 || m_remainingBytes > 0) {
+        QByteArray range = "bytes=" + QByteArray::number(m_rangeOffset) + "-";
+        if (m_remainingBytes > 0)
+            range += QByteArray::number(m_rangeOffset + m_remainingBytes - 1);
+        req.setRawHeader("Range", range);
+    }
+    if (lowPriority)
+        req.setPriority(QNetworkRequest::LowPriority);
+
     m_reply = m_nam->get(req);
     m_reply->setProperty("trackId", trackId);
     connect(m_reply, &QNetworkReply::readyRead, this, &StreamDownloader::onReadyRead);
     connect(m_reply, &QNetworkReply::finished, this, &StreamDownloader::onProgressiveReplyFinished);
 }
 
+QByteArray StreamDownloader::takeRangeData(QNetworkReply* reply)
+{
+    QByteArray data = reply->readAll();
+
+    if (!m_rangeChecked) {
+        m_rangeChecked = true;
+        // 200 instead of 206: the server ignored Range and sends the whole file
+        int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (m_rangeOffset > 0 && status == 200)
+            m_skipBytes = m_rangeOffset;
+
+        // Total file size: Content-Range on a partial response, Content-Length on a full one
+        qint64 totalBytes = -1;
+        if (status == 206) {
+            QByteArray contentRange = reply->rawHeader("Content-Range");
+            int slash = contentRange.lastIndexOf('/');
+            if (slash >= 0) {
+                bool ok = false;
+                qint64 value = contentRange.mid(slash + 1).trimmed().toLongLong(&ok);
+                if (ok)
+                    totalBytes = value;
+            }
+        } else if (status == 200) {
+            totalBytes = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+        }
+        if (totalBytes > 0)
+            emit streamSizeKnown(totalBytes, reply->property("trackId").toString());
+    }
+    if (m_skipBytes > 0) {
+        qint64 skip = qMin<qint64>(m_skipBytes, data.size());
+        data.remove(0, static_cast<int>(skip));
+        m_skipBytes -= skip;
+    }
+    if (m_remainingBytes >= 0) {
+        if (data.size() > m_remainingBytes)
+            data.truncate(static_cast<int>(m_remainingBytes));
+        m_remainingBytes -= data.size();
+    }
+    return data;
+}
+
 void StreamDownloader::onReadyRead()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply || reply != m_reply) return;
 
-    QByteArray chunk = reply->readAll();
+    QByteArray chunk = takeRangeData(reply);
+    QString trackId = reply->property("trackId").toString();
     if (!chunk.isEmpty()) {
-        QString trackId = reply->property("trackId").toString();
         emit chunkReady(chunk, trackId);
     }
+
+    // Head download reached its limit (server sent more than requested): finish cleanly
+    if (m_remainingBytes == 0) {
+        m_reply = nullptr;
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+        emit progressiveDownloadFinished(QString(), trackId);
+    }
 }
 
 void StreamDownloader::onProgressiveReplyFinished()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
-    m_reply = nullptr;
+    bool isActive = (reply == m_reply);
+    if (isActive)
+        m_reply = nullptr;
 
-    // Emit any remaining data
-    QByteArray remaining = reply->readAll();
+    // Emit any remaining data (replies aborted by a newer request have nothing useful left)
     QString trackId = reply->property("trackId").toString();
+    QByteArray remaining = isActive ? takeRangeData(reply) : QByteArray();
     if (!remaining.isEmpty()) {
         emit chunkReady(remaining, trackId);
     }
 
     QString err;
-    if (reply->error() != QNetworkReply::NoError)
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 416 && isActive && m_rangeOffset > 0) {
+        // Resume offset is already at the end of the file -- nothing left to download
+    } else if (reply->error() != QNetworkReply::NoError) {
         err = reply->errorString();
+    }
 
     reply->deleteLater();
     emit progressiveDownloadFinished(err, trackId);
@@ -13,6 +13,10 @@ class QNetworkReply;
  * so the main thread is never blocked by DNS/SSL/socket.
  *
  * Emits chunkReady() per readyRead, then progressiveDownloadFinished().
+ * startHeadDownload() fetches the head of the file (bytes offset..headBytes) at low
+ * priority for speculative preloading; resumeProgressiveDownload() continues a file
+ * from a byte offset using an HTTP Range request.
+ * streamSizeKnown() reports the total file size as soon as the response headers arrive.
  */
 class StreamDownloader : public QObject
 {
@@ -24,18 +28,30 @@ public:
 
 public slots:
     void startProgressiveDownload(const QString& url, const QString& trackId);
+    void startHeadDownload(const QString& url, const QString& trackId, qint64 offset, qint64 headBytes);
+    void resumeProgressiveDownload(const QString& url, const QString& trackId, qint64 offset);
 
 signals:
     void chunkReady(const QByteArray& chunk, const QString& trackId);
     void progressiveDownloadFinished(const QString& errorMessage, const QString& trackId);
+    void streamSizeKnown(qint64 totalBytes, const QString& trackId);
 
 private slots:
     void onReadyRead();
     void onProgressiveReplyFinished();
 
 private:
+    void startRequest(const QString& url, const QString& trackId, qint64 offset, qint64 maxBytes, bool lowPriority);
+    QByteArray takeRangeData(QNetworkReply* reply);
+
     QNetworkAccessManager* m_nam;
     QNetworkReply* m_reply;
+
+    // Range state of the active request
+    qint64 m_rangeOffset = 0;
+    qint64 m_remainingBytes = -1;  // -1 = unlimited
+    qint64 m_skipBytes = 0;        // Server ignored Range: discard bytes before m_rangeOffset
+    bool m_rangeChecked = false;
 };
 
 #endif // STREAMDOWNLOADER_H
@@ -0,0 +1,641 @@
+#include "trackanalysis.h"
+#include "bass.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ANALYSIS_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static constexpr double PI = 3.14159265358979323846;
+static constexpr int READ_SAMPLES = 262144;     // Floats per BASS_ChannelGetData call (1 MB, ~3 s of stereo)
+static constexpr double SEGMENT_SECONDS = 0.1;  // Loudness blocks are 4 segments (400 ms, 75% overlap)
+static constexpr double ABSOLUTE_GATE_LUFS = -70.0;
+static constexpr double RELATIVE_GATE_LU = 10.0;
+static constexpr float PEAK_CEILING = 0.891f;   // -1 dBFS
+static constexpr double SLICE_SECONDS = 180.0;  // Whole-file passes get one decode slice per 3 minutes...
+static constexpr int MAX_SLICES = 8;            // ...up to one per core
+static constexpr double FILTER_WARMUP_SECONDS = 1.0;  // Decoded ahead of a slice to settle the K-weighting
+
+static std::atomic<quint64> s_decodes{0};
+static std::atomic<quint64> s_reads{0};
+static std::atomic<quint64> s_bytes{0};
+static std::atomic<qint64> s_readNs{0};
+
+AnalysisDecodeStats takeAnalysisDecodeStats()
+{
+    AnalysisDecodeStats stats;
+    stats.decodes = s_decodes.exchange(0, std::memory_order_relaxed);
+    stats.reads = s_reads.exchange(0, std::memory_order_relaxed);
+    stats.bytes = s_bytes.exchange(0, std::memory_order_relaxed);
+    stats.readNs = s_readNs.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+float TrackAnalysis::normalizationGain(double targetLufs) const
+{
+    if (!complete || loudnessLufs <= ABSOLUTE_GATE_LUFS)
+        return 1.0f;
+    float gain = static_cast<float>(std::pow(10.0, (targetLufs - loudnessLufs) / 20.0));
+    if (peak > 0.0f)
+        gain = qMin(gain, PEAK_CEILING / peak);
+    return gain;
+}
+
+// ── Accumulators ────────────────────────────────────────────────────────
+
+namespace {
+
+struct RunStats {
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = std::numeric_limits<float>::lowest();
+    double sumAbs = 0.0;
+    double sumSquares = 0.0;
+
+    float absPeak() const { return qMax(std::fabs(minimum), std::fabs(maximum)); }
+};
+
+// Min, max, sum |x| and sum x^2 of a run of samples (any channel layout)
+RunStats accumulateRun(const float* samples, int count)
+{
+    RunStats stats;
+    int i = 0;
+#ifdef ANALYSIS_USE_SSE
+    if (count >= 4) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 vmin = _mm_loadu_ps(samples);
+        __m128 vmax = vmin;
+        __m128 vabs = _mm_setzero_ps();
+        __m128 vsq = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(samples + i);
+            vmin = _mm_min_ps(vmin, x);
+            vmax = _mm_max_ps(vmax, x);
+            vabs = _mm_add_ps(vabs, _mm_andnot_ps(signMask, x));
+            vsq = _mm_add_ps(vsq, _mm_mul_ps(x, x));
+        }
+        alignas(16) float lanes[4][4];
+        _mm_store_ps(lanes[0], vmin);
+        _mm_store_ps(lanes[1], vmax);
+        _mm_store_ps(lanes[2], vabs);
+        _mm_store_ps(lanes[3], vsq);
+        for (int lane = 0; lane < 4; ++lane) {
+            stats.minimum = qMin(stats.minimum, lanes[0][lane]);
+            stats.maximum = qMax(stats.maximum, lanes[1][lane]);
+            stats.sumAbs += lanes[2][lane];
+            stats.sumSquares += lanes[3][lane];
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = samples[i];
+        stats.minimum = qMin(stats.minimum, x);
+        stats.maximum = qMax(stats.maximum, x);
+        stats.sumAbs += std::fabs(x);
+        stats.sumSquares += static_cast<double>(x) * x;
+    }
+    return stats;
+}
+
+// Transposed direct form II biquad
+struct Biquad {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    double z1 = 0.0, z2 = 0.0;
+
+    double process(double x)
+    {
+        const double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+};
+
+// BS.1770 K-weighting (high shelf + high pass) for any sample rate, via the
+// analog prototypes of the 48 kHz reference coefficients
+void makeKWeighting(double sampleRate, Biquad* shelf, Biquad* highPass)
+{
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(PI * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf->b0 = (vh + vb * k / q + k * k) / a0;
+        shelf->b1 = 2.0 * (k * k - vh) / a0;
+        shelf->b2 = (vh - vb * k / q + k * k) / a0;
+        shelf->a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf->a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(PI * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass->b0 = 1.0;
+        highPass->b1 = -2.0;
+        highPass->b2 = 1.0;
+        highPass->a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass->a2 = (1.0 - k / q + k * k) / a0;
+    }
+}
+
+double powerToLufs(double power)
+{
+    return power > 0.0 ? -0.691 + 10.0 * std::log10(power) : -std::numeric_limits<double>::infinity();
+}
+
+// Gated integrated loudness from 100 ms segment powers (sum over channels of mean squares)
+double integratedLoudness(const std::vector<double>& segments)
+{
+    if (segments.size() < 4)
+        return ABSOLUTE_GATE_LUFS;
+
+    std::vector<double> blocks;
+    blocks.reserve(segments.size() - 3);
+    for (size_t i = 0; i + 4 <= segments.size(); ++i)
+        blocks.push_back((segments[i] + segments[i + 1] + segments[i + 2] + segments[i + 3]) / 4.0);
+
+    double sum = 0.0;
+    int count = 0;
+    for (double power : blocks) {
+        if (powerToLufs(power) > ABSOLUTE_GATE_LUFS) {
+            sum += power;
+            ++count;
+        }
+    }
+    if (count == 0)
+        return ABSOLUTE_GATE_LUFS;
+
+    const double relativeGate = powerToLufs(sum / count) - RELATIVE_GATE_LU;
+    sum = 0.0;
+    count = 0;
+    for (double power : blocks) {
+        const double lufs = powerToLufs(power);
+        if (lufs > ABSOLUTE_GATE_LUFS && lufs > relativeGate) {
+            sum += power;
+            ++count;
+        }
+    }
+    return count > 0 ? powerToLufs(sum / count) : ABSOLUTE_GATE_LUFS;
+}
+
+} // namespace
+
+// ── Fused pass ──────────────────────────────────────────────────────────
+
+namespace {
+
+// Decode handles read the buffer's segments in place (STREAMFILE_NOBUFFER:
+// BASS calls these on the decoding thread). One cursor per handle.
+struct BufferReader {
+    const StreamBuffer* data = nullptr;
+    qint64 position = 0;
+};
+
+void CALLBACK readerClose(void* user)
+{
+    Q_UNUSED(user);
+}
+
+QWORD CALLBACK readerLength(void* user)
+{
+    return static_cast<QWORD>(static_cast<BufferReader*>(user)->data->size());
+}
+
+DWORD CALLBACK readerRead(void* buffer, DWORD length, void* user)
+{
+    auto* reader = static_cast<BufferReader*>(user);
+    const qint64 copied = reader->data->read(reader->position, static_cast<char*>(buffer), length);
+    reader->position += copied;
+    return static_cast<DWORD>(copied);
+}
+
+BOOL CALLBACK readerSeek(QWORD offset, void* user)
+{
+    auto* reader = static_cast<BufferReader*>(user);
+    if (offset > static_cast<QWORD>(reader->data->size()))
+        return FALSE;
+    reader->position = static_cast<qint64>(offset);
+    return TRUE;
+}
+
+HSTREAM openDecode(BufferReader* reader, DWORD flags)
+{
+    BASS_FILEPROCS procs = { readerClose, readerLength, readerRead, readerSeek };
+    HSTREAM decode = BASS_StreamCreateFileUser(STREAMFILE_NOBUFFER, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | flags,
+                                               &procs, reader);
+    if (decode)
+        s_decodes.fetch_add(1, std::memory_order_relaxed);
+    return decode;
+}
+
+// What every slice of a decode shares
+struct PassLayout {
+    int channels = 0;
+    DWORD freq = 0;
+    qint64 totalFrames = 0;
+    int firstBucket = 0;       // Range passes: bucket where frame 0 lands
+    int filledCount = 0;       // Buckets spanning totalFrames
+    int numPeaks = 0;
+    bool loudness = false;     // Whole-file pass: K-weighted segment powers too
+    qint64 segmentFrames = 1;
+};
+
+// One time range of the file and its accumulators, merged in order afterwards
+struct Slice {
+    qint64 startFrame = 0;
+    qint64 endFrame = 0;
+    HSTREAM handle = 0;  // Slice 0 reuses the probing handle; others open their own
+
+    std::vector<double> bucketAbs;
+    std::vector<qint64> bucketSamples;
+    std::vector<float> minimum;
+    std::vector<float> maximum;
+    std::vector<double> segments;
+    double sumSquares = 0.0;
+    float peak = 0.0f;
+    qint64 firstAudible = -1;
+    qint64 lastAudible = -1;
+    qint64 framesDecoded = 0;  // Up to endFrame; short when the data ends early
+    bool reachedEnd = false;   // Stopped at endFrame or the end of the stream, not on an error
+    bool cancelled = false;
+};
+
+// Decode [startFrame, endFrame) of a slice. Slices after the first seek there
+// (less a filter warm-up that feeds only the loudness filters).
+void decodeSlice(const StreamBuffer& data, const PassLayout& layout, Slice* slice,
+                 const AnalysisExecutor::CancellationToken& token)
+{
+    const int channels = layout.channels;
+    const qint64 frameBytes = static_cast<qint64>(sizeof(float)) * channels;
+
+    HSTREAM decode = slice->handle;
+    BufferReader reader;
+    reader.data = &data;
+    qint64 frame = 0;
+    if (slice->startFrame > 0) {
+        // Prescan makes MP3 seek points exact (it scans frame headers, it doesn't decode)
+        decode = openDecode(&reader, BASS_STREAM_PRESCAN);
+        if (!decode)
+            return;
+
+        const qint64 warmup = layout.loudness ? static_cast<qint64>(layout.freq * FILTER_WARMUP_SECONDS) : 0;
+        frame = qMax<qint64>(0, slice->startFrame - warmup);
+        if (!BASS_ChannelSetPosition(decode, static_cast<QWORD>(frame * frameBytes), BASS_POS_BYTE)) {
+            BASS_StreamFree(decode);
+            return;
+        }
+    }
+
+    slice->bucketAbs.assign(layout.numPeaks, 0.0);
+    slice->bucketSamples.assign(layout.numPeaks, 0);
+    slice->minimum.assign(layout.numPeaks, 0.0f);
+    slice->maximum.assign(layout.numPeaks, 0.0f);
+
+    // Loudness state: K-weighting per channel, 100 ms segment powers
+    std::vector<Biquad> shelves(channels), highPasses(channels);
+    for (int c = 0; c < channels; ++c)
+        makeKWeighting(layout.freq, &shelves[c], &highPasses[c]);
+    std::vector<double> channelSquares(channels, 0.0);
+    qint64 framesInSegment = 0;
+    if (layout.loudness)
+        slice->segments.reserve(static_cast<size_t>((slice->endFrame - slice->startFrame) / layout.segmentFrames) + 1);
+
+    std::vector<float> buffer(READ_SAMPLES - READ_SAMPLES % channels);
+    const DWORD readBytes = static_cast<DWORD>(buffer.size() * sizeof(float));
+    QElapsedTimer readTimer;
+
+    while (frame < slice->endFrame) {
+        // Early abort: the user skipped to another track or a newer job superseded this one
+        if (token.isCancelled()) {
+            slice->cancelled = true;
+            break;
+        }
+
+        readTimer.start();
+        const DWORD bytesRead = BASS_ChannelGetData(decode, buffer.data(), readBytes);
+        s_readNs.fetch_add(readTimer.nsecsElapsed(), std::memory_order_relaxed);
+        s_reads.fetch_add(1, std::memory_order_relaxed);
+        if (bytesRead == static_cast<DWORD>(-1) || bytesRead == 0) {
+            // The length can be an estimate (MP3 without a seek table): ending early is fine
+            slice->reachedEnd = BASS_ErrorGetCode() == BASS_ERROR_ENDED;
+            break;  // Error, end of stream or no data
+        }
+        s_bytes.fetch_add(bytesRead, std::memory_order_relaxed);
+
+        const int frames = static_cast<int>(qMin<qint64>(bytesRead / frameBytes, slice->endFrame - frame));
+        if (frames <= 0)
+            break;
+        const float* samples = buffer.data();
+
+        // Warm-up frames before the slice only settle the loudness filters
+        const int warm = static_cast<int>(qBound<qint64>(0, slice->startFrame - frame, frames));
+        for (int f = 0; f < warm; ++f) {
+            for (int c = 0; c < channels; ++c)
+                highPasses[c].process(shelves[c].process(samples[f * channels + c]));
+        }
+
+        // Waveform, extremes, RMS and silence: vectorized runs that stay in one bucket
+        int done = warm;
+        while (done < frames) {
+            const qint64 absolute = frame + done;
+            const int relative = qMin(layout.filledCount - 1,
+                                      static_cast<int>(absolute * layout.filledCount / layout.totalFrames));
+            const int bucket = layout.firstBucket + relative;
+            const qint64 bucketEnd = (static_cast<qint64>(relative) + 1) * layout.totalFrames / layout.filledCount;
+            const int run = static_cast<int>(qBound<qint64>(1, bucketEnd - absolute, frames - done));
+
+            const float* runSamples = samples + static_cast<size_t>(done) * channels;
+            const RunStats stats = accumulateRun(runSamples, run * channels);
+
+            if (slice->bucketSamples[bucket] == 0) {
+                slice->minimum[bucket] = stats.minimum;
+                slice->maximum[bucket] = stats.maximum;
+            } else {
+                slice->minimum[bucket] = qMin(slice->minimum[bucket], stats.minimum);
+                slice->maximum[bucket] = qMax(slice->maximum[bucket], stats.maximum);
+            }
+            slice->bucketAbs[bucket] += stats.sumAbs;
+            slice->bucketSamples[bucket] += static_cast<qint64>(run) * channels;
+            slice->sumSquares += stats.sumSquares;
+            slice->peak = qMax(slice->peak, stats.absPeak());
+
+            // Only runs with audible samples need the exact frame
+            if (stats.absPeak() > TrackAnalysis::SILENCE_THRESHOLD) {
+                auto audible = [&](int f) {
+                    for (int c = 0; c < channels; ++c)
+                        if (std::fabs(runSamples[f * channels + c]) > TrackAnalysis::SILENCE_THRESHOLD)
+                            return true;
+                    return false;
+                };
+                if (slice->firstAudible < 0) {
+                    int f = 0;
+                    while (f < run - 1 && !audible(f))
+                        ++f;
+                    slice->firstAudible = absolute + f;
+                }
+                int f = run - 1;
+                while (f > 0 && !audible(f))
+                    --f;
+                slice->lastAudible = absolute + f;
+            }
+
+            done += run;
+        }
+
+        // Loudness needs the whole file; the recursive filters run per sample
+        if (layout.loudness) {
+            for (int f = warm; f < frames; ++f) {
+                for (int c = 0; c < channels; ++c) {
+                    const double weighted = highPasses[c].process(shelves[c].process(samples[f * channels + c]));
+                    channelSquares[c] += weighted * weighted;
+                }
+                if (++framesInSegment == layout.segmentFrames) {
+                    double power = 0.0;
+                    for (int c = 0; c < channels; ++c) {
+                        power += channelSquares[c] / layout.segmentFrames;
+                        channelSquares[c] = 0.0;
+                    }
+                    slice->segments.push_back(power);
+                    framesInSegment = 0;
+                }
+            }
+        }
+
+        slice->framesDecoded += frames - warm;
+        frame += frames;
+    }
+    if (frame >= slice->endFrame)
+        slice->reachedEnd = true;
+
+    if (decode != slice->handle)
+        BASS_StreamFree(decode);
+}
+
+// Slices for a whole-file pass: one per SLICE_SECONDS of audio, at most one
+// per core, starting on loudness segment boundaries
+int sliceCount(const PassLayout& layout)
+{
+    if (!layout.loudness)
+        return 1;  // Partial (progressive) passes are short and their data still grows
+    const double seconds = static_cast<double>(layout.totalFrames) / layout.freq;
+    const int cores = qBound(1, QThread::idealThreadCount(), MAX_SLICES);
+    return qBound(1, static_cast<int>(seconds / SLICE_SECONDS), cores);
+}
+
+QThreadPool* slicePool()
+{
+    static QThreadPool* pool = []() {
+        auto* p = new QThreadPool;
+        p->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MAX_SLICES));
+        p->setThreadPriority(QThread::LowPriority);  // Like the analysis workers
+        return p;
+    }();
+    return pool;
+}
+
+} // namespace
+
+TrackAnalysis analyzeTrack(const StreamBuffer& data, int numPeaks,
+                           const AnalysisExecutor::CancellationToken& token,
+                           double completionRatio)
+{
+    TrackAnalysis result;
+    if (data.isEmpty() || numPeaks <= 0)
+        return result;
+
+    // The handle is private to this job: BASS serialises creation and freeing
+    // internally, the reads below share nothing with playback
+    BufferReader reader;
+    reader.data = &data;
+    HSTREAM decode = openDecode(&reader, 0);
+    if (!decode)
+        return result;
+
+    BASS_CHANNELINFO info;
+    const QWORD totalBytes = BASS_ChannelGetLength(decode, BASS_POS_BYTE);
+    if (!BASS_ChannelGetInfo(decode, &info) || info.chans == 0 || info.freq == 0 ||
+        totalBytes == 0 || totalBytes == static_cast<QWORD>(-1)) {
+        BASS_StreamFree(decode);
+        return result;
+    }
+
+    PassLayout layout;
+    layout.channels = static_cast<int>(info.chans);
+    layout.freq = info.freq;
+    layout.totalFrames = static_cast<qint64>(totalBytes / (sizeof(float) * layout.channels));
+    if (layout.totalFrames <= 0) {
+        BASS_StreamFree(decode);
+        return result;
+    }
+    result.complete = completionRatio >= 1.0;
+
+    // For a partial analysis (progressive download) only the first buckets are filled
+    layout.numPeaks = numPeaks;
+    layout.filledCount = result.complete
+        ? numPeaks
+        : qBound(1, static_cast<int>(numPeaks * completionRatio), numPeaks);
+    layout.loudness = result.complete;
+    layout.segmentFrames = qMax<qint64>(1, static_cast<qint64>(info.freq * SEGMENT_SECONDS));
+
+    // Long tracks decode as K time slices in parallel over the same buffer
+    const int count = sliceCount(layout);
+    const qint64 sliceSegments = layout.totalFrames / layout.segmentFrames / count;
+    std::vector<Slice> slices(count);
+    for (int i = 0; i < count; ++i) {
+        slices[i].startFrame = i * sliceSegments * layout.segmentFrames;
+        slices[i].endFrame = i + 1 < count ? (i + 1) * sliceSegments * layout.segmentFrames : layout.totalFrames;
+    }
+    slices[0].handle = decode;
+
+    if (count == 1) {
+        decodeSlice(data, layout, &slices[0], token);
+    } else {
+        QtConcurrent::blockingMap(slicePool(), slices, [&](Slice& slice) {
+            decodeSlice(data, layout, &slice, token);
+        });
+    }
+    BASS_StreamFree(decode);
+
+    // Merge in time order. A slice that came up short (its seek failed or the
+    // data ended) truncates the pass like a decode error would
+    std::vector<double> bucketAbs(numPeaks, 0.0);
+    std::vector<qint64> bucketSamples(numPeaks, 0);
+    QVector<float> minimum(numPeaks, 0.0f);
+    QVector<float> maximum(numPeaks, 0.0f);
+    std::vector<double> segments;
+    double sumSquares = 0.0;
+    qint64 firstAudible = -1;
+    qint64 lastAudible = -1;
+    qint64 frame = 0;
+    bool reachedEnd = false;
+
+    for (const Slice& slice : slices) {
+        reachedEnd = false;
+        if (slice.cancelled)
+            return TrackAnalysis();
+        if (slice.bucketAbs.empty())
+            break;  // Never decoded
+
+        for (int b = 0; b < numPeaks; ++b) {
+            if (slice.bucketSamples[b] == 0)
+                continue;
+            if (bucketSamples[b] == 0) {
+                minimum[b] = slice.minimum[b];
+                maximum[b] = slice.maximum[b];
+            } else {
+                minimum[b] = qMin(minimum[b], slice.minimum[b]);
+                maximum[b] = qMax(maximum[b], slice.maximum[b]);
+            }
+            bucketAbs[b] += slice.bucketAbs[b];
+            bucketSamples[b] += slice.bucketSamples[b];
+        }
+        segments.insert(segments.end(), slice.segments.begin(), slice.segments.end());
+        sumSquares += slice.sumSquares;
+        result.peak = qMax(result.peak, slice.peak);
+        if (firstAudible < 0)
+            firstAudible = slice.firstAudible;
+        if (slice.lastAudible >= 0)
+            lastAudible = slice.lastAudible;
+
+        frame = slice.startFrame + slice.framesDecoded;
+        reachedEnd = slice.reachedEnd;
+        if (frame < slice.endFrame)
+            break;
+    }
+
+    // A read error cut the pass short: keep the waveform, but it is not the whole
+    // file (no loudness or silence, and it must not be cached as complete)
+    if (!reachedEnd)
+        result.complete = false;
+
+    const int channels = layout.channels;
+    const double seconds = static_cast<double>(frame) / info.freq;
+    result.durationSeconds = seconds;
+    result.rms = frame > 0 ? static_cast<float>(std::sqrt(sumSquares / (static_cast<double>(frame) * channels))) : 0.0f;
+    if (result.complete) {
+        result.loudnessLufs = integratedLoudness(segments);
+        if (firstAudible < 0) {
+            result.leadingSilenceSeconds = seconds;
+        } else {
+            result.leadingSilenceSeconds = static_cast<double>(firstAudible) / info.freq;
+            result.trailingSilenceSeconds = static_cast<double>(frame - 1 - lastAudible) / info.freq;
+        }
+    }
+
+    // Waveform: mean |sample| per bucket; the coarser levels merge from these
+    QVector<float> envelope(numPeaks, 0.0f);
+    for (int i = 0; i < layout.filledCount; ++i) {
+        if (bucketSamples[i] > 0)
+            envelope[i] = static_cast<float>(bucketAbs[i] / bucketSamples[i]);
+    }
+    result.waveform = WaveformPyramid(envelope, minimum, maximum);
+
+    return result;
+}
+
+TrackAnalysis analyzeTrackRange(const StreamBuffer& data, double startSeconds, double endSeconds,
+                                double totalSeconds, int numPeaks,
+                                const AnalysisExecutor::CancellationToken& token)
+{
+    TrackAnalysis result;
+    if (data.isEmpty() || numPeaks <= 0 || totalSeconds <= 0.0 || endSeconds <= startSeconds)
+        return result;
+
+    BufferReader reader;
+    reader.data = &data;
+    HSTREAM decode = openDecode(&reader, 0);
+    if (!decode)
+        return result;
+
+    BASS_CHANNELINFO info;
+    if (!BASS_ChannelGetInfo(decode, &info) || info.chans == 0 || info.freq == 0) {
+        BASS_StreamFree(decode);
+        return result;
+    }
+
+    // Only the waveform: loudness and silence need the whole file in one pass
+    PassLayout layout;
+    layout.channels = static_cast<int>(info.chans);
+    layout.freq = info.freq;
+    layout.totalFrames = qMax<qint64>(1, static_cast<qint64>((endSeconds - startSeconds) * info.freq));
+    layout.numPeaks = numPeaks;
+    layout.firstBucket = qBound(0, static_cast<int>(startSeconds / totalSeconds * numPeaks), numPeaks - 1);
+    const int lastBucket = qBound(layout.firstBucket + 1,
+                                  static_cast<int>(std::ceil(endSeconds / totalSeconds * numPeaks)), numPeaks);
+    layout.filledCount = lastBucket - layout.firstBucket;
+    layout.segmentFrames = qMax<qint64>(1, static_cast<qint64>(info.freq * SEGMENT_SECONDS));
+
+    Slice slice;
+    slice.endFrame = layout.totalFrames;
+    slice.handle = decode;
+    decodeSlice(data, layout, &slice, token);
+    BASS_StreamFree(decode);
+    if (slice.cancelled || slice.framesDecoded == 0)
+        return result;
+
+    QVector<float> envelope(numPeaks, 0.0f);
+    QVector<float> minimum(numPeaks, 0.0f);
+    QVector<float> maximum(numPeaks, 0.0f);
+    for (int b = layout.firstBucket; b < lastBucket; ++b) {
+        if (slice.bucketSamples[b] == 0)
+            continue;
+        envelope[b] = static_cast<float>(slice.bucketAbs[b] / slice.bucketSamples[b]);
+        minimum[b] = slice.minimum[b];
+        maximum[b] = slice.maximum[b];
+    }
+    result.waveform = WaveformPyramid(envelope, minimum, maximum);
+    result.peak = slice.peak;
+    result.durationSeconds = startSeconds + static_cast<double>(slice.framesDecoded) / info.freq;
+    return result;
+}
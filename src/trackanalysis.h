@@ -0,0 +1,67 @@
+#ifndef TRACKANALYSIS_H
+#define TRACKANALYSIS_H
+
+#include <QVector>
+#include "analysisexecutor.h"
+#include "streambuffer.h"
+#include "waveformpyramid.h"
+
+/**
+ * Everything one decode of a track yields: the waveform pyramid (mean level
+ * and sample extremes at every display resolution), peak and RMS level, integrated loudness (ITU-R BS.1770 /
+ * EBU R128: K-weighting, 400 ms blocks, absolute and relative gates) and the
+ * silence at either end. Partial analyses (progressive download) only carry
+ * the waveform of the downloaded part.
+ */
+struct TrackAnalysis
+{
+    WaveformPyramid waveform;
+
+    float peak = 0.0f;            // Sample peak, linear
+    float rms = 0.0f;             // Over all channels, linear
+    double loudnessLufs = -70.0;  // Integrated loudness (-70 = silent / unknown)
+    double durationSeconds = 0.0;
+    double leadingSilenceSeconds = 0.0;   // Below SILENCE_THRESHOLD from the start...
+    double trailingSilenceSeconds = 0.0;  // ...and before the end
+    bool complete = false;  // Whole file analysed
+
+    static constexpr float SILENCE_THRESHOLD = 0.001f;  // -60 dBFS
+
+    bool isValid() const { return !waveform.isEmpty(); }
+
+    // Linear gain bringing the track to targetLufs, limited so the peak stays
+    // below -1 dBFS; 1.0 while the loudness is unknown
+    float normalizationGain(double targetLufs) const;
+};
+
+// Decoder throughput, summed over all analysis workers
+struct AnalysisDecodeStats
+{
+    quint64 decodes = 0;  // Handles created
+    quint64 reads = 0;    // BASS_ChannelGetData calls
+    quint64 bytes = 0;    // Float sample bytes decoded
+    qint64 readNs = 0;    // Time spent inside the reads
+};
+
+// Returns and resets the counters
+AnalysisDecodeStats takeAnalysisDecodeStats();
+
+// Decode data once (its own BASS decode handles reading the segments in place,
+// any thread, no locks held) and run all accumulators over it. numPeaks buckets span the file at the
+// finest waveform level; with completionRatio < 1 only the first part of them
+// is filled. Long tracks are decoded as parallel time slices (one handle per
+// slice over the same buffer, merged in order). Returns an invalid result when
+// the token is cancelled or the data doesn't decode.
+TrackAnalysis analyzeTrack(const StreamBuffer& data, int numPeaks,
+                           const AnalysisExecutor::CancellationToken& token,
+                           double completionRatio = 1.0);
+
+// Waveform of one stretch of a track whose file is only partly in memory
+// (memory-capped streaming): data holds the file header followed by the bytes
+// of [startSeconds, endSeconds). Only the buckets of that range are filled, the
+// rest stay zero, so ranges combine with WaveformPyramid::merged().
+TrackAnalysis analyzeTrackRange(const StreamBuffer& data, double startSeconds, double endSeconds,
+                                double totalSeconds, int numPeaks,
+                                const AnalysisExecutor::CancellationToken& token);
+
+#endif // TRACKANALYSIS_H
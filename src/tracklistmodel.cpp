@@ -0,0 +1,294 @@
+#include "tracklistmodel.h"
+#include <algorithm>
+
+// One shift of the tail instead of one per inserted track
+static void insertTracks(QList<std::shared_ptr<Track>>& list, int position,
+                         const QList<std::shared_ptr<Track>>& tracks)
+{
+    list.insert(position, tracks.size(), nullptr);
+    std::copy(tracks.cbegin(), tracks.cend(), list.begin() + position);
+}
+
+TrackListModel::TrackListModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    m_currentFont.setBold(true);
+}
+
+void TrackListModel::setTracks(const QList<std::shared_ptr<Track>>& tracks)
+{
+    beginResetModel();
+    m_tracks = tracks;
+    m_hoveredRow = -1;
+    rebuildIndex();
+    endResetModel();
+}
+
+void TrackListModel::clear()
+{
+    setTracks({});
+}
+
+std::shared_ptr<Track> TrackListModel::trackAt(int row) const
+{
+    if (row < 0 || row >= m_tracks.size())
+        return nullptr;
+    return m_tracks[row];
+}
+
+bool TrackListModel::applyQueueChange(const QueueChange& change)
+{
+    const int rows = m_tracks.size();
+    switch (change.type) {
+    case QueueChange::Reset:
+        setTracks(change.tracks);
+        return true;
+
+    case QueueChange::Inserted:
+        if (change.first < 0 || change.first > rows || change.tracks.size() != change.count())
+            return false;
+        if (change.tracks.isEmpty())
+            return true;
+        beginInsertRows(QModelIndex(), change.first, change.last);
+        insertTracks(m_tracks, change.first, change.tracks);
+        endInsertRows();
+        refreshNumbers(change.last + 1, m_tracks.size() - 1);
+        break;
+
+    case QueueChange::Removed:
+        if (change.first < 0 || change.last >= rows || change.count() <= 0)
+            return false;
+        beginRemoveRows(QModelIndex(), change.first, change.last);
+        m_tracks.erase(m_tracks.begin() + change.first, m_tracks.begin() + change.last + 1);
+        endRemoveRows();
+        refreshNumbers(change.first, m_tracks.size() - 1);
+        break;
+
+    case QueueChange::Moved: {
+        const int count = change.count();
+        if (change.first < 0 || change.last >= rows || count <= 0 ||
+            change.destination < 0 || change.destination + count > rows)
+            return false;
+        if (change.destination == change.first)
+            return true;
+        // Qt wants the row the block goes in front of, counted before the move
+        const int destinationChild = change.destination > change.first ? change.destination + count
+                                                                      : change.destination;
+        beginMoveRows(QModelIndex(), change.first, change.last, QModelIndex(), destinationChild);
+        const QList<std::shared_ptr<Track>> block = m_tracks.mid(change.first, count);
+        m_tracks.erase(m_tracks.begin() + change.first, m_tracks.begin() + change.last + 1);
+        insertTracks(m_tracks, change.destination, block);
+        endMoveRows();
+        refreshNumbers(qMin(change.first, change.destination),
+                       qMax(change.last, change.destination + count - 1));
+        break;
+    }
+    }
+
+    m_hoveredRow = -1;
+    m_indexStale = true;
+    return true;
+}
+
+void TrackListModel::setQueueLayout(bool queueLayout)
+{
+    if (m_queueLayout == queueLayout)
+        return;
+    beginResetModel();
+    m_queueLayout = queueLayout;
+    endResetModel();
+}
+
+void TrackListModel::rebuildIndex()
+{
+    m_indexStale = false;
+    m_rowsById.clear();
+    m_rowsById.reserve(m_tracks.size());
+    for (int i = 0; i < m_tracks.size(); ++i)
+        m_rowsById.insert(m_tracks[i]->id(), i);
+}
+
+// ── Row state ───────────────────────────────────────────────────────────
+
+void TrackListModel::setCurrentTrackId(const QString& id)
+{
+    if (id == m_currentTrackId)
+        return;
+    const QString previous = m_currentTrackId;
+    m_currentTrackId = id;
+    refreshRows(previous);
+    refreshRows(id);
+}
+
+void TrackListModel::setHoveredRow(int row)
+{
+    if (row == m_hoveredRow)
+        return;
+    const int previous = m_hoveredRow;
+    m_hoveredRow = row;
+    refreshRow(previous);
+    refreshRow(row);
+}
+
+void TrackListModel::setHighlightColor(const QColor& color)
+{
+    m_highlightColor = color;
+    refreshRows(m_currentTrackId);
+}
+
+void TrackListModel::setHoverColor(const QColor& color)
+{
+    m_hoverColor = color;
+    refreshRow(m_hoveredRow);
+}
+
+bool TrackListModel::isCurrentRow(int row) const
+{
+    return !m_currentTrackId.isEmpty() && m_tracks[row]->id() == m_currentTrackId;
+}
+
+void TrackListModel::refreshCell(int row, int column)
+{
+    if (row < 0 || row >= m_tracks.size())
+        return;
+    const QModelIndex cell = index(row, column);
+    emit dataChanged(cell, cell);
+}
+
+void TrackListModel::refreshColumn(int column)
+{
+    if (m_tracks.isEmpty())
+        return;
+    emit dataChanged(index(0, column), index(m_tracks.size() - 1, column));
+}
+
+void TrackListModel::refreshNumbers(int first, int last)
+{
+    if (!m_queueLayout || first > last)
+        return;
+    emit dataChanged(index(first, 0), index(last, 0), {Qt::DisplayRole});
+}
+
+void TrackListModel::refreshRow(int row)
+{
+    if (row < 0 || row >= m_tracks.size())
+        return;
+    emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+}
+
+void TrackListModel::refreshRows(const QString& trackId)
+{
+    if (trackId.isEmpty())
+        return;
+    if (m_indexStale)
+        rebuildIndex();
+    for (auto it = m_rowsById.constFind(trackId); it != m_rowsById.constEnd() && it.key() == trackId; ++it)
+        refreshRow(it.value());
+}
+
+// ── QAbstractTableModel ─────────────────────────────────────────────────
+
+int TrackListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_tracks.size();
+}
+
+int TrackListModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant TrackListModel::displayText(const Track& track, int row, int column) const
+{
+    if (column == HEART_COLUMN) {
+        return track.isFavorite()
+            ? QString::fromUtf8("\u2665")   // ♥ filled
+            : QString::fromUtf8("\u2661");  // ♡ empty
+    }
+
+    if (m_queueLayout) {
+        switch (column) {
+        case 0:
+            return isCurrentRow(row)
+                ? QString::fromUtf8("\u25B6")  // ▶
+                : QString("%1.").arg(row + 1, 2, 10, QChar('0'));
+        case 1: return track.title();
+        case 2: return track.displayArtist();
+        case 3: return track.hasScrobbleData() ? QString::number(track.userScrobbleCount()) : QString();
+        case 4: return track.durationString();
+        }
+    } else {
+        switch (column) {
+        case 0: return track.title();
+        case 1: return track.displayArtist();
+        case 2: return track.album();
+        case 3: return track.durationString();
+        case 4:
+            return track.hasScrobbleData()
+                ? QString::number(track.userScrobbleCount())
+                : QString::fromUtf8("\u2014");
+        }
+    }
+    return QVariant();
+}
+
+QVariant TrackListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_tracks.size())
+        return QVariant();
+
+    const int row = index.row();
+    const int column = index.column();
+    const Track& track = *m_tracks[row];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return displayText(track, row, column);
+    case Qt::TextAlignmentRole:
+        if (column == HEART_COLUMN)
+            return int(Qt::AlignCenter);
+        if (m_queueLayout && column != 1 && column != 2)
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        return QVariant();
+    case Qt::FontRole:
+        return isCurrentRow(row) ? QVariant(m_currentFont) : QVariant();
+    case Qt::ForegroundRole:
+        if (column == HEART_COLUMN && track.isFavorite())
+            return QColor(220, 60, 60);
+        return QVariant();
+    case Qt::BackgroundRole:
+        // The playing row keeps its highlight under the pointer
+        if (isCurrentRow(row))
+            return m_highlightColor;
+        if (row == m_hoveredRow)
+            return m_hoverColor;
+        return QVariant();
+    }
+    return QVariant();
+}
+
+QVariant TrackListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    static const QStringList queueLabels = {"#", "Title", "Artist", "Scrobbles", "Duration", ""};
+    static const QStringList libraryLabels = {"Title", "Artist", "Album", "Duration", "Scrobbles", ""};
+    const QStringList& labels = m_queueLayout ? queueLabels : libraryLabels;
+    return (section >= 0 && section < labels.size()) ? QVariant(labels[section]) : QVariant();
+}
+
+Qt::ItemFlags TrackListModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    // Queue rows are reordered by the view (DraggableTableView), never edited in place
+    // (the root accepts drops below the last row)
+    if (m_queueLayout)
+        itemFlags |= index.isValid() ? (Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled) : Qt::ItemIsDropEnabled;
+    return itemFlags;
+}
+
+Qt::DropActions TrackListModel::supportedDropActions() const
+{
+    return Qt::MoveAction;
+}
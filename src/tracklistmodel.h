@@ -0,0 +1,79 @@
+#ifndef TRACKLISTMODEL_H
+#define TRACKLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QFont>
+#include <QMultiHash>
+#include <memory>
+#include "track.h"
+#include "queuechange.h"
+
+/**
+ * Table model over a track list. Cells are produced on demand from the
+ * tracks, so a view only pays for the rows it paints. The current track and
+ * the hovered row are plain state here: changing either signals dataChanged
+ * for the rows involved instead of restyling the whole table.
+ */
+class TrackListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int COLUMN_COUNT = 6;
+    static constexpr int HEART_COLUMN = 5;  // Favorite toggle, last in both layouts
+
+    explicit TrackListModel(QObject *parent = nullptr);
+
+    void setTracks(const QList<std::shared_ptr<Track>>& tracks);
+    void clear();
+    const QList<std::shared_ptr<Track>>& tracks() const { return m_tracks; }
+    std::shared_ptr<Track> trackAt(int row) const;
+
+    // Mirror one queue edit as row inserts/removes/moves. False (model
+    // untouched) when it doesn't fit the rows, i.e. the mirror drifted.
+    bool applyQueueChange(const QueueChange& change);
+
+    // Queue layout: #, Title, Artist, Scrobbles, Duration, ♡
+    // Library layout: Title, Artist, Album, Duration, Scrobbles, ♡
+    void setQueueLayout(bool queueLayout);
+    bool isQueueLayout() const { return m_queueLayout; }
+    int scrobbleColumn() const { return m_queueLayout ? 3 : 4; }
+
+    void setCurrentTrackId(const QString& id);
+    void setHoveredRow(int row);
+    int hoveredRow() const { return m_hoveredRow; }
+    void setHighlightColor(const QColor& color);
+    void setHoverColor(const QColor& color);
+
+    // Re-read a track after it changed in place
+    void refreshCell(int row, int column);
+    void refreshColumn(int column);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    Qt::DropActions supportedDropActions() const override;
+
+private:
+    QVariant displayText(const Track& track, int row, int column) const;
+    bool isCurrentRow(int row) const;
+    void refreshRow(int row);
+    void refreshRows(const QString& trackId);  // Every row holding this track
+    void rebuildIndex();
+    void refreshNumbers(int first, int last);  // Queue layout: "#" column after rows shifted
+
+    QList<std::shared_ptr<Track>> m_tracks;
+    QMultiHash<QString, int> m_rowsById;  // A queue may hold the same track twice
+    bool m_indexStale = false;  // Rows shifted: rebuilt on the next lookup
+    bool m_queueLayout = false;
+    QString m_currentTrackId;
+    int m_hoveredRow = -1;
+    QColor m_highlightColor = QColor(60, 60, 100);
+    QColor m_hoverColor = QColor(50, 50, 70);
+    QFont m_currentFont;
+};
+
+#endif // TRACKLISTMODEL_H
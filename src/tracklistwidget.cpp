@@ -20,20 +20,20 @@ public:
     }
 };
 
-// Custom table widget with drag-and-drop support
-class DraggableTableWidget : public QTableWidget {
+// Custom table view with drag-and-drop support
+class DraggableTableView : public QTableView {
     Q_OBJECT
 public:
-    explicit DraggableTableWidget(QWidget* parent = nullptr)
-        : QTableWidget(parent), m_dragStartRow(-1) {}
+    explicit DraggableTableView(QWidget* parent = nullptr)
+        : QTableView(parent), m_dragStartRow(-1) {}
 
 signals:
     void rowMoved(int fromRow, int toRow);
 
 protected:
     void startDrag(Qt::DropActions supportedActions) override {
-        m_dragStartRow = currentRow();
-        QTableWidget::startDrag(supportedActions);
+        m_dragStartRow = currentIndex().row();
+        QTableView::startDrag(supportedActions);
     }
 
     void dropEvent(QDropEvent* event) override {
@@ -44,8 +44,8 @@ protected:
         }
 
         // Find the drop position
-        QTableWidgetItem* item = itemAt(event->position().toPoint());
-        int toRow = item ? item->row() : rowCount() - 1;
+        QModelIndex index = indexAt(event->position().toPoint());
+        int toRow = index.isValid() ? index.row() : model()->rowCount() - 1;
 
         // Accept the event to prevent Qt's default behavior
         event->accept();
@@ -53,7 +53,7 @@ protected:
         // Reset drag tracking
         m_dragStartRow = -1;
 
-        // Emit signal to update backend (UI will refresh via queueChanged signal)
+        // Emit signal to update backend (rows move when the engine reports the edit)
         if (fromRow != toRow && fromRow >= 0 && toRow >= 0) {
             emit rowMoved(fromRow, toRow);
         }
@@ -66,13 +66,18 @@ private:
 TrackListWidget::TrackListWidget(QWidget *parent)
     : QWidget(parent)
     , m_deezerAPI(nullptr)
+    , m_model(new TrackListModel(this))
+    , m_preloader(new SpeculativePreloader(this))
 {
+    connect(m_preloader, &SpeculativePreloader::requested, this, &TrackListWidget::speculativePreloadRequested);
+    connect(m_preloader, &SpeculativePreloader::cancelled, this, &TrackListWidget::speculativePreloadCancelled);
+
     setupUI();
 }
 
 TrackListWidget::~TrackListWidget()
 {
-    // QTableWidget is a child widget, will be deleted automatically
+    // Table view and model are children, deleted automatically
 }
 
 void TrackListWidget::setupUI()
@@ -89,10 +94,9 @@ void TrackListWidget::setupUI()
     searchLayout->addWidget(m_searchEdit);
     searchLayout->addWidget(m_searchButton);
 
-    // Track table (use custom draggable widget)
-    m_trackTable = new DraggableTableWidget(this);
-    m_trackTable->setColumnCount(5);
-    m_trackTable->setHorizontalHeaderLabels({"Title", "Artist", "Album", "Duration", "Scrobbles"});
+    // Track table (use custom draggable view)
+    m_trackTable = new DraggableTableView(this);
+    m_trackTable->setModel(m_model);
     m_trackTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_trackTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_trackTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -100,6 +104,8 @@ void TrackListWidget::setupUI()
     m_trackTable->horizontalHeader()->setMinimumSectionSize(14);
     m_trackTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
     m_trackTable->verticalHeader()->setVisible(false);
+    // Uniform row heights: row positions are arithmetic, no per-row measuring
+    m_trackTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     m_trackTable->setShowGrid(false);
     m_trackTable->setFrameShape(QFrame::NoFrame);
     m_trackTable->setMouseTracking(true);
@@ -110,7 +116,7 @@ void TrackListWidget::setupUI()
     m_trackTable->setDragDropMode(QAbstractItemView::InternalMove);
     m_trackTable->setDefaultDropAction(Qt::MoveAction);
 
-    // Suppress per-cell hover highlight; row hover is handled by onCellEntered
+    // Suppress per-cell hover highlight; row hover is drawn from the model's background role
     m_trackTable->setItemDelegate(new NoCellHoverDelegate(m_trackTable));
 
     // Install event filter for keyboard shortcuts and Leave detection
@@ -124,15 +130,19 @@ void TrackListWidget::setupUI()
     // Connect signals
     connect(m_searchButton, &QPushButton::clicked, this, &TrackListWidget::onSearchClicked);
     connect(m_searchEdit, &QLineEdit::returnPressed, this, &TrackListWidget::onSearchClicked);
-    connect(m_trackTable, &QTableWidget::cellDoubleClicked, this, &TrackListWidget::onTableDoubleClicked);
-    connect(m_trackTable, &QTableWidget::cellClicked, this, &TrackListWidget::onCellClicked);
-    connect(m_trackTable, &QTableWidget::itemSelectionChanged, this, &TrackListWidget::onSelectionChanged);
-    connect(m_trackTable, &QTableWidget::cellEntered, this, &TrackListWidget::onCellEntered);
+    connect(m_trackTable, &QTableView::doubleClicked, this, &TrackListWidget::onTableDoubleClicked);
+    connect(m_trackTable, &QTableView::clicked, this, &TrackListWidget::onCellClicked);
+    connect(m_trackTable->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &TrackListWidget::onSelectionChanged);
+    connect(m_trackTable, &QTableView::entered, this, &TrackListWidget::onCellEntered);
 
     // Connect drag-and-drop signal
-    connect(static_cast<DraggableTableWidget*>(m_trackTable),
-            &DraggableTableWidget::rowMoved,
+    connect(static_cast<DraggableTableView*>(m_trackTable),
+            &DraggableTableView::rowMoved,
             this, &TrackListWidget::moveRequested);
+
+    // Library columns until setMode() says otherwise
+    populateTable();
 }
 
 void TrackListWidget::setDeezerAPI(DeezerAPI* api)
@@ -144,14 +154,26 @@ void TrackListWidget::setDeezerAPI(DeezerAPI* api)
 
 void TrackListWidget::setTracks(const QList<std::shared_ptr<Track>>& tracks)
 {
-    m_tracks = tracks;
-    populateTable();
+    m_preloader->reset();
+    m_model->setTracks(tracks);
+}
+
+bool TrackListWidget::applyQueueChanges(const QueueChangeSet& changes)
+{
+    // Row indices shift under a pending hover preload
+    m_preloader->reset();
+
+    for (const QueueChange& change : changes) {
+        if (!m_model->applyQueueChange(change) || m_model->rowCount() != change.queueSize)
+            return false;
+    }
+    return true;
 }
 
 void TrackListWidget::clearTracks()
 {
-    m_tracks.clear();
-    m_trackTable->setRowCount(0);
+    m_preloader->reset();
+    m_model->clear();
 }
 
 void TrackListWidget::setSearchVisible(bool visible)
@@ -190,222 +212,109 @@ void TrackListWidget::onTracksFound(QList<std::shared_ptr<Track>> tracks, void*
     setTracks(tracks);
 }
 
-void TrackListWidget::onTableDoubleClicked(int row, int column)
+void TrackListWidget::onTableDoubleClicked(const QModelIndex& index)
 {
-    if (row >= 0 && row < m_tracks.size()) {
-        emit trackDoubleClicked(m_tracks[row]);
+    if (auto track = m_model->trackAt(index.row())) {
+        emit trackDoubleClicked(track);
     }
 }
 
-void TrackListWidget::onCellClicked(int row, int column)
+void TrackListWidget::onCellClicked(const QModelIndex& index)
 {
     // Heart column is always the last column
-    int heartCol = m_trackTable->columnCount() - 1;
-    if (column != heartCol) return;
-    if (row < 0 || row >= m_tracks.size()) return;
+    if (index.column() != TrackListModel::HEART_COLUMN) return;
+    auto track = m_model->trackAt(index.row());
+    if (!track) return;
 
-    auto track = m_tracks[row];
     bool newFavorite = !track->isFavorite();
     track->setFavorite(newFavorite);
 
     // Update heart display
-    QTableWidgetItem* item = m_trackTable->item(row, heartCol);
-    if (item) {
-        item->setText(newFavorite
-            ? QString::fromUtf8("\u2665")   // ♥ filled
-            : QString::fromUtf8("\u2661")); // ♡ empty
-        item->setForeground(newFavorite
-            ? QBrush(QColor(220, 60, 60))
-            : QBrush(QColor(180, 180, 180)));
-    }
+    m_model->refreshCell(index.row(), TrackListModel::HEART_COLUMN);
 
     emit favoriteToggled(track, newFavorite);
 }
 
+QList<int> TrackListWidget::selectedRows() const
+{
+    QList<int> rows;
+    for (const QModelIndex& index : m_trackTable->selectionModel()->selectedRows())
+        rows.append(index.row());
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
 void TrackListWidget::onSelectionChanged()
 {
     QList<std::shared_ptr<Track>> selectedTracks;
-    
-    for (QTableWidgetItem* item : m_trackTable->selectedItems()) {
-        int row = item->row();
-        if (row >= 0 && row < m_tracks.size()) {
-            if (!selectedTracks.contains(m_tracks[row])) {
-                selectedTracks.append(m_tracks[row]);
-            }
+    const QList<int> rows = selectedRows();
+    for (int row : rows) {
+        if (auto track = m_model->trackAt(row)) {
+            selectedTracks.append(track);
         }
     }
-    
+
     if (!selectedTracks.isEmpty()) {
         emit tracksSelected(selectedTracks);
     }
+
+    // Keyboard navigation: a single selected row is likely to be played next
+    if (rows.size() == 1) {
+        m_preloader->schedule(m_model->trackAt(rows.first()));
+    }
 }
 
 void TrackListWidget::setCurrentTrackId(const QString& id)
 {
-    m_currentTrackId = id;
-    for (int i = 0; i < m_trackTable->rowCount(); ++i) {
-        bool isCurrent = (i < m_tracks.size() && m_tracks[i]->id() == id);
-
-        for (int col = 0; col < m_trackTable->columnCount(); ++col) {
-            QTableWidgetItem* item = m_trackTable->item(i, col);
-            if (!item) continue;
-
-            QFont font = item->font();
-            font.setBold(isCurrent);
-            item->setFont(font);
-
-            if (isCurrent) {
-                item->setBackground(QBrush(m_highlightColor));
-            } else {
-                item->setBackground(Qt::transparent);
-            }
-        }
-
-        // In QueueMode, update # column with play indicator
-        if (m_mode == QueueMode) {
-            QTableWidgetItem* numItem = m_trackTable->item(i, 0);
-            if (numItem) {
-                if (isCurrent) {
-                    numItem->setText(QString::fromUtf8("\u25B6"));  // ▶
-                } else {
-                    numItem->setText(QString("%1.").arg(i + 1, 2, 10, QChar('0')));
-                }
-            }
-        }
-    }
+    // Repaints only the rows of the previous and the new track
+    m_model->setCurrentTrackId(id);
 }
 
 void TrackListWidget::setHighlightColor(const QColor& color)
 {
-    m_highlightColor = color.isValid() ? color : QColor(60, 60, 100);
-    if (!m_currentTrackId.isEmpty())
-        setCurrentTrackId(m_currentTrackId);
+    m_model->setHighlightColor(color.isValid() ? color : QColor(60, 60, 100));
 }
 
 void TrackListWidget::setHoverColor(const QColor& color)
 {
-    m_hoverColor = color.isValid() ? color : QColor(50, 50, 70);
+    m_model->setHoverColor(color.isValid() ? color : QColor(50, 50, 70));
 }
 
-void TrackListWidget::onCellEntered(int row, int /*column*/)
+void TrackListWidget::onCellEntered(const QModelIndex& index)
 {
-    // Clear previous hover row
-    if (m_hoveredRow >= 0 && m_hoveredRow != row && m_hoveredRow < m_trackTable->rowCount()) {
-        bool isCurrent = (m_hoveredRow < m_tracks.size() && m_tracks[m_hoveredRow]->id() == m_currentTrackId);
-        for (int col = 0; col < m_trackTable->columnCount(); ++col) {
-            QTableWidgetItem* item = m_trackTable->item(m_hoveredRow, col);
-            if (item)
-                item->setBackground(isCurrent ? QBrush(m_highlightColor) : Qt::transparent);
-        }
-    }
-
-    // Set new hover row (skip if it's the current playing track)
-    m_hoveredRow = row;
-    if (row >= 0 && row < m_trackTable->rowCount()) {
-        bool isCurrent = (row < m_tracks.size() && m_tracks[row]->id() == m_currentTrackId);
-        if (!isCurrent) {
-            for (int col = 0; col < m_trackTable->columnCount(); ++col) {
-                QTableWidgetItem* item = m_trackTable->item(row, col);
-                if (item)
-                    item->setBackground(QBrush(m_hoverColor));
-            }
-        }
-    }
+    // Row hover (the current playing track keeps its highlight)
+    m_model->setHoveredRow(index.row());
+    m_preloader->schedule(m_model->trackAt(index.row()));
 }
 
 void TrackListWidget::populateTable()
 {
-    m_trackTable->setRowCount(0);
+    m_preloader->reset();
+    m_model->setQueueLayout(m_mode == QueueMode);
 
+    QHeaderView* header = m_trackTable->horizontalHeader();
     if (m_mode == QueueMode) {
         // Queue columns: #, Title, Artist, Scrobbles, Duration, ♡
-        m_trackTable->setColumnCount(6);
-        m_trackTable->setHorizontalHeaderLabels({"#", "Title", "Artist", "Scrobbles", "Duration", ""});
-        m_trackTable->horizontalHeader()->setVisible(false);
+        header->setVisible(false);
 
         // Column sizing
-        m_trackTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Fixed);
+        header->setSectionResizeMode(0, QHeaderView::Fixed);
         m_trackTable->setColumnWidth(0, 40);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Fixed);
+        header->setSectionResizeMode(1, QHeaderView::Stretch);
+        header->setSectionResizeMode(2, QHeaderView::Stretch);
+        header->setSectionResizeMode(3, QHeaderView::Fixed);
         m_trackTable->setColumnWidth(3, 60);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Fixed);
+        header->setSectionResizeMode(4, QHeaderView::Fixed);
         m_trackTable->setColumnWidth(4, 60);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(5, QHeaderView::Fixed);
+        header->setSectionResizeMode(5, QHeaderView::Fixed);
         m_trackTable->setColumnWidth(5, 20);
-
-        for (int i = 0; i < m_tracks.size(); ++i) {
-            auto track = m_tracks[i];
-            m_trackTable->insertRow(i);
-
-            // Track number
-            QString numStr = QString("%1.").arg(i + 1, 2, 10, QChar('0'));
-            QTableWidgetItem* numItem = new QTableWidgetItem(numStr);
-            numItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            m_trackTable->setItem(i, 0, numItem);
-
-            m_trackTable->setItem(i, 1, new QTableWidgetItem(track->title()));
-            m_trackTable->setItem(i, 2, new QTableWidgetItem(track->displayArtist()));
-
-            // Scrobble count
-            QString scrobbleText = track->hasScrobbleData()
-                ? QString::number(track->userScrobbleCount())
-                : QString();
-            QTableWidgetItem* scrobbleItem = new QTableWidgetItem(scrobbleText);
-            scrobbleItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            m_trackTable->setItem(i, 3, scrobbleItem);
-
-            QTableWidgetItem* durItem = new QTableWidgetItem(track->durationString());
-            durItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            m_trackTable->setItem(i, 4, durItem);
-
-            // Favorite heart
-            QString heartText = track->isFavorite()
-                ? QString::fromUtf8("\u2665")   // ♥ filled
-                : QString::fromUtf8("\u2661");  // ♡ empty
-            QTableWidgetItem* heartItem = new QTableWidgetItem(heartText);
-            heartItem->setTextAlignment(Qt::AlignCenter);
-            if (track->isFavorite()) {
-                heartItem->setForeground(QBrush(QColor(220, 60, 60)));
-            }
-            m_trackTable->setItem(i, 5, heartItem);
-        }
     } else {
         // Library mode: full 6-column layout
-        m_trackTable->setColumnCount(6);
-        m_trackTable->setHorizontalHeaderLabels({"Title", "Artist", "Album", "Duration", "Scrobbles", ""});
-        m_trackTable->horizontalHeader()->setVisible(true);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-        m_trackTable->horizontalHeader()->setStretchLastSection(false);
-        m_trackTable->horizontalHeader()->setSectionResizeMode(5, QHeaderView::Fixed);
+        header->setVisible(true);
+        header->setSectionResizeMode(0, QHeaderView::Stretch);
+        header->setStretchLastSection(false);
+        header->setSectionResizeMode(5, QHeaderView::Fixed);
         m_trackTable->setColumnWidth(5, 14);
-
-        for (int i = 0; i < m_tracks.size(); ++i) {
-            auto track = m_tracks[i];
-
-            m_trackTable->insertRow(i);
-            m_trackTable->setItem(i, 0, new QTableWidgetItem(track->title()));
-            m_trackTable->setItem(i, 1, new QTableWidgetItem(track->displayArtist()));
-            m_trackTable->setItem(i, 2, new QTableWidgetItem(track->album()));
-            m_trackTable->setItem(i, 3, new QTableWidgetItem(track->durationString()));
-
-            QString scrobbleText = track->hasScrobbleData()
-                ? QString::number(track->userScrobbleCount())
-                : QString::fromUtf8("\u2014");
-            m_trackTable->setItem(i, 4, new QTableWidgetItem(scrobbleText));
-
-            // Favorite heart
-            QString heartText = track->isFavorite()
-                ? QString::fromUtf8("\u2665")   // ♥ filled
-                : QString::fromUtf8("\u2661");  // ♡ empty
-            QTableWidgetItem* heartItem = new QTableWidgetItem(heartText);
-            heartItem->setTextAlignment(Qt::AlignCenter);
-            if (track->isFavorite()) {
-                heartItem->setForeground(QBrush(QColor(220, 60, 60)));
-            }
-            m_trackTable->setItem(i, 5, heartItem);
-        }
     }
 }
 
@@ -422,26 +331,18 @@ void TrackListWidget::setMode(Mode mode)
         m_trackTable->setAcceptDrops(false);
     }
 
-    // Re-populate with correct columns if tracks are loaded
-    if (!m_tracks.isEmpty()) {
-        populateTable();
-    }
+    // Switch the model and header to the mode's columns
+    populateTable();
 }
 
 void TrackListWidget::updateTrackScrobbleCount(int index)
 {
-    if (index < 0 || index >= m_tracks.size()) return;
-
-    auto track = m_tracks[index];
-    QString text = track->hasScrobbleData()
-        ? QString::number(track->userScrobbleCount())
-        : (m_mode == QueueMode ? QString() : QString::fromUtf8("\u2014"));
+    m_model->refreshCell(index, m_model->scrobbleColumn());
+}
 
-    int scrobbleCol = (m_mode == QueueMode) ? 3 : 4;
-    QTableWidgetItem* item = m_trackTable->item(index, scrobbleCol);
-    if (item) {
-        item->setText(text);
-    }
+void TrackListWidget::refreshScrobbleCounts()
+{
+    m_model->refreshColumn(m_model->scrobbleColumn());
 }
 
 bool TrackListWidget::eventFilter(QObject* obj, QEvent* event)
@@ -452,31 +353,37 @@ bool TrackListWidget::eventFilter(QObject* obj, QEvent* event)
 
         // Delete key - remove selected tracks
         if (keyEvent->key() == Qt::Key_Delete) {
-            QList<int> selectedRows;
-            for (QTableWidgetItem* item : m_trackTable->selectedItems()) {
-                int row = item->row();
-                if (!selectedRows.contains(row)) {
-                    selectedRows.append(row);
+            const QList<int> rows = selectedRows();
+            if (!rows.isEmpty()) {
+                if (rows.size() == 1) {
+                    emit removeRequested(rows.first());
+                } else {
+                    emit removeMultipleRequested(rows);
                 }
             }
+            return true;
+        }
 
-            if (!selectedRows.isEmpty()) {
-                if (selectedRows.size() == 1) {
-                    emit removeRequested(selectedRows.first());
-                } else {
-                    emit removeMultipleRequested(selectedRows);
+        // Ctrl+Up/Down with several rows selected - move them as one block
+        if ((keyEvent->key() == Qt::Key_Up || keyEvent->key() == Qt::Key_Down) &&
+            (keyEvent->modifiers() & Qt::ControlModifier)) {
+            const QList<int> rows = selectedRows();
+            if (rows.size() > 1) {
+                if (keyEvent->key() == Qt::Key_Up && rows.first() > 0) {
+                    emit moveMultipleRequested(rows, rows.first() - 1);
+                } else if (keyEvent->key() == Qt::Key_Down && rows.last() < m_model->rowCount() - 1) {
+                    emit moveMultipleRequested(rows, rows.last() + 2 - rows.size());
                 }
+                return true;
             }
-            return true;
         }
 
         // Ctrl+Up - move track up
         if (keyEvent->key() == Qt::Key_Up &&
             (keyEvent->modifiers() & Qt::ControlModifier)) {
-            int row = m_trackTable->currentRow();
+            int row = m_trackTable->currentIndex().row();
             if (row > 0) {
-                emit moveRequested(row, row - 1);
-                m_trackTable->selectRow(row - 1);  // Follow selection
+                emit moveRequested(row, row - 1);  // Selection moves along with the row
             }
             return true;
         }
@@ -484,10 +391,9 @@ bool TrackListWidget::eventFilter(QObject* obj, QEvent* event)
         // Ctrl+Down - move track down
         if (keyEvent->key() == Qt::Key_Down &&
             (keyEvent->modifiers() & Qt::ControlModifier)) {
-            int row = m_trackTable->currentRow();
-            if (row >= 0 && row < m_trackTable->rowCount() - 1) {
-                emit moveRequested(row, row + 1);
-                m_trackTable->selectRow(row + 1);  // Follow selection
+            int row = m_trackTable->currentIndex().row();
+            if (row >= 0 && row < m_model->rowCount() - 1) {
+                emit moveRequested(row, row + 1);  // Selection moves along with the row
             }
             return true;
         }
@@ -495,15 +401,8 @@ bool TrackListWidget::eventFilter(QObject* obj, QEvent* event)
 
     // Clear row hover when mouse leaves the table viewport
     if (obj == m_trackTable->viewport() && event->type() == QEvent::Leave) {
-        if (m_hoveredRow >= 0 && m_hoveredRow < m_trackTable->rowCount()) {
-            bool isCurrent = (m_hoveredRow < m_tracks.size() && m_tracks[m_hoveredRow]->id() == m_currentTrackId);
-            for (int col = 0; col < m_trackTable->columnCount(); ++col) {
-                QTableWidgetItem* item = m_trackTable->item(m_hoveredRow, col);
-                if (item)
-                    item->setBackground(isCurrent ? QBrush(m_highlightColor) : Qt::transparent);
-            }
-        }
-        m_hoveredRow = -1;
+        m_model->setHoveredRow(-1);
+        m_preloader->cancel();
     }
 
     return QWidget::eventFilter(obj, event);
@@ -511,35 +410,26 @@ bool TrackListWidget::eventFilter(QObject* obj, QEvent* event)
 
 void TrackListWidget::contextMenuEvent(QContextMenuEvent* event)
 {
-    QTableWidgetItem* item = m_trackTable->itemAt(m_trackTable->viewport()->mapFrom(this, event->pos()));
-    if (!item)
+    QModelIndex index = m_trackTable->indexAt(m_trackTable->viewport()->mapFrom(this, event->pos()));
+    if (!index.isValid())
         return;
 
-    int clickedRow = item->row();
-    QList<int> selectedRows;
+    int clickedRow = index.row();
 
     // Collect all selected rows
-    for (QTableWidgetItem* selectedItem : m_trackTable->selectedItems()) {
-        int row = selectedItem->row();
-        if (!selectedRows.contains(row)) {
-            selectedRows.append(row);
-        }
-    }
+    QList<int> rows = selectedRows();
 
     // If clicked row not in selection, use only clicked row
-    if (!selectedRows.contains(clickedRow)) {
-        selectedRows.clear();
-        selectedRows.append(clickedRow);
+    if (!std::binary_search(rows.begin(), rows.end(), clickedRow)) {
+        rows = {clickedRow};
         m_trackTable->selectRow(clickedRow);
     }
 
-    std::sort(selectedRows.begin(), selectedRows.end());
-
     // Gather selected tracks
     QList<std::shared_ptr<Track>> selectedTracks;
-    for (int row : selectedRows) {
-        if (row >= 0 && row < m_tracks.size()) {
-            selectedTracks.append(m_tracks[row]);
+    for (int row : rows) {
+        if (auto track = m_model->trackAt(row)) {
+            selectedTracks.append(track);
         }
     }
     if (selectedTracks.isEmpty())
@@ -556,11 +446,11 @@ void TrackListWidget::contextMenuEvent(QContextMenuEvent* event)
         QAction* removeAction = contextMenu.addAction(
             QString("Remove %1 from Queue").arg(trackText)
         );
-        connect(removeAction, &QAction::triggered, [this, selectedRows]() {
-            if (selectedRows.size() == 1) {
-                emit removeRequested(selectedRows.first());
+        connect(removeAction, &QAction::triggered, [this, rows]() {
+            if (rows.size() == 1) {
+                emit removeRequested(rows.first());
             } else {
-                emit removeMultipleRequested(selectedRows);
+                emit removeMultipleRequested(rows);
             }
         });
     } else {
@@ -581,5 +471,5 @@ void TrackListWidget::contextMenuEvent(QContextMenuEvent* event)
     contextMenu.exec(event->globalPos());
 }
 
-// Include moc file for DraggableTableWidget
+// Include moc file for DraggableTableView
 #include "tracklistwidget.moc"
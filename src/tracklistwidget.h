@@ -2,13 +2,19 @@
 #define TRACKLISTWIDGET_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <memory>
 #include "track.h"
 #include "deezerapi.h"
+#include "tracklistmodel.h"
+#include "speculativepreloader.h"
 
+/**
+ * Track table for search results, playlists and the queue. Rows come from a
+ * TrackListModel, so even 10k-track lists cost only the rows on screen.
+ */
 class TrackListWidget : public QWidget
 {
     Q_OBJECT
@@ -30,7 +36,11 @@ public:
     void setHoverColor(const QColor& color);
     void setMode(Mode mode);
     void updateTrackScrobbleCount(int index);  // Update scrobble count for single track
-    const QList<std::shared_ptr<Track>>& tracks() const { return m_tracks; }
+    void refreshScrobbleCounts();  // After scrobble data was filled in for many tracks
+    // Queue mode: replay engine edits row by row. False when the rows no longer
+    // match the queue; the caller then reloads it with setTracks().
+    bool applyQueueChanges(const QueueChangeSet& changes);
+    const QList<std::shared_ptr<Track>>& tracks() const { return m_model->tracks(); }
     ~TrackListWidget();  // Need destructor to clean up network manager
 
 signals:
@@ -41,6 +51,7 @@ signals:
     void moveRequested(int fromIndex, int toIndex);
     void removeRequested(int index);
     void removeMultipleRequested(QList<int> indices);
+    void moveMultipleRequested(QList<int> indices, int toIndex);  // Block starts at toIndex
 
     // Library mode signals
     void addToQueueRequested(QList<std::shared_ptr<Track>> tracks);
@@ -49,6 +60,10 @@ signals:
     // Favorite signal
     void favoriteToggled(std::shared_ptr<Track> track, bool isFavorite);
 
+    // Speculative preloading: pointer rested on a row (or a single row was selected), and cancellation
+    void speculativePreloadRequested(std::shared_ptr<Track> track);
+    void speculativePreloadCancelled(std::shared_ptr<Track> track);
+
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
@@ -56,27 +71,24 @@ protected:
 private slots:
     void onSearchClicked();
     void onTracksFound(QList<std::shared_ptr<Track>> tracks, void* sender = nullptr);
-    void onTableDoubleClicked(int row, int column);
-    void onCellClicked(int row, int column);
+    void onTableDoubleClicked(const QModelIndex& index);
+    void onCellClicked(const QModelIndex& index);
     void onSelectionChanged();
-    void onCellEntered(int row, int column);
+    void onCellEntered(const QModelIndex& index);
 
 private:
     void setupUI();
     void populateTable();
+    QList<int> selectedRows() const;  // Sorted
     
     DeezerAPI* m_deezerAPI;  // Shared API for all operations
-    QList<std::shared_ptr<Track>> m_tracks;
-
     QLineEdit* m_searchEdit;
     QPushButton* m_searchButton;
-    QTableWidget* m_trackTable;
+    QTableView* m_trackTable;
+    TrackListModel* m_model;
+    SpeculativePreloader* m_preloader;  // Dwell timer, so sweeping across rows doesn't fire
 
     Mode m_mode = LibraryMode;
-    QColor m_highlightColor = QColor(60, 60, 100);
-    QColor m_hoverColor = QColor(50, 50, 70);
-    QString m_currentTrackId;
-    int m_hoveredRow = -1;
 };
 
 #endif // TRACKLISTWIDGET_H
@@ -0,0 +1,52 @@
+#include "visualizationwatcher.h"
+#include "audioengine.h"
+#include <QWidget>
+#include <QEvent>
+
+VisualizationWatcher::VisualizationWatcher(QWidget* window, int feeds, int fps)
+    : QObject(window)
+    , m_window(window)
+    , m_feeds(feeds)
+    , m_fps(fps)
+{
+    m_window->installEventFilter(this);
+}
+
+void VisualizationWatcher::setAudioEngine(AudioEngine* engine)
+{
+    if (m_audioEngine && m_audioEngine != engine)
+        m_audioEngine->unsubscribeVisualization(m_window);
+    m_audioEngine = engine;
+    updateSubscription();
+}
+
+bool VisualizationWatcher::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_window) {
+        switch (event->type()) {
+        case QEvent::Show:
+        case QEvent::WindowStateChange:
+            updateSubscription();
+            break;
+        case QEvent::Hide:
+            // Also spontaneous hides (the window is covered or on another desktop)
+            if (m_audioEngine)
+                m_audioEngine->unsubscribeVisualization(m_window);
+            break;
+        default:
+            break;
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void VisualizationWatcher::updateSubscription()
+{
+    if (!m_audioEngine)
+        return;
+
+    if (m_window->isVisible() && !m_window->isMinimized())
+        m_audioEngine->subscribeVisualization(m_window, m_feeds, m_fps);
+    else
+        m_audioEngine->unsubscribeVisualization(m_window);
+}
@@ -0,0 +1,35 @@
+#ifndef VISUALIZATIONWATCHER_H
+#define VISUALIZATIONWATCHER_H
+
+#include <QObject>
+
+class QWidget;
+class AudioEngine;
+
+/**
+ * Keeps a visualizer window subscribed to the engine's visualization feeds
+ * only while it can actually be seen: shown and not minimized. Watches the
+ * window's show/hide/state events, so the window itself needs no overrides.
+ */
+class VisualizationWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    VisualizationWatcher(QWidget* window, int feeds, int fps);
+
+    void setAudioEngine(AudioEngine* engine);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void updateSubscription();
+
+    QWidget* m_window;
+    AudioEngine* m_audioEngine = nullptr;
+    int m_feeds;
+    int m_fps;
+};
+
+#endif // VISUALIZATIONWATCHER_H
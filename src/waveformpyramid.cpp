@@ -0,0 +1,99 @@
+#include "waveformpyramid.h"
+#include <cmath>
+
+static float loudest(const QVector<float>& values)
+{
+    float peak = 0.0f;
+    for (float v : values)
+        peak = qMax(peak, v);
+    return peak;
+}
+
+WaveformPyramid::WaveformPyramid(const QVector<float>& envelope, const QVector<float>& minimum,
+                                 const QVector<float>& maximum)
+{
+    if (envelope.isEmpty() || minimum.size() != envelope.size() || maximum.size() != envelope.size())
+        return;
+
+    Level finestLevel;
+    finestLevel.envelope = envelope;
+    finestLevel.minimum = minimum;
+    finestLevel.maximum = maximum;
+    finestLevel.envelopePeak = loudest(envelope);
+    m_levels.append(finestLevel);
+
+    // Pairs of buckets cover the same number of samples, so their means average exactly
+    while (m_levels.last().size() > COARSEST_BUCKETS) {
+        const Level& below = m_levels.last();
+        const int size = (below.size() + 1) / 2;
+        Level level;
+        level.envelope.resize(size);
+        level.minimum.resize(size);
+        level.maximum.resize(size);
+        for (int i = 0; i < size; ++i) {
+            const int a = 2 * i;
+            const int b = qMin(a + 1, below.size() - 1);
+            level.envelope[i] = (below.envelope[a] + below.envelope[b]) * 0.5f;
+            level.minimum[i] = qMin(below.minimum[a], below.minimum[b]);
+            level.maximum[i] = qMax(below.maximum[a], below.maximum[b]);
+        }
+        level.envelopePeak = loudest(level.envelope);
+        m_levels.append(level);
+    }
+}
+
+WaveformPyramid WaveformPyramid::merged(const WaveformPyramid& other) const
+{
+    if (other.isEmpty() || (!isEmpty() && other.finest().size() != finest().size()))
+        return *this;
+    if (isEmpty())
+        return other;
+
+    Level combined = finest();
+    const Level& theirs = other.finest();
+    for (int i = 0; i < combined.size(); ++i) {
+        combined.envelope[i] = qMax(combined.envelope[i], theirs.envelope[i]);
+        combined.minimum[i] = qMin(combined.minimum[i], theirs.minimum[i]);
+        combined.maximum[i] = qMax(combined.maximum[i], theirs.maximum[i]);
+    }
+    return WaveformPyramid(combined.envelope, combined.minimum, combined.maximum);
+}
+
+const WaveformPyramid::Level& WaveformPyramid::levelFor(int buckets) const
+{
+    for (int i = m_levels.size() - 1; i > 0; --i) {
+        if (m_levels[i].size() >= buckets)
+            return m_levels[i];
+    }
+    return m_levels.first();
+}
+
+QVector<float> WaveformPyramid::columns(double start, double end, int columns, int detail) const
+{
+    QVector<float> heights;
+    if (isEmpty() || columns <= 0)
+        return heights;
+
+    start = qBound(0.0, start, 1.0);
+    end = qBound(start, end, 1.0);
+    const double span = end - start;
+    if (span <= 0.0)
+        return heights;
+
+    const Level& level = levelFor(static_cast<int>(std::ceil(columns * qMax(1, detail) / span)));
+    const int size = level.size();
+    const float scale = level.envelopePeak > 0.0f ? 1.0f / level.envelopePeak : 0.0f;
+
+    heights.resize(columns);
+    for (int i = 0; i < columns; ++i) {
+        const int first = qBound(0, static_cast<int>((start + span * i / columns) * size), size - 1);
+        const int last = qBound(first + 1, static_cast<int>(std::ceil((start + span * (i + 1) / columns) * size)), size);
+        float value = 0.0f;
+        for (int b = first; b < last; ++b)
+            value = qMax(value, level.envelope[b]);
+        // pow(x, 1.5) makes quiet parts smaller and loud parts stand out,
+        // avoiding the "blocky" look on compressed modern tracks
+        heights[i] = std::pow(value * scale, 1.5f);
+    }
+    return heights;
+}
@@ -0,0 +1,60 @@
+#ifndef WAVEFORMPYRAMID_H
+#define WAVEFORMPYRAMID_H
+
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * Waveform summary at several resolutions (mipmaps): level 0 holds
+ * FINEST_BUCKETS buckets over the whole track, each following level halves
+ * the bucket count down to COARSEST_BUCKETS. Buckets carry the mean |sample|
+ * and the sample extremes, so any level merges exactly from the one below
+ * and views can pick the detail they need without decoding again.
+ */
+class WaveformPyramid
+{
+public:
+    static constexpr int FINEST_BUCKETS = 4096;  // ~1 bucket per device pixel on a 4K-wide window
+    static constexpr int COARSEST_BUCKETS = 64;
+
+    struct Level {
+        QVector<float> envelope;  // Mean |sample| per bucket, linear
+        QVector<float> minimum;   // Lowest sample per bucket (-1..1)
+        QVector<float> maximum;   // Highest sample per bucket
+        float envelopePeak = 0.0f;  // Loudest bucket, for display normalisation
+
+        int size() const { return envelope.size(); }
+    };
+
+    WaveformPyramid() = default;
+
+    // Builds the coarser levels from the finest one (all three the same size)
+    WaveformPyramid(const QVector<float>& envelope, const QVector<float>& minimum,
+                    const QVector<float>& maximum);
+
+    // Combines two waveforms of disjoint (or overlapping) stretches of the same
+    // track, empty buckets being zero: loudest envelope and widest extremes win
+    WaveformPyramid merged(const WaveformPyramid& other) const;
+
+    bool isEmpty() const { return m_levels.isEmpty(); }
+    int levelCount() const { return m_levels.size(); }
+    const Level& level(int index) const { return m_levels[index]; }
+    const Level& finest() const { return m_levels.first(); }
+
+    // Coarsest level with at least `buckets` buckets over the whole track
+    // (the finest one if none has that many)
+    const Level& levelFor(int buckets) const;
+
+    // Display heights (0-1, normalised to the level's loudest bucket with a 1.5
+    // power curve) for `columns` columns over the [start, end) fraction of the
+    // track. Each column spans `detail` samples of the level it reads from,
+    // e.g. its width in device pixels; columns take the loudest bucket they cover.
+    QVector<float> columns(double start, double end, int columns, int detail = 1) const;
+
+private:
+    QVector<Level> m_levels;  // Finest first
+};
+
+Q_DECLARE_METATYPE(WaveformPyramid)
+
+#endif // WAVEFORMPYRAMID_H
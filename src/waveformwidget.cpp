@@ -2,11 +2,18 @@
 #include <QPainter>
 #include <QPalette>
 #include <QMouseEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <cmath>
 
 static constexpr int BAR_WIDTH = 3;
 static constexpr int BAR_GAP   = 1;
 static constexpr int BAR_STEP  = BAR_WIDTH + BAR_GAP;
 
+static constexpr double MAX_ZOOM   = 16.0;   // Narrowest view: 1/16 of the track
+static constexpr double ZOOM_STEP  = 1.25;   // Per wheel notch
+static constexpr double FOLLOW_LEAD = 0.1;   // Playhead position in a view that jumped to it
+
 // Deezer-themed palette
 static const QColor COLOR_PLAYED(162, 56, 255);        // #A238FF  Deezer purple
 static const QColor DEFAULT_UNPLAYED(140, 140, 140);   // medium gray
@@ -15,12 +22,15 @@ static const QColor COLOR_HOVER(255, 255, 255, 100);
 
 WaveformWidget::WaveformWidget(QWidget *parent)
     : QWidget(parent)
+    , m_viewStart(0.0)
+    , m_viewEnd(1.0)
     , m_position(0.0)
     , m_dragPosition(0.0)
     , m_dragging(false)
     , m_hovering(false)
     , m_hoverPosition(0.0)
     , m_unplayedColor(DEFAULT_UNPLAYED)
+    , m_layersValid(false)
 {
     setMouseTracking(true);
     setCursor(Qt::PointingHandCursor);
@@ -30,32 +40,54 @@ WaveformWidget::WaveformWidget(QWidget *parent)
 
 // ── public setters ──────────────────────────────────────────────────
 
-void WaveformWidget::setPeaks(const QVector<float>& peaks)
+void WaveformWidget::setWaveform(const WaveformPyramid& waveform)
 {
-    m_peaks = peaks;
-    update();
+    m_waveform = waveform;
+    invalidateLayers();
 }
 
 void WaveformWidget::setPosition(double position)
 {
     if (!m_dragging) {
-        m_position = qBound(0.0, position, 1.0);
-        update();
+        const double clamped = qBound(0.0, position, 1.0);
+        // Called at display rate: only repaint when the playhead moves a pixel
+        const bool moved = xFromPosition(clamped) != xFromPosition(m_position);
+        const double previous = m_position;
+        m_position = clamped;
+
+        // A zoomed view pages along with playback
+        const double span = m_viewEnd - m_viewStart;
+        if (span < 1.0 && (clamped < m_viewStart || clamped >= m_viewEnd)) {
+            const double start = qBound(0.0, clamped - span * FOLLOW_LEAD, 1.0 - span);
+            setVisibleRange(start, start + span);
+        } else if (moved) {
+            updateBetween(previous, clamped);
+        }
     }
 }
 
 void WaveformWidget::setUnplayedColor(const QColor& color)
 {
     m_unplayedColor = color.isValid() ? color : DEFAULT_UNPLAYED;
-    update();
+    invalidateLayers();
+}
+
+void WaveformWidget::setVisibleRange(double start, double end)
+{
+    const double span = qBound(1.0 / MAX_ZOOM, end - start, 1.0);
+    m_viewStart = qBound(0.0, start, 1.0 - span);
+    m_viewEnd = m_viewStart + span;
+    invalidateLayers();
 }
 
 void WaveformWidget::clear()
 {
-    m_peaks.clear();
+    m_waveform = WaveformPyramid();
+    m_viewStart = 0.0;
+    m_viewEnd = 1.0;
     m_position = 0.0;
     m_dragging = false;
-    update();
+    invalidateLayers();
 }
 
 // ── size hints ──────────────────────────────────────────────────────
@@ -67,69 +99,111 @@ QSize WaveformWidget::sizeHint()        const { return QSize(400, 64); }
 
 double WaveformWidget::positionFromX(int x) const
 {
-    return qBound(0.0, static_cast<double>(x) / width(), 1.0);
+    const double fraction = qBound(0.0, static_cast<double>(x) / width(), 1.0);
+    return m_viewStart + fraction * (m_viewEnd - m_viewStart);
 }
 
-// ── painting ────────────────────────────────────────────────────────
+int WaveformWidget::xFromPosition(double position) const
+{
+    return static_cast<int>((position - m_viewStart) / (m_viewEnd - m_viewStart) * width());
+}
 
-void WaveformWidget::paintEvent(QPaintEvent *)
+void WaveformWidget::updateBetween(double from, double to)
 {
-    QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing, false);
+    // Both layers change at the playhead; its 2 px line and bar edges need a margin
+    const int x1 = qMin(xFromPosition(from), xFromPosition(to));
+    const int x2 = qMax(xFromPosition(from), xFromPosition(to));
+    update(QRect(x1 - BAR_STEP, 0, x2 - x1 + 2 * BAR_STEP, height()));
+}
+
+void WaveformWidget::invalidateLayers()
+{
+    m_layersValid = false;
+    update();
+}
+
+void WaveformWidget::renderLayers()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixels = size() * dpr;
+    m_layersValid = true;
+
+    if (m_playedLayer.size() != pixels) {
+        m_playedLayer = QPixmap(pixels);
+        m_unplayedLayer = QPixmap(pixels);
+    }
+    m_playedLayer.setDevicePixelRatio(dpr);
+    m_unplayedLayer.setDevicePixelRatio(dpr);
+    m_playedLayer.fill(Qt::transparent);
+    m_unplayedLayer.fill(Qt::transparent);
 
     const int w  = width();
-    const int h  = height();
-    const int cy = h / 2;              // vertical centre
+    const int cy = height() / 2;       // vertical centre
     const int maxHalf = cy - 2;        // max bar half-height (2 px padding)
+    const int barH = 4;
 
-    // Background - transparent to blend with rest of UI
-    p.fillRect(rect(), Qt::transparent);
+    QPainter played(&m_playedLayer);
+    QPainter unplayed(&m_unplayedLayer);
 
-    const double displayPos = m_dragging ? m_dragPosition : m_position;
-
-    if (m_peaks.isEmpty()) {
-        // ── no waveform yet: draw a thin progress bar ───────────
-        const int barH = 4;
-        if (displayPos > 0.0) {
-            int px = static_cast<int>(displayPos * w);
-            p.fillRect(0,  cy - barH / 2, px,     barH, COLOR_PLAYED);
-            p.fillRect(px, cy - barH / 2, w - px, barH, m_unplayedColor);
-        } else {
-            p.fillRect(0, cy - barH / 2, w, barH, m_unplayedColor);
-        }
-    } else {
-        // ── draw waveform bars ──────────────────────────────────
-        const int numBars   = qMax(1, w / BAR_STEP);
-        const int playedBar = static_cast<int>(displayPos * numBars);
+    if (m_waveform.isEmpty()) {
+        // ── no waveform yet: a thin progress bar ────────────────
+        played.fillRect(0, cy - barH / 2, w, barH, COLOR_PLAYED);
+        unplayed.fillRect(0, cy - barH / 2, w, barH, m_unplayedColor);
+        return;
+    }
 
-        for (int i = 0; i < numBars; ++i) {
-            // Map visible bar → peak index
-            const float fIdx = static_cast<float>(i) * m_peaks.size() / numBars;
-            const int   idx  = qBound(0, static_cast<int>(fIdx), m_peaks.size() - 1);
+    const int numBars = qMax(1, w / BAR_STEP);
 
-            float peak = m_peaks[idx];
-            peak = qMax(peak, 0.03f);                       // minimum visible height
+    // Each bar summarises every bucket under its device pixels
+    const int detail = qMax(1, static_cast<int>(std::ceil(BAR_STEP * dpr)));
+    const QVector<float> heights = m_waveform.columns(m_viewStart, m_viewEnd, numBars, detail);
 
-            const int halfH = qMax(1, static_cast<int>(peak * maxHalf));
-            const int x     = i * BAR_STEP;
-            const bool played = (i <= playedBar);
-            const QColor color = played ? COLOR_PLAYED : m_unplayedColor;
+    for (int i = 0; i < heights.size(); ++i) {
+        const float peak = qMax(heights[i], 0.03f);         // minimum visible height
+        const int halfH = qMax(1, static_cast<int>(peak * maxHalf));
+        const int x     = i * BAR_STEP;
 
-            // Symmetric bar around centre line
-            p.fillRect(x, cy - halfH, BAR_WIDTH, halfH * 2, color);
-        }
+        // Symmetric bar around centre line
+        played.fillRect(x, cy - halfH, BAR_WIDTH, halfH * 2, COLOR_PLAYED);
+        unplayed.fillRect(x, cy - halfH, BAR_WIDTH, halfH * 2, m_unplayedColor);
     }
+}
+
+// ── painting ────────────────────────────────────────────────────────
+
+void WaveformWidget::paintEvent(QPaintEvent *)
+{
+    // Device pixel ratio changes when the window moves to another screen
+    if (!m_layersValid || m_playedLayer.devicePixelRatio() != devicePixelRatioF())
+        renderLayers();
+
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing, false);
+
+    const int w  = width();
+    const int h  = height();
+
+    const double displayPos = m_dragging ? m_dragPosition : m_position;
+
+    // ── bars: played layer left of the playhead, unplayed right ─
+    const int split = qBound(0, xFromPosition(displayPos), w);
+    const qreal dpr = m_playedLayer.devicePixelRatio();
+    if (split > 0)
+        p.drawPixmap(QRectF(0, 0, split, h), m_playedLayer, QRectF(0, 0, split * dpr, h * dpr));
+    if (split < w)
+        p.drawPixmap(QRectF(split, 0, w - split, h), m_unplayedLayer,
+                     QRectF(split * dpr, 0, (w - split) * dpr, h * dpr));
 
     // ── playhead line ───────────────────────────────────────────
-    {
-        const int px = static_cast<int>(displayPos * w);
+    if (displayPos >= m_viewStart && displayPos <= m_viewEnd) {
+        const int px = xFromPosition(displayPos);
         p.setPen(QPen(COLOR_PLAYHEAD, 2));
         p.drawLine(px, 0, px, h);
     }
 
     // ── hover indicator ─────────────────────────────────────────
     if (m_hovering && !m_dragging) {
-        const int hx = static_cast<int>(m_hoverPosition * w);
+        const int hx = xFromPosition(m_hoverPosition);
         p.setPen(QPen(COLOR_HOVER, 1));
         p.drawLine(hx, 0, hx, h);
     }
@@ -148,12 +222,14 @@ void WaveformWidget::mousePressEvent(QMouseEvent *event)
 
 void WaveformWidget::mouseMoveEvent(QMouseEvent *event)
 {
+    const double position = positionFromX(event->pos().x());
     if (m_dragging) {
-        m_dragPosition = positionFromX(event->pos().x());
+        updateBetween(m_dragPosition, position);
+        m_dragPosition = position;
     } else {
-        m_hoverPosition = positionFromX(event->pos().x());
+        updateBetween(m_hoverPosition, position);
+        m_hoverPosition = position;
     }
-    update();
 }
 
 void WaveformWidget::mouseReleaseEvent(QMouseEvent *event)
@@ -177,3 +253,26 @@ void WaveformWidget::leaveEvent(QEvent *)
     m_hovering = false;
     update();
 }
+
+void WaveformWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_layersValid = false;
+}
+
+void WaveformWidget::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    if (m_waveform.isEmpty() || delta == 0) {
+        event->ignore();
+        return;
+    }
+
+    // Zoom around the track position under the cursor
+    const double anchor = positionFromX(static_cast<int>(event->position().x()));
+    const double fraction = event->position().x() / qMax(1, width());
+    const double span = (m_viewEnd - m_viewStart) * std::pow(ZOOM_STEP, -delta / 120.0);
+    const double clampedSpan = qBound(1.0 / MAX_ZOOM, span, 1.0);
+    setVisibleRange(anchor - fraction * clampedSpan, anchor - fraction * clampedSpan + clampedSpan);
+    event->accept();
+}
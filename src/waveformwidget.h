@@ -4,7 +4,16 @@
 #include <QWidget>
 #include <QVector>
 #include <QColor>
+#include <QPixmap>
+#include "waveformpyramid.h"
 
+/**
+ * Seek bar drawn as waveform bars. Bars read the pyramid level matching their
+ * width in device pixels; the wheel zooms around the cursor (finer levels,
+ * no decode) and a zoomed view follows the playhead. The bars are rendered
+ * once into a played and an unplayed layer, so a playhead frame is two
+ * clipped blits and a line whatever the number of bars.
+ */
 class WaveformWidget : public QWidget
 {
     Q_OBJECT
@@ -12,9 +21,10 @@ class WaveformWidget : public QWidget
 public:
     explicit WaveformWidget(QWidget *parent = nullptr);
 
-    void setPeaks(const QVector<float>& peaks);
+    void setWaveform(const WaveformPyramid& waveform);
     void setPosition(double position); // 0.0 to 1.0
     void setUnplayedColor(const QColor& color);
+    void setVisibleRange(double start, double end);  // Fractions of the track, 0-1 = whole track
     void clear();
     bool isDragging() const { return m_dragging; }
 
@@ -31,17 +41,31 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void enterEvent(QEnterEvent *event) override;
     void leaveEvent(QEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
     double positionFromX(int x) const;
+    int xFromPosition(double position) const;
+    void updateBetween(double from, double to);  // Repaint the strip between two positions
+    void invalidateLayers();
+    void renderLayers();
 
-    QVector<float> m_peaks;
+    WaveformPyramid m_waveform;
+    double m_viewStart;      // visible range of the track, 0.0-1.0
+    double m_viewEnd;
     double m_position;       // current playback position 0.0-1.0
     double m_dragPosition;   // position while dragging
     bool m_dragging;
     bool m_hovering;
     double m_hoverPosition;  // mouse hover position 0.0-1.0
     QColor m_unplayedColor;  // overridable unplayed bar color
+
+    // Bars pre-rendered at device resolution; rebuilt when the waveform, view,
+    // size, DPR or colors change
+    QPixmap m_playedLayer;
+    QPixmap m_unplayedLayer;
+    bool m_layersValid;
 };
 
 #endif // WAVEFORMWIDGET_H